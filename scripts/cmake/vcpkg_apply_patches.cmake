@@ -34,6 +34,11 @@
 function(vcpkg_apply_patches)
     cmake_parse_arguments(_ap "QUIET" "SOURCE_PATH" "PATCHES" ${ARGN})
 
+    if(VCPKG_DOWNLOAD_MODE)
+        # There are no extracted sources to patch in download mode
+        return()
+    endif()
+
     find_program(GIT NAMES git git.cmd)
     set(PATCHNUM 0)
     foreach(PATCH ${_ap_PATCHES})
@@ -16,6 +16,9 @@
 ## be passed.
 ##
 ## ## Notes:
+## When vcpkg builds several ports at once under `--x-max-cpus`, it sets the `VCPKG_CONCURRENCY` environment variable
+## to each build's share of the CPUs, and Ninja and MSBuild builds run that many jobs.
+##
 ## This command should be preceeded by a call to [`vcpkg_configure_cmake()`](vcpkg_configure_cmake.md).
 ## You can use the alias [`vcpkg_install_cmake()`](vcpkg_configure_cmake.md) function if your CMake script supports the
 ## "install" target
@@ -29,6 +32,10 @@
 function(vcpkg_build_cmake)
     cmake_parse_arguments(_bc "DISABLE_PARALLEL" "TARGET;LOGFILE_ROOT" "" ${ARGN})
 
+    if(VCPKG_DOWNLOAD_MODE)
+        message(FATAL_ERROR "This command cannot be executed in download mode.\nHalting portfile execution.\n")
+    endif()
+
     if(NOT _bc_LOGFILE_ROOT)
         set(_bc_LOGFILE_ROOT "build")
     endif()
@@ -36,15 +43,23 @@ function(vcpkg_build_cmake)
     set(PARALLEL_ARG)
     set(NO_PARALLEL_ARG)
 
+    # Set by vcpkg when concurrent builds share a CPU budget, since ninja and msbuild do not take make jobserver tokens
     if(_VCPKG_CMAKE_GENERATOR MATCHES "Ninja")
         set(BUILD_ARGS "-v") # verbose output
         set(NO_PARALLEL_ARG "-j1")
+        if(DEFINED ENV{VCPKG_CONCURRENCY})
+            set(PARALLEL_ARG "-j$ENV{VCPKG_CONCURRENCY}")
+        endif()
     elseif(_VCPKG_CMAKE_GENERATOR MATCHES "Visual Studio")
         set(BUILD_ARGS
             "/p:VCPkgLocalAppDataDisabled=true"
             "/p:UseIntelMKL=No"
         )
-        set(PARALLEL_ARG "/m")
+        if(DEFINED ENV{VCPKG_CONCURRENCY})
+            set(PARALLEL_ARG "/m:$ENV{VCPKG_CONCURRENCY}")
+        else()
+            set(PARALLEL_ARG "/m")
+        endif()
     elseif(_VCPKG_CMAKE_GENERATOR MATCHES "NMake")
         # No options are currently added for nmake builds
     else()
@@ -47,29 +47,40 @@ function(vcpkg_download_distfile VAR)
     set(multipleValuesArgs URLS)
     cmake_parse_arguments(vcpkg_download_distfile "${options}" "${oneValueArgs}" "${multipleValuesArgs}" ${ARGN})
 
+    # In download mode the portfile always stops with an error at its first build step, so vcpkg tells a failed
+    # download apart by this file
+    macro(download_failed)
+        if(VCPKG_DOWNLOAD_MODE)
+            file(WRITE "${VCPKG_DOWNLOAD_FAILURE_FILE}" "${vcpkg_download_distfile_FILENAME}\n")
+        endif()
+        message(FATAL_ERROR ${ARGN})
+    endmacro()
+
     if(NOT DEFINED vcpkg_download_distfile_URLS)
-        message(FATAL_ERROR "vcpkg_download_distfile requires a URLS argument.")
+        download_failed("vcpkg_download_distfile requires a URLS argument.")
     endif()
     if(NOT DEFINED vcpkg_download_distfile_FILENAME)
-        message(FATAL_ERROR "vcpkg_download_distfile requires a FILENAME argument.")
+        download_failed("vcpkg_download_distfile requires a FILENAME argument.")
     endif()
     if(NOT _VCPKG_INTERNAL_NO_HASH_CHECK)
         if(vcpkg_download_distfile_SKIP_SHA512 AND NOT VCPKG_USE_HEAD_VERSION)
-            message(FATAL_ERROR "vcpkg_download_distfile only allows SKIP_SHA512 when building with --head")
+            download_failed("vcpkg_download_distfile only allows SKIP_SHA512 when building with --head")
         endif()
         if(NOT vcpkg_download_distfile_SKIP_SHA512 AND NOT DEFINED vcpkg_download_distfile_SHA512)
-            message(FATAL_ERROR "vcpkg_download_distfile requires a SHA512 argument. If you do not know the SHA512, add it as 'SHA512 0' and re-run this command.")
+            download_failed("vcpkg_download_distfile requires a SHA512 argument. If you do not know the SHA512, add it as 'SHA512 0' and re-run this command.")
         endif()
         if(vcpkg_download_distfile_SKIP_SHA512 AND DEFINED vcpkg_download_distfile_SHA512)
-            message(FATAL_ERROR "vcpkg_download_distfile must not be passed both SHA512 and SKIP_SHA512.")
+            download_failed("vcpkg_download_distfile must not be passed both SHA512 and SKIP_SHA512.")
         endif()
     endif()
 
     set(downloaded_file_path ${DOWNLOADS}/${vcpkg_download_distfile_FILENAME})
-    set(download_file_path_part "${DOWNLOADS}/temp/${vcpkg_download_distfile_FILENAME}")
+    # Every port and triplet stages its partial downloads separately, since vcpkg runs portfiles concurrently
+    set(download_temp_dir "${DOWNLOADS}/temp/${PORT}-${TARGET_TRIPLET}")
+    set(download_file_path_part "${download_temp_dir}/${vcpkg_download_distfile_FILENAME}")
 
-    file(REMOVE_RECURSE "${DOWNLOADS}/temp")
-    file(MAKE_DIRECTORY "${DOWNLOADS}/temp")
+    file(REMOVE_RECURSE "${download_temp_dir}")
+    file(MAKE_DIRECTORY "${download_temp_dir}")
 
     function(test_hash FILE_KIND CUSTOM_ERROR_ADVICE)
         if(_VCPKG_INTERNAL_NO_HASH_CHECK)
@@ -84,7 +95,7 @@ function(vcpkg_download_distfile VAR)
         message(STATUS "Testing integrity of ${FILE_KIND}...")
         file(SHA512 ${downloaded_file_path} FILE_HASH)
         if(NOT "${FILE_HASH}" STREQUAL "${vcpkg_download_distfile_SHA512}")
-            message(FATAL_ERROR
+            download_failed(
                 "\nFile does not have expected hash:\n"
                 "        File path: [ ${downloaded_file_path} ]\n"
                 "    Expected hash: [ ${vcpkg_download_distfile_SHA512} ]\n"
@@ -96,10 +107,13 @@ function(vcpkg_download_distfile VAR)
 
     if(EXISTS ${downloaded_file_path})
         message(STATUS "Using cached ${downloaded_file_path}")
-        test_hash("cached file" "Please delete the file and retry if this file should be downloaded again.")
+        # Callers that pass the hash on to vcpkg_extract_source_archive_ex have it checked while extracting
+        if(NOT _VCPKG_INTERNAL_HASH_CHECKED_ON_EXTRACT)
+            test_hash("cached file" "Please delete the file and retry if this file should be downloaded again.")
+        endif()
     else()
         if(_VCPKG_NO_DOWNLOADS)
-            message(FATAL_ERROR "Downloads are disabled, but '${downloaded_file_path}' does not exist.")
+            download_failed("Downloads are disabled, but '${downloaded_file_path}' does not exist.")
         endif()
 
         # Tries to download the file.
@@ -119,7 +133,7 @@ function(vcpkg_download_distfile VAR)
         endforeach(url)
 
         if (NOT download_success)
-            message(FATAL_ERROR
+            download_failed(
             "\n"
             "    Failed to download file.\n"
             "    Add mirrors or submit an issue at https://github.com/Microsoft/vcpkg/issues\n")
@@ -127,5 +141,6 @@ function(vcpkg_download_distfile VAR)
             test_hash("downloaded file" "The file may have been corrupted in transit.")
         endif()
     endif()
+    file(REMOVE_RECURSE "${download_temp_dir}")
     set(${VAR} ${downloaded_file_path} PARENT_SCOPE)
 endfunction()
@@ -1,6 +1,9 @@
 # Usage: vcpkg_execute_required_process_repeat(COUNT <num> COMMAND <cmd> [<args>...] WORKING_DIRECTORY </path/to/dir> LOGNAME <my_log_name>)
 function(vcpkg_execute_required_process_repeat)
     cmake_parse_arguments(vcpkg_execute_required_process_repeat "" "COUNT;WORKING_DIRECTORY;LOGNAME" "COMMAND" ${ARGN})
+    if(VCPKG_DOWNLOAD_MODE)
+        message(FATAL_ERROR "This command cannot be executed in download mode.\nHalting portfile execution.\n")
+    endif()
     #debug_message("vcpkg_execute_required_process_repeat(${vcpkg_execute_required_process_repeat_COMMAND})")
     set(SUCCESSFUL_EXECUTION FALSE)
     foreach(loop_count RANGE ${vcpkg_execute_required_process_repeat_COUNT})
@@ -22,6 +22,8 @@
 ## ## Notes
 ## This command will also create a tracking file named <FILENAME>.extracted in the TARGET_DIRECTORY. This file, when present, will suppress the extraction of the archive.
 ##
+## When run by vcpkg, the archive is extracted by `vcpkg x-extract`, which decodes .tar, .tar.gz and .zip files natively and writes the files in parallel. Other formats are passed on to `cmake -E tar`.
+##
 ## ## Examples
 ##
 ## * [libraw](https://github.com/Microsoft/vcpkg/blob/master/ports/libraw/portfile.cmake)
@@ -30,12 +32,17 @@
 include(vcpkg_execute_required_process)
 
 function(vcpkg_extract_source_archive_ex)
-    cmake_parse_arguments(_vesae "" "ARCHIVE;WORKING_DIRECTORY" "" ${ARGN})
+    cmake_parse_arguments(_vesae "" "ARCHIVE;WORKING_DIRECTORY;SHA512" "" ${ARGN})
 
     if(NOT _vesae_ARCHIVE)
         message(FATAL_ERROR "Must specify ARCHIVE parameter to vcpkg_extract_source_archive_ex()")
     endif()
 
+    if(VCPKG_DOWNLOAD_MODE)
+        # Only the archive is wanted in download mode; the build extracts it
+        return()
+    endif()
+
     if(DEFINED _vesae_WORKING_DIRECTORY)
         set(WORKING_DIRECTORY ${_vesae_WORKING_DIRECTORY})
     else()
@@ -46,11 +53,40 @@ function(vcpkg_extract_source_archive_ex)
     if(NOT EXISTS ${WORKING_DIRECTORY}/${ARCHIVE_FILENAME}.extracted)
         message(STATUS "Extracting source ${_vesae_ARCHIVE}")
         file(MAKE_DIRECTORY ${WORKING_DIRECTORY})
-        vcpkg_execute_required_process(
-            COMMAND ${CMAKE_COMMAND} -E tar xjf ${_vesae_ARCHIVE}
-            WORKING_DIRECTORY ${WORKING_DIRECTORY}
-            LOGNAME extract
-        )
+        if(DEFINED VCPKG_EXECUTABLE)
+            # vcpkg checks the SHA512 while it reads the archive, and leaves nothing behind if it does not match
+            set(_vesae_options --no-sendmetrics)
+            if(DEFINED _vesae_SHA512)
+                list(APPEND _vesae_options "--sha512=${_vesae_SHA512}")
+            endif()
+            execute_process(
+                COMMAND ${VCPKG_EXECUTABLE} x-extract ${_vesae_ARCHIVE} ${WORKING_DIRECTORY} ${_vesae_options}
+                WORKING_DIRECTORY ${WORKING_DIRECTORY}
+                OUTPUT_VARIABLE _vesae_output
+                ERROR_VARIABLE _vesae_output
+                RESULT_VARIABLE _vesae_error_code
+            )
+            if(_vesae_error_code)
+                message(FATAL_ERROR "Failed to extract ${_vesae_ARCHIVE}:\n${_vesae_output}")
+            endif()
+        else()
+            if(DEFINED _vesae_SHA512)
+                file(SHA512 ${_vesae_ARCHIVE} _vesae_actual_hash)
+                if(NOT "${_vesae_actual_hash}" STREQUAL "${_vesae_SHA512}")
+                    message(FATAL_ERROR
+                        "\nFile does not have expected hash:\n"
+                        "        File path: [ ${_vesae_ARCHIVE} ]\n"
+                        "    Expected hash: [ ${_vesae_SHA512} ]\n"
+                        "      Actual hash: [ ${_vesae_actual_hash} ]\n"
+                        "Please delete the file and retry if this file should be downloaded again.\n")
+                endif()
+            endif()
+            vcpkg_execute_required_process(
+                COMMAND ${CMAKE_COMMAND} -E tar xjf ${_vesae_ARCHIVE}
+                WORKING_DIRECTORY ${WORKING_DIRECTORY}
+                LOGNAME extract
+            )
+        endif()
         file(WRITE ${WORKING_DIRECTORY}/${ARCHIVE_FILENAME}.extracted)
     endif()
     message(STATUS "Extracting done")
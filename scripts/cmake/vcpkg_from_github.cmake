@@ -75,7 +75,8 @@ function(vcpkg_from_github)
 
     macro(set_SOURCE_PATH BASE BASEREF)
         set(SOURCE_PATH "${BASE}/${REPO_NAME}-${BASEREF}")
-        if(EXISTS ${SOURCE_PATH})
+        # Nothing is extracted in download mode
+        if(EXISTS ${SOURCE_PATH} OR VCPKG_DOWNLOAD_MODE)
             set(${_vdud_OUT_SOURCE_PATH} "${SOURCE_PATH}" PARENT_SCOPE)
         else()
             # Sometimes GitHub strips a leading 'v' off the REF.
@@ -103,12 +104,16 @@ function(vcpkg_from_github)
 
         string(REPLACE "/" "-" SANITIZED_REF "${_vdud_REF}")
 
+        # A cached archive is only read once, by the extraction, which also checks its hash
+        if(DEFINED VCPKG_EXECUTABLE AND NOT VCPKG_DOWNLOAD_MODE)
+            set(_VCPKG_INTERNAL_HASH_CHECKED_ON_EXTRACT ON)
+        endif()
         vcpkg_download_distfile(ARCHIVE
             URLS "https://github.com/${ORG_NAME}/${REPO_NAME}/archive/${_vdud_REF}.tar.gz"
             SHA512 "${_vdud_SHA512}"
             FILENAME "${ORG_NAME}-${REPO_NAME}-${SANITIZED_REF}.tar.gz"
         )
-        vcpkg_extract_source_archive_ex(ARCHIVE "${ARCHIVE}")
+        vcpkg_extract_source_archive_ex(ARCHIVE "${ARCHIVE}" SHA512 "${_vdud_SHA512}")
         set_SOURCE_PATH(${CURRENT_BUILDTREES_DIR}/src ${SANITIZED_REF})
         return()
     endif()
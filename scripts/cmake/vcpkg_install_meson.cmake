@@ -4,9 +4,15 @@ function(vcpkg_install_meson)
 
     unset(ENV{DESTDIR}) # installation directory was already specified with '--prefix' option
 
+    # Set by vcpkg when concurrent builds share a CPU budget, since ninja does not take make jobserver tokens
+    set(PARALLEL_ARG)
+    if(DEFINED ENV{VCPKG_CONCURRENCY})
+        set(PARALLEL_ARG "-j$ENV{VCPKG_CONCURRENCY}")
+    endif()
+
     message(STATUS "Package ${TARGET_TRIPLET}-rel")
     vcpkg_execute_required_process(
-        COMMAND ${NINJA} install -v
+        COMMAND ${NINJA} install -v ${PARALLEL_ARG}
         WORKING_DIRECTORY ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel
         LOGNAME package-${TARGET_TRIPLET}-rel
     )
@@ -14,7 +20,7 @@ function(vcpkg_install_meson)
 
     message(STATUS "Package ${TARGET_TRIPLET}-dbg")
     vcpkg_execute_required_process(
-        COMMAND ${NINJA} install -v
+        COMMAND ${NINJA} install -v ${PARALLEL_ARG}
         WORKING_DIRECTORY ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg
         LOGNAME package-${TARGET_TRIPLET}-dbg
     )
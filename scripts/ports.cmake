@@ -61,15 +61,23 @@ if(CMD MATCHES "^BUILD$")
     unset(PACKAGES_DIR)
     unset(BUILDTREES_DIR)
 
-    file(REMOVE_RECURSE ${CURRENT_PACKAGES_DIR})
-    if(EXISTS ${CURRENT_PACKAGES_DIR})
-        message(FATAL_ERROR "Unable to remove directory: ${CURRENT_PACKAGES_DIR}\n  Files are likely in use.")
+    if(VCPKG_DOWNLOAD_MODE)
+        # Download mode only fetches sources and leaves the package directory to the build
+        file(MAKE_DIRECTORY ${CURRENT_BUILDTREES_DIR})
+    else()
+        file(REMOVE_RECURSE ${CURRENT_PACKAGES_DIR})
+        if(EXISTS ${CURRENT_PACKAGES_DIR})
+            message(FATAL_ERROR "Unable to remove directory: ${CURRENT_PACKAGES_DIR}\n  Files are likely in use.")
+        endif()
+        file(MAKE_DIRECTORY ${CURRENT_BUILDTREES_DIR} ${CURRENT_PACKAGES_DIR})
     endif()
-    file(MAKE_DIRECTORY ${CURRENT_BUILDTREES_DIR} ${CURRENT_PACKAGES_DIR})
 
     include(${CMAKE_TRIPLET_FILE})
     set(TRIPLET_SYSTEM_ARCH ${VCPKG_TARGET_ARCHITECTURE})
     include(${CURRENT_PORT_DIR}/portfile.cmake)
+    if(VCPKG_DOWNLOAD_MODE)
+        return()
+    endif()
 
     set(BUILD_INFO_FILE_PATH ${CURRENT_PACKAGES_DIR}/BUILD_INFO)
     file(WRITE  ${BUILD_INFO_FILE_PATH} "CRTLinkage: ${VCPKG_CRT_LINKAGE}\n")
@@ -24,6 +24,7 @@
 #include <cctype>
 #include <chrono>
 #include <codecvt>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstddef>
 #include <cstdint>
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+
+#include <string>
+
+namespace vcpkg::Archives
+{
+    enum class ArchiveFormat
+    {
+        TAR,
+        GZIP_TAR,
+        ZIP,
+        OTHER,
+    };
+
+    /// <summary>
+    /// Identifies an archive from its leading bytes. OTHER covers everything that cannot be extracted natively,
+    /// such as .tar.bz2, .tar.xz and .7z.
+    /// </summary>
+    ArchiveFormat detect_format(const char* data, size_t size);
+
+    /// <summary>
+    /// Extracts an archive into an existing directory, adding every byte of the archive to the hasher (if any) in the
+    /// same pass. Returns false without writing anything if the archive uses features that can only be handled by
+    /// an external tool, such as an encrypted zip entry. Exits if the archive is corrupt.
+    /// </summary>
+    bool extract(Files::Filesystem& fs,
+                 const Files::MappedFile& archive,
+                 ArchiveFormat format,
+                 const fs::path& destination,
+                 Hash::Hasher* hasher,
+                 const std::string& label);
+}
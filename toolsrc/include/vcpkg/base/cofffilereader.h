@@ -3,6 +3,7 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/machinetype.h>
 
+#include <string>
 #include <vector>
 
 namespace vcpkg::CoffFileReader
@@ -10,6 +11,18 @@ namespace vcpkg::CoffFileReader
     struct DllInfo
     {
         MachineType machine_type;
+        /// <summary>
+        /// IMAGE_DLLCHARACTERISTICS_APPCONTAINER, which Windows Store apps require
+        /// </summary>
+        bool is_app_container;
+        /// <summary>
+        /// True if the export table lists at least one function
+        /// </summary>
+        bool has_exports;
+        /// <summary>
+        /// The DLLs named by the import and delay-load import tables, in the order `dumpbin /dependents` lists them
+        /// </summary>
+        std::vector<std::string> dependencies;
     };
 
     struct LibInfo
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/optional.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vcpkg::ElfFileReader
+{
+    enum class ElfMachine : uint16_t
+    {
+        NONE = 0,      // No machine
+        I386 = 3,      // Intel 80386
+        MIPS = 8,      // MIPS
+        PPC = 20,      // PowerPC
+        PPC64 = 21,    // 64-bit PowerPC
+        S390 = 22,     // IBM S/390
+        ARM = 40,      // ARM 32-bit
+        X86_64 = 62,   // AMD x86-64
+        AARCH64 = 183, // ARM 64-bit
+        RISCV = 243,   // RISC-V
+    };
+
+    enum class ElfClass
+    {
+        ELF32,
+        ELF64,
+    };
+
+    enum class ElfType
+    {
+        RELOCATABLE,
+        EXECUTABLE,
+        SHARED_OBJECT,
+        OTHER,
+    };
+
+    struct ElfInfo
+    {
+        ElfMachine machine;
+        ElfClass elf_class;
+        ElfType type;
+        /// <summary>
+        /// DT_SONAME of a shared object. Empty if there is none.
+        /// </summary>
+        std::string soname;
+        /// <summary>
+        /// True if the file has DWARF sections such as .debug_info, i.e. it was not stripped
+        /// </summary>
+        bool has_debug_info;
+    };
+
+    struct ArchiveInfo
+    {
+        /// <summary>
+        /// One entry per ELF member of the archive. Symbol tables and other members are skipped.
+        /// </summary>
+        std::vector<ElfInfo> objects;
+    };
+
+    /// <summary>
+    /// Returns nullopt if the file is not an ELF file, for example the linker script that libc.so is
+    /// </summary>
+    Optional<ElfInfo> read_elf(const fs::path& path);
+
+    /// <summary>
+    /// Returns nullopt if the file is not an `ar` archive
+    /// </summary>
+    Optional<ArchiveInfo> read_archive(const fs::path& path);
+}
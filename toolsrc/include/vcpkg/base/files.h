@@ -14,11 +14,13 @@ namespace fs
 
     using stdfs::copy_options;
     using stdfs::file_status;
+    using stdfs::file_time_type;
     using stdfs::path;
     using stdfs::u8path;
 
     inline bool is_regular_file(file_status s) { return stdfs::is_regular_file(s); }
     inline bool is_directory(file_status s) { return stdfs::is_directory(s); }
+    inline bool is_symlink(file_status s) { return stdfs::is_symlink(s); }
     inline bool status_known(file_status s) { return stdfs::status_known(s); }
 }
 
@@ -34,7 +36,13 @@ namespace vcpkg::Files
 
         virtual void write_lines(const fs::path& file_path, const std::vector<std::string>& lines) = 0;
         virtual void write_contents(const fs::path& file_path, const std::string& data) = 0;
+        virtual void write_contents(const fs::path& file_path, const std::string& data, std::error_code& ec) = 0;
+        /// <summary>
+        /// Appends data to the end of the file, creating it if needed, and flushes it to disk before returning
+        /// </summary>
+        virtual void append_contents(const fs::path& file_path, const std::string& data, std::error_code& ec) = 0;
         virtual void rename(const fs::path& oldpath, const fs::path& newpath) = 0;
+        virtual void rename(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) = 0;
         virtual bool remove(const fs::path& path) = 0;
         virtual bool remove(const fs::path& path, std::error_code& ec) = 0;
         virtual std::uintmax_t remove_all(const fs::path& path, std::error_code& ec) = 0;
@@ -49,11 +57,52 @@ namespace vcpkg::Files
                                const fs::path& newpath,
                                fs::copy_options opts,
                                std::error_code& ec) = 0;
+        /// <summary>
+        /// Creates newpath as a copy-on-write clone of oldpath. Fails, leaving nothing behind, if newpath exists or
+        /// the filesystem cannot share extents between the two files.
+        /// </summary>
+        virtual bool clone_file(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) = 0;
+        virtual void create_hard_link(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) = 0;
         virtual fs::file_status status(const fs::path& path, std::error_code& ec) const = 0;
+        virtual fs::file_status symlink_status(const fs::path& path, std::error_code& ec) const = 0;
+        virtual std::uintmax_t file_size(const fs::path& path, std::error_code& ec) const = 0;
+        virtual fs::file_time_type last_write_time(const fs::path& path, std::error_code& ec) const = 0;
+    };
+
+    /// <summary>
+    /// Read-only view of the entire contents of a file, mapped into memory
+    /// </summary>
+    struct MappedFile
+    {
+        static Expected<MappedFile> open(const fs::path& file_path);
+
+        MappedFile() = default;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        const char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+        void reset();
+
+    private:
+        const char* m_data = nullptr;
+        size_t m_size = 0;
     };
 
     Filesystem& get_real_filesystem();
 
+    /// <summary>
+    /// Replaces the contents of file_path, creating its directory if needed. The data is written to a temporary file
+    /// named after this process and renamed over file_path, so readers and other vcpkg processes replacing the same
+    /// file never see it half written.
+    /// </summary>
+    void write_contents_atomically(Filesystem& fs,
+                                   const fs::path& file_path,
+                                   const std::string& data,
+                                   std::error_code& ec);
+
     static const char* FILESYSTEM_INVALID_CHARACTERS = R"(\/:*?"<>|)";
 
     bool has_invalid_chars_for_filesystem(const std::string& s);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vcpkg/base/expected.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/optional.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vcpkg::Hash
+{
+    enum class Algorithm
+    {
+        SHA1,
+        SHA256,
+        SHA512,
+    };
+
+    /// <summary>
+    /// Accepts the names `vcpkg hash` and CMake use, such as "SHA512" or "sha512", ignoring case
+    /// </summary>
+    Optional<Algorithm> algorithm_from_string(const std::string& name);
+
+    const char* to_string(Algorithm algo);
+
+    struct Hasher
+    {
+        virtual void add_bytes(const void* data, size_t size) = 0;
+        /// <summary>
+        /// Returns the lowercase hex digest of everything added so far, and resets the hasher for reuse
+        /// </summary>
+        virtual std::string get_hash() = 0;
+        virtual void clear() = 0;
+
+        virtual ~Hasher() = default;
+    };
+
+    std::unique_ptr<Hasher> get_hasher_for(Algorithm algo);
+
+    std::string get_bytes_hash(const void* data, size_t size, Algorithm algo);
+    std::string get_string_hash(const std::string& s, Algorithm algo);
+    Expected<std::string> get_file_hash(const fs::path& path, Algorithm algo);
+
+    /// <summary>
+    /// Hashes each file on its own thread from the shared pool. The results keep the order of paths.
+    /// </summary>
+    std::vector<Expected<std::string>> get_files_hash(const std::vector<fs::path>& paths, Algorithm algo);
+}
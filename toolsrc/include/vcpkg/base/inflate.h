@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vcpkg::Inflate
+{
+    /// <summary>
+    /// Continues the CRC-32 of gzip and zip over more data. Start with a crc of 0.
+    /// </summary>
+    uint32_t crc32(uint32_t crc, const void* data, size_t size);
+
+    /// <summary>
+    /// Decodes a raw DEFLATE stream (RFC 1951) that is entirely in memory, such as a mapped file, one piece of
+    /// output at a time
+    /// </summary>
+    class Inflater
+    {
+    public:
+        Inflater(const char* data, size_t size, const std::string& label);
+
+        /// <summary>
+        /// Decodes the next piece of output, which stays valid until the next call. Returns false once the final
+        /// block has ended.
+        /// </summary>
+        bool next(const char*& output, size_t& output_size);
+
+        /// <summary>
+        /// Bytes of input used so far. Once next() has returned false, this is the size of the whole stream.
+        /// </summary>
+        size_t consumed() const;
+
+        struct Huffman
+        {
+            static constexpr unsigned FAST_BITS = 10;
+
+            /// <summary>
+            /// Returns false if the lengths describe an over-subscribed code
+            /// </summary>
+            bool build(const uint8_t* lengths, unsigned count);
+
+            // Indexed by the next FAST_BITS bits of input; (symbol << 4) | code length, or 0 for longer codes
+            uint16_t fast[1 << FAST_BITS];
+            uint16_t counts[16];
+            uint16_t symbols[288];
+        };
+
+    private:
+        enum class State
+        {
+            BLOCK_HEADER,
+            STORED,
+            HUFFMAN,
+            DONE,
+        };
+
+        void refill();
+        uint32_t read_bits(unsigned count);
+        unsigned decode(const Huffman& huffman);
+        void read_block_header();
+        void read_dynamic_tables();
+        void decode_huffman();
+        [[noreturn]] void fail() const;
+
+        const uint8_t* m_begin;
+        const uint8_t* m_in;
+        const uint8_t* m_end;
+        uint64_t m_bits = 0;
+        unsigned m_bit_count = 0;
+
+        State m_state = State::BLOCK_HEADER;
+        bool m_last_block = false;
+        size_t m_stored_remaining = 0;
+        const Huffman* m_litlen = nullptr;
+        const Huffman* m_dist = nullptr;
+        Huffman m_dynamic_litlen;
+        Huffman m_dynamic_dist;
+
+        // The last 32 KiB of output, which matches refer back into, followed by the piece being decoded
+        std::vector<uint8_t> m_window;
+        size_t m_window_end = 0;
+
+        const std::string& m_label;
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+namespace vcpkg::Jobserver
+{
+    /// <summary>
+    /// A GNU make jobserver: a pool of CPU tokens shared by every process started with makeflags() in MAKEFLAGS.
+    /// Each of those processes runs one job without a token, so the pool holds one token fewer than the CPUs.
+    /// </summary>
+    class TokenPool
+    {
+    public:
+        explicit TokenPool(size_t cpus);
+        TokenPool(const TokenPool&) = delete;
+        TokenPool& operator=(const TokenPool&) = delete;
+        ~TokenPool();
+
+        size_t cpus() const { return m_cpus; }
+
+        /// <summary>
+        /// The value of MAKEFLAGS that makes make, and other tools that speak its protocol, take tokens from the pool
+        /// </summary>
+        const std::string& makeflags() const { return m_makeflags; }
+
+        /// <summary>
+        /// Blocks until a token is free, and takes it
+        /// </summary>
+        void acquire();
+        void release();
+
+    private:
+        size_t m_cpus;
+        std::string m_makeflags;
+#if defined(_WIN32)
+        void* m_semaphore;
+#else
+        int m_read_fd;
+        int m_write_fd;
+#endif
+    };
+}
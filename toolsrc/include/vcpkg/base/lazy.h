@@ -1,26 +1,51 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 namespace vcpkg
 {
+    namespace details
+    {
+        // Shared by all lazies: initializers may use other lazies, and builds may run concurrently
+        inline std::recursive_mutex& lazy_initialization_mutex()
+        {
+            static std::recursive_mutex mutex;
+            return mutex;
+        }
+    }
+
     template<typename T>
     class Lazy
     {
     public:
         Lazy() : value(T()), initialized(false) {}
+        Lazy(const Lazy& other) : value(other.value), initialized(other.initialized.load()) {}
+
+        Lazy& operator=(const Lazy& other)
+        {
+            value = other.value;
+            initialized = other.initialized.load();
+            return *this;
+        }
 
         template<class F>
         T const& get_lazy(const F& f) const
         {
-            if (!initialized)
+            if (!initialized.load(std::memory_order_acquire))
             {
-                value = f();
-                initialized = true;
+                std::lock_guard<std::recursive_mutex> lock(details::lazy_initialization_mutex());
+                if (!initialized.load(std::memory_order_relaxed))
+                {
+                    value = f();
+                    initialized.store(true, std::memory_order_release);
+                }
             }
             return value;
         }
 
     private:
         mutable T value;
-        mutable bool initialized;
+        mutable std::atomic<bool> initialized;
     };
 }
@@ -84,6 +84,11 @@ namespace vcpkg::Strings
 
     std::vector<std::string> split(const std::string& s, const std::string& delimiter);
 
+    /// <summary>
+    /// Quotes and escapes str as a JSON string
+    /// </summary>
+    std::string to_json_string(const std::string& str);
+
     template<class T>
     std::string serialize(const T& t)
     {
@@ -4,12 +4,16 @@
 #include <vcpkg/base/optional.h>
 #include <vcpkg/base/strings.h>
 
+#include <unordered_map>
+
 namespace vcpkg::System
 {
     tm get_current_date_time();
 
     fs::path get_exe_path_of_current_process();
 
+    unsigned long get_current_process_id();
+
     struct CMakeVariable
     {
         CMakeVariable(const CStringView varname, const char* varvalue);
@@ -38,7 +42,46 @@ namespace vcpkg::System
         std::string output;
     };
 
-    int cmd_execute_clean(const CStringView cmd_line);
+    /// <summary>
+    /// Resources used by a process and all of its descendants
+    /// </summary>
+    struct ProcessUsage
+    {
+        uint64_t cpu_time_us = 0;
+        /// <summary>
+        /// The largest resident set of any one process on POSIX; the peak committed memory of all of them on Windows
+        /// </summary>
+        uint64_t peak_memory_bytes = 0;
+        /// <summary>
+        /// On POSIX only what went to or came from storage counts, not what the page cache served
+        /// </summary>
+        uint64_t bytes_read = 0;
+        uint64_t bytes_written = 0;
+        /// <summary>
+        /// Voluntary and involuntary. Windows does not count them, so they are 0 there.
+        /// </summary>
+        uint64_t context_switches = 0;
+    };
+
+    struct ExitCodeAndUsage
+    {
+        int exit_code;
+        ProcessUsage usage;
+    };
+
+    /// <summary>
+    /// Runs the command in a minimal environment on Windows, or the environment of vcpkg elsewhere, plus extra_env
+    /// </summary>
+    ExitCodeAndUsage cmd_execute_clean_with_usage(const CStringView cmd_line,
+                                                  const std::unordered_map<std::string, std::string>& extra_env = {});
+
+    int cmd_execute_clean(const CStringView cmd_line,
+                          const std::unordered_map<std::string, std::string>& extra_env = {});
+
+    /// <summary>
+    /// The resident memory of every process that vcpkg started, directly or through others. Only known on Linux.
+    /// </summary>
+    Optional<uint64_t> get_descendants_resident_memory();
 
     int cmd_execute(const CStringView cmd_line);
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -61,6 +63,50 @@ namespace vcpkg::Util
         return ret;
     }
 
+    /// <summary>
+    /// Invokes f(i) for every i in [0, count) on a bounded number of worker threads.
+    /// The calling thread participates in the work and the call returns once every index has been processed.
+    /// </summary>
+    template<class Func>
+    void parallel_for(const size_t count, Func&& f)
+    {
+        const size_t hardware_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t num_threads = std::min(count, hardware_threads);
+        if (num_threads <= 1)
+        {
+            for (size_t i = 0; i < count; ++i)
+                f(i);
+            return;
+        }
+
+        std::atomic<size_t> next_index(0);
+        auto work = [&]() {
+            for (size_t i = next_index++; i < count; i = next_index++)
+                f(i);
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(num_threads - 1);
+        for (size_t i = 1; i < num_threads; ++i)
+            workers.emplace_back(work);
+
+        work();
+
+        for (auto&& worker : workers)
+            worker.join();
+    }
+
+    /// <summary>
+    /// Like fmap, but evaluates f concurrently. The results keep the order of the input.
+    /// </summary>
+    template<class Cont, class Func, class Out = FmapOut<Cont, Func>>
+    std::vector<Out> parallel_fmap(Cont&& xs, Func&& f)
+    {
+        std::vector<Out> ret(xs.size());
+        parallel_for(xs.size(), [&](const size_t i) { ret[i] = f(xs[i]); });
+        return ret;
+    }
+
     template<class Container, class Pred>
     void stable_keep_if(Container& cont, Pred pred)
     {
@@ -14,6 +14,11 @@ namespace vcpkg
     {
         BinaryParagraph();
         explicit BinaryParagraph(std::unordered_map<std::string, std::string> fields);
+        explicit BinaryParagraph(Parse::ParagraphView fields);
+        /// <summary>
+        /// Reads the package fields that have not already been consumed from parser
+        /// </summary>
+        explicit BinaryParagraph(Parse::ParagraphParser&& parser);
         BinaryParagraph(const SourceParagraph& spgh, const Triplet& triplet);
         BinaryParagraph(const SourceParagraph& spgh, const FeatureParagraph& fpgh, const Triplet& triplet);
 
@@ -8,10 +8,13 @@
 
 #include <vcpkg/base/cstringview.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/jobserver.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/system.h>
 
 #include <array>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace vcpkg::Build
@@ -44,6 +47,19 @@ namespace vcpkg::Build
         YES
     };
 
+    /// <summary>
+    /// How the files of a built package are placed into the installed tree, from least to most invasive.
+    /// A strategy tries cloning, hard linking and moving in that order, up to and including itself, and copies
+    /// whatever could not be placed otherwise. MOVE removes the package directory once the package is installed.
+    /// </summary>
+    enum class InstallStrategy
+    {
+        COPY = 0,
+        CLONE,
+        HARDLINK,
+        MOVE
+    };
+
     enum class ConfigurationType
     {
         DEBUG,
@@ -55,6 +71,7 @@ namespace vcpkg::Build
         UseHeadVersion use_head_version;
         AllowDownloads allow_downloads;
         CleanBuildtrees clean_buildtrees;
+        InstallStrategy install_strategy;
     };
 
     enum class BuildResult
@@ -110,6 +127,10 @@ namespace vcpkg::Build
         BuildResult code;
         std::vector<PackageSpec> unmet_dependencies;
         std::unique_ptr<BinaryControlFile> binary_control_file;
+        // Set when the package was restored from the binary cache instead of being built
+        bool restored_from_cache = false;
+        // What the portfile and everything it started used, when it ran
+        Optional<System::ProcessUsage> usage;
     };
 
     struct BuildPackageConfig
@@ -132,12 +153,76 @@ namespace vcpkg::Build
         fs::path port_dir;
         const BuildPackageOptions& build_package_options;
         const std::unordered_set<std::string>& feature_list;
+        /// <summary>
+        /// The number of parallel jobs for build tools that cannot take jobserver tokens, such as ninja and msbuild,
+        /// passed to the portfile as VCPKG_CONCURRENCY. 0 lets them choose.
+        /// </summary>
+        size_t concurrency = 0;
     };
 
     ExtendedBuildResult build_package(const VcpkgPaths& paths,
                                       const BuildPackageConfig& config,
                                       const StatusParagraphs& status_db);
 
+    /// <summary>
+    /// Guards the buildtrees directory of a port, which builds and downloads for different triplets share.
+    /// build_package() holds it for the whole build.
+    /// </summary>
+    std::mutex& get_port_mutex(const std::string& port_name);
+
+    /// <summary>
+    /// The jobserver that every build shares when `--x-max-cpus` was given, or nullptr.
+    /// A build that runs next to others must hold a token from it, except for the one build that uses the implicit
+    /// token of the pool.
+    /// </summary>
+    Jobserver::TokenPool* get_build_jobserver();
+
+    struct DownloadSourcesResult
+    {
+        bool succeeded;
+        /// <summary>
+        /// Everything the portfile printed, which is only worth showing when a download failed
+        /// </summary>
+        std::string output;
+    };
+
+    /// <summary>
+    /// Runs the portfile in download mode: every distfile it asks for is downloaded into downloads/ and verified,
+    /// and the portfile halts at its first build step. Neither the package nor its dependencies need to exist.
+    /// </summary>
+    DownloadSourcesResult download_sources(const VcpkgPaths& paths, const BuildPackageConfig& config);
+
+    /// <summary>
+    /// Specs of the packages that the given features of a port depend on
+    /// </summary>
+    std::vector<PackageSpec> get_dependency_specs(const SourceControlFile& scf,
+                                                  const std::unordered_set<std::string>& features,
+                                                  const Triplet& triplet);
+
+    struct AbiEntry
+    {
+        std::string key;
+        std::string value;
+    };
+
+    struct AbiTagAndInfo
+    {
+        std::string tag;
+        /// <summary>
+        /// The hashed entries, one per line. Builds keep them in buildtrees to explain why a package was rebuilt.
+        /// </summary>
+        std::string info;
+    };
+
+    /// <summary>
+    /// Computes the ABI tag of a build from the port files, the triplet file, the enabled features and the ABI tags
+    /// of the dependencies. Returns nullopt for builds that are not determined by those, such as HEAD builds.
+    /// Writes nothing, so it is safe to call while planning.
+    /// </summary>
+    Optional<AbiTagAndInfo> compute_abi_tag(const VcpkgPaths& paths,
+                                            const BuildPackageConfig& config,
+                                            const std::vector<AbiEntry>& dependency_abis);
+
     enum class BuildPolicy
     {
         EMPTY_PACKAGE,
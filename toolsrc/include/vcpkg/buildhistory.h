@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vcpkg/packagespec.h>
+#include <vcpkg/vcpkgpaths.h>
+
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/system.h>
+
+#include <vector>
+
+namespace vcpkg
+{
+    struct BuildRecord
+    {
+        std::string port;
+        std::string triplet;
+        std::string version;
+        uint64_t build_time_us = 0;
+        System::ProcessUsage usage;
+    };
+
+    /// <summary>
+    /// How long earlier builds of each port, triplet and version took, and what they used.
+    /// </summary>
+    /// <remarks>
+    ///   The history is kept in downloads/build.history, so it survives cleaning buildtrees and installed, and holds
+    ///   the last successful build of each port, triplet and version.
+    /// </remarks>
+    struct BuildHistory
+    {
+        static BuildHistory load(const VcpkgPaths& paths);
+
+        /// <summary>
+        /// Returns the build of this version of spec, or else the last build of another version, which is usually a
+        /// close estimate
+        /// </summary>
+        Optional<const BuildRecord&> find(const PackageSpec& spec, const std::string& version) const;
+
+        /// <summary>
+        /// Adds the record to the history file. Safe to call from concurrent builds.
+        /// </summary>
+        static void record(const VcpkgPaths& paths, BuildRecord&& record);
+
+    private:
+        std::vector<BuildRecord> m_records;
+    };
+}
@@ -4,6 +4,7 @@
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
 #include <vcpkg/packagespec.h>
+#include <vcpkg/portindex.h>
 #include <vcpkg/statusparagraphs.h>
 #include <vcpkg/vcpkgpaths.h>
 
@@ -58,6 +59,10 @@ namespace vcpkg::Dependencies
         RequestType request_type;
         Build::BuildPackageOptions build_options;
         std::unordered_set<std::string> feature_list;
+
+        // Only computed when binary caching is enabled
+        std::string abi;
+        bool in_binary_cache = false;
     };
 
     enum class RemovePlanType
@@ -140,6 +145,7 @@ namespace vcpkg::Dependencies
 
     private:
         const VcpkgPaths& ports;
+        PortIndex index;
         mutable std::unordered_map<std::string, SourceControlFile> cache;
     };
 
@@ -14,6 +14,15 @@ namespace vcpkg
 
         static std::atomic<bool> debugging;
         static std::atomic<bool> feature_packages;
+        static std::atomic<bool> binary_caching;
+        /// <summary>
+        /// The CPU budget that all builds share through a jobserver, from `--x-max-cpus`. 0 if there is none.
+        /// </summary>
+        static std::atomic<size_t> max_cpus;
+        /// <summary>
+        /// The memory that concurrent builds may use together, from `--x-max-memory`. 0 if there is no limit.
+        /// </summary>
+        static std::atomic<uint64_t> max_memory_bytes;
 
         static std::atomic<int> g_init_console_cp;
         static std::atomic<int> g_init_console_output_cp;
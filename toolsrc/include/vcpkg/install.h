@@ -3,6 +3,7 @@
 #include <vcpkg/base/chrono.h>
 #include <vcpkg/build.h>
 #include <vcpkg/dependencies.h>
+#include <vcpkg/ownershipindex.h>
 #include <vcpkg/vcpkgcmdarguments.h>
 #include <vcpkg/vcpkgpaths.h>
 
@@ -31,13 +32,32 @@ namespace vcpkg::Install
         const Dependencies::AnyAction* action;
     };
 
+    /// <summary>
+    /// Number of files placed into the installed tree by each install strategy
+    /// </summary>
+    struct InstalledFileCounts
+    {
+        size_t cloned = 0;
+        size_t hardlinked = 0;
+        size_t moved = 0;
+        size_t copied = 0;
+
+        InstalledFileCounts& operator+=(const InstalledFileCounts& other);
+        std::string to_string() const;
+    };
+
     struct InstallSummary
     {
         std::vector<SpecSummary> results;
         std::string total_elapsed_time;
+        InstalledFileCounts file_counts;
 
         void print() const;
         std::string xunit_results() const;
+        /// <summary>
+        /// One JSON object per result, separated by commas, to be placed in an array
+        /// </summary>
+        std::string json_results() const;
     };
 
     struct InstallDir
@@ -59,7 +79,9 @@ namespace vcpkg::Install
 
     Build::ExtendedBuildResult perform_install_plan_action(const VcpkgPaths& paths,
                                                            const Dependencies::InstallPlanAction& action,
-                                                           StatusParagraphs& status_db);
+                                                           StatusParagraphs& status_db,
+                                                           OwnershipIndexes& ownership_indexes,
+                                                           InstalledFileCounts& file_counts);
 
     enum class InstallResult
     {
@@ -69,15 +91,41 @@ namespace vcpkg::Install
 
     std::vector<std::string> get_all_port_names(const VcpkgPaths& paths);
 
-    void install_files_and_write_listfile(Files::Filesystem& fs, const fs::path& source_dir, const InstallDir& dirs);
+    InstalledFileCounts install_files_and_write_listfile(Files::Filesystem& fs,
+                                                         const fs::path& source_dir,
+                                                         const InstallDir& dirs,
+                                                         Build::InstallStrategy strategy);
+    /// <summary>
+    /// Installs the built package. The ownership index of its triplet is updated in memory; the caller writes it.
+    /// </summary>
     InstallResult install_package(const VcpkgPaths& paths,
                                   const BinaryControlFile& binary_paragraph,
-                                  StatusParagraphs* status_db);
-
+                                  Build::InstallStrategy strategy,
+                                  StatusParagraphs* status_db,
+                                  OwnershipIndexes* ownership_indexes,
+                                  InstalledFileCounts* file_counts);
+
+    /// <summary>
+    /// Performs the plan in order. With more than one job, ports whose dependencies are installed are built
+    /// concurrently; the results are the same as with a single job. Plans performed at the same time, such as the
+    /// triplets of a ci run, share one budget of jobs. The owns index is left to the caller, which updates it once
+    /// every plan is done.
+    /// </summary>
     InstallSummary perform(const std::vector<Dependencies::AnyAction>& action_plan,
                            const KeepGoing keep_going,
                            const VcpkgPaths& paths,
-                           StatusParagraphs& status_db);
+                           StatusParagraphs& status_db,
+                           const size_t jobs);
+
+    /// <summary>
+    /// Parses the value of an --x-jobs option. 0 means one job per hardware thread.
+    /// </summary>
+    size_t parse_jobs(const std::string& value);
+
+    /// <summary>
+    /// Parses a memory size in megabytes, or in gigabytes with a G suffix, such as 512 or 16G
+    /// </summary>
+    uint64_t parse_memory_size(const std::string& value);
 
     extern const CommandStructure COMMAND_STRUCTURE;
 
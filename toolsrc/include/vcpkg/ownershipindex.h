@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vcpkg/binaryparagraph.h>
+#include <vcpkg/statusparagraphs.h>
+#include <vcpkg/vcpkgpaths.h>
+
+#include <map>
+#include <unordered_map>
+
+namespace vcpkg
+{
+    /// <summary>
+    /// Maps every file installed for one triplet to the package that owns it.
+    /// </summary>
+    /// <remarks>
+    ///   The index is stored next to the listfiles in installed/vcpkg/info and is kept up to date by install and
+    ///   remove. Files are relative to the triplet directory, without the trailing slash of directories (which are
+    ///   not tracked). If the packages in the index do not match the installed packages, it is rebuilt from their
+    ///   listfiles.
+    /// </remarks>
+    struct OwnershipIndex
+    {
+        static OwnershipIndex load(const VcpkgPaths& paths, const StatusParagraphs& status_db, const Triplet& triplet);
+
+        /// <summary>
+        /// Returns the fullstem of the package that installed file, or nullptr if no package did
+        /// </summary>
+        const std::string* find_owner(const std::string& file) const;
+
+        void add_package(const VcpkgPaths& paths, const BinaryParagraph& core_paragraph);
+        void remove_package(const BinaryParagraph& core_paragraph);
+
+        void write(Files::Filesystem& fs) const;
+
+    private:
+        friend struct OwnershipIndexes;
+
+        OwnershipIndex(const fs::path& index_file, const Triplet& triplet);
+
+        void add_package_files(const std::string& fullstem, std::vector<std::string>&& files);
+
+        fs::path m_index_file;
+        Triplet m_triplet;
+        // fullstem -> installed files
+        std::map<std::string, std::vector<std::string>> m_package_files;
+        // installed file -> fullstem
+        std::unordered_map<std::string, std::string> m_owners;
+    };
+
+    /// <summary>
+    /// The ownership indexes of the triplets that a plan installs into or removes from. Each is read once, on first
+    /// use, and written once by write(), however many packages the plan changes.
+    /// </summary>
+    /// <remarks>
+    ///   get() deletes the index file it loads, so a plan that stops before write() leaves no stale index behind;
+    ///   the next load rebuilds it from the listfiles.
+    /// </remarks>
+    struct OwnershipIndexes
+    {
+        OwnershipIndex& get(const VcpkgPaths& paths, const StatusParagraphs& status_db, const Triplet& triplet);
+
+        void write(Files::Filesystem& fs) const;
+
+    private:
+        std::map<Triplet, OwnershipIndex> m_indexes;
+    };
+}
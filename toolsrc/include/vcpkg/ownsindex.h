@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vcpkg/statusparagraphs.h>
+#include <vcpkg/vcpkgpaths.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/util.h>
+
+#include <string_view>
+#include <unordered_map>
+
+namespace vcpkg
+{
+    /// <summary>
+    /// Trigram index over the files of every installed package, used by `vcpkg owns`.
+    /// </summary>
+    /// <remarks>
+    ///   The index file holds one self-contained segment per installed package, keyed by its fullstem. Each
+    ///   segment contains the size and time of the listfile it was built from, the sorted files of the package and
+    ///   a table from every trigram to the files containing it. Updating the index only builds segments for
+    ///   packages whose listfile changed, such as a package reinstalled at the same version with other features;
+    ///   all other segments are copied as they are.
+    /// </remarks>
+    struct OwnsIndex : Util::ResourceBase
+    {
+        explicit OwnsIndex(const fs::path& index_file);
+
+        /// <summary>
+        /// Adds segments for installed packages that are missing from the index or whose listfile changed, drops
+        /// the segments of packages that are no longer installed, and rewrites the index file if anything changed.
+        /// </summary>
+        void update(const VcpkgPaths& paths, const StatusParagraphs& status_db);
+
+        /// <summary>
+        /// Returns the files of the package that contain query, or whose file name is query if exact_filename is
+        /// set, in sorted order
+        /// </summary>
+        std::vector<std::string> find_files(const std::string& fullstem,
+                                            const std::string& query,
+                                            bool exact_filename) const;
+
+    private:
+        struct Segment
+        {
+            const char* begin;
+            const char* end;
+            std::uint64_t listfile_size;
+            std::uint64_t listfile_time;
+            std::uint32_t path_count;
+            const char* path_offsets;
+            std::uint32_t trigram_count;
+            const char* trigrams;
+            const char* postings;
+            const char* blob;
+        };
+
+        void load_segments(const char* data, size_t size);
+
+        fs::path m_index_file;
+        Files::MappedFile m_mapped_index;
+        // Used instead of the mapped file after the index has been updated
+        std::string m_contents;
+        std::unordered_map<std::string_view, Segment> m_segments;
+    };
+}
@@ -2,6 +2,7 @@
 
 #include <vcpkg/binaryparagraph.h>
 #include <vcpkg/parse.h>
+#include <vcpkg/portindex.h>
 #include <vcpkg/vcpkgpaths.h>
 #include <vcpkg/versiont.h>
 
@@ -13,12 +14,36 @@ namespace vcpkg::Paragraphs
 {
     using RawParagraph = Parse::RawParagraph;
 
+    /// <summary>
+    /// Paragraphs parsed in place: every field name and value is a view into the text owned by this object.
+    /// </summary>
+    struct ParsedParagraphs
+    {
+        ParsedParagraphs() = default;
+        explicit ParsedParagraphs(std::string&& text);
+
+        size_t size() const { return m_paragraph_ends.size(); }
+        Parse::ParagraphView operator[](size_t i) const;
+        std::vector<Parse::ParagraphView> paragraphs() const;
+
+    private:
+        // Heap allocated so that the views stay valid when this object is moved
+        std::unique_ptr<const std::string> m_text;
+        std::vector<Parse::ParagraphField> m_fields;
+        std::vector<size_t> m_paragraph_ends;
+    };
+
+    Expected<ParsedParagraphs> get_parsed_paragraphs(const Files::Filesystem& fs, const fs::path& control_path);
+
     Expected<RawParagraph> get_single_paragraph(const Files::Filesystem& fs, const fs::path& control_path);
     Expected<std::vector<RawParagraph>> get_paragraphs(const Files::Filesystem& fs, const fs::path& control_path);
     Expected<RawParagraph> parse_single_paragraph(const std::string& str);
     Expected<std::vector<RawParagraph>> parse_paragraphs(const std::string& str);
 
     Parse::ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs, const fs::path& control_path);
+    Parse::ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs,
+                                                          const fs::path& control_path,
+                                                          const PortIndex& index);
 
     Expected<BinaryControlFile> try_load_cached_control_package(const VcpkgPaths& paths, const PackageSpec& spec);
 
@@ -30,6 +55,12 @@ namespace vcpkg::Paragraphs
 
     LoadResults try_load_all_ports(const Files::Filesystem& fs, const fs::path& ports_dir);
 
+    /// <summary>
+    /// Loads every port in paths.ports, reusing and refreshing the port index in paths.ports_index_file
+    /// </summary>
+    LoadResults try_load_all_ports(const VcpkgPaths& paths);
+
     std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const Files::Filesystem& fs,
                                                                    const fs::path& ports_dir);
+    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const VcpkgPaths& paths);
 }
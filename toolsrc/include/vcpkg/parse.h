@@ -2,8 +2,10 @@
 
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/span.h>
 
 #include <memory>
+#include <string_view>
 #include <unordered_map>
 
 namespace vcpkg::Parse
@@ -21,16 +23,65 @@ namespace vcpkg::Parse
 
     using RawParagraph = std::unordered_map<std::string, std::string>;
 
+    /// <summary>
+    /// Interned names of the fields that appear in CONTROL and status paragraphs
+    /// </summary>
+    enum class FieldId : unsigned char
+    {
+        UNKNOWN,
+        ABI,
+        ARCHITECTURE,
+        BUILD_DEPENDS,
+        DEFAULT_FEATURES,
+        DEPENDS,
+        DESCRIPTION,
+        FEATURE,
+        MAINTAINER,
+        MULTI_ARCH,
+        PACKAGE,
+        SOURCE,
+        STATUS,
+        SUPPORTS,
+        VERSION,
+    };
+
+    FieldId intern_field_name(std::string_view fieldname);
+
+    struct ParagraphField
+    {
+        FieldId id;
+        std::string_view name;
+        /// <summary>
+        /// The text of the value as it appears in the file; multi-line values still contain their original line
+        /// endings. Use value_string() to get the normalized value.
+        /// </summary>
+        std::string_view value;
+
+        std::string value_string() const;
+    };
+
+    /// <summary>
+    /// The fields of one paragraph, in file order
+    /// </summary>
+    using ParagraphView = Span<const ParagraphField>;
+
     struct ParagraphParser
     {
-        ParagraphParser(RawParagraph&& fields) : fields(std::move(fields)) {}
+        ParagraphParser(RawParagraph&& fields);
+        ParagraphParser(ParagraphView fields);
+        ParagraphParser(const ParagraphParser&) = delete;
+        ParagraphParser& operator=(const ParagraphParser&) = delete;
 
         void required_field(const std::string& fieldname, std::string& out);
         std::string optional_field(const std::string& fieldname) const;
         std::unique_ptr<ParseControlErrorInfo> error_info(const std::string& name) const;
 
     private:
-        RawParagraph&& fields;
+        const ParagraphField* remove_field(const std::string& fieldname) const;
+
+        std::vector<ParagraphField> owned_fields;
+        ParagraphView fields;
+        mutable std::vector<bool> consumed;
         std::vector<std::string> missing_fields;
     };
 
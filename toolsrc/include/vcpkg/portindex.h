@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vcpkg/parse.h>
+#include <vcpkg/sourceparagraph.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/util.h>
+
+#include <map>
+#include <unordered_map>
+
+namespace vcpkg
+{
+    enum class UpdatePortIndex
+    {
+        NO = 0,
+        YES
+    };
+
+    /// <summary>
+    /// On-disk cache of parsed port CONTROL files.
+    /// </summary>
+    /// <remarks>
+    ///   Every entry is keyed by the port directory name and stamped with the size, last write time and content
+    ///   hash of its CONTROL file. The index file is memory-mapped when loaded; only ports whose CONTROL file
+    ///   changed are read and parsed again.
+    /// </remarks>
+    struct PortIndex : Util::ResourceBase
+    {
+        /// <summary>
+        /// With UpdatePortIndex::NO the index is only read; loaded ports are not recorded for write().
+        /// </summary>
+        PortIndex(const fs::path& index_file, UpdatePortIndex update);
+
+        /// <summary>
+        /// Loads the control file of the port in port_dir, from the index if its stamps are still valid.
+        /// Safe to call concurrently. The result is not adjusted for the feature packages setting.
+        /// </summary>
+        Parse::ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs,
+                                                              const fs::path& port_dir) const;
+
+        /// <summary>
+        /// Rewrites the index file with exactly the ports loaded through this object, if that differs from the
+        /// index that was read.
+        /// </summary>
+        void write(Files::Filesystem& fs);
+
+    private:
+        struct Stamp
+        {
+            std::int64_t last_write_time;
+            std::uint64_t size;
+            std::uint64_t hash;
+        };
+
+        struct IndexedPort
+        {
+            Stamp stamp;
+            const char* record;
+            size_t record_size;
+        };
+
+        struct LoadedPort
+        {
+            Stamp stamp;
+            // Empty when the record in the mapped index file is still current
+            std::string new_record;
+        };
+
+        fs::path m_index_file;
+        UpdatePortIndex m_update;
+        Files::MappedFile m_mapped_index;
+        std::unordered_map<std::string, IndexedPort> m_indexed_ports;
+        mutable Util::LockGuarded<std::map<std::string, LoadedPort>> m_loaded_ports;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vcpkg/dependencies.h>
+#include <vcpkg/ownershipindex.h>
 #include <vcpkg/vcpkgcmdarguments.h>
 #include <vcpkg/vcpkgpaths.h>
 
@@ -17,10 +18,17 @@ namespace vcpkg::Remove
     void perform_remove_plan_action(const VcpkgPaths& paths,
                                     const Dependencies::RemovePlanAction& action,
                                     const Purge purge,
-                                    StatusParagraphs* status_db);
+                                    StatusParagraphs* status_db,
+                                    OwnershipIndexes* ownership_indexes);
 
     extern const CommandStructure COMMAND_STRUCTURE;
 
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths, const Triplet& default_triplet);
-    void remove_package(const VcpkgPaths& paths, const PackageSpec& spec, StatusParagraphs* status_db);
+    /// <summary>
+    /// Removes the installed package. The ownership index of its triplet is updated in memory; the caller writes it.
+    /// </summary>
+    void remove_package(const VcpkgPaths& paths,
+                        const PackageSpec& spec,
+                        StatusParagraphs* status_db,
+                        OwnershipIndexes* ownership_indexes);
 }
@@ -31,12 +31,16 @@ namespace vcpkg
     {
         StatusParagraph();
         explicit StatusParagraph(std::unordered_map<std::string, std::string>&& fields);
+        explicit StatusParagraph(Parse::ParagraphView fields);
 
         bool is_installed() const { return want == Want::INSTALL && state == InstallState::INSTALLED; }
 
         BinaryParagraph package;
         Want want;
         InstallState state;
+
+    private:
+        explicit StatusParagraph(Parse::ParagraphParser&& parser);
     };
 
     void serialize(const StatusParagraph& pgh, std::string& out_str);
@@ -3,6 +3,7 @@
 
 #include <iterator>
 #include <memory>
+#include <unordered_map>
 
 namespace vcpkg
 {
@@ -39,7 +40,44 @@ namespace vcpkg
         const_iterator begin() const { return paragraphs.rbegin(); }
 
     private:
+        struct SpecKey
+        {
+            std::string name;
+            Triplet triplet;
+
+            bool operator==(const SpecKey& other) const { return name == other.name && triplet == other.triplet; }
+        };
+
+        struct FeatureKey
+        {
+            SpecKey spec;
+            std::string feature;
+
+            bool operator==(const FeatureKey& other) const
+            {
+                return spec == other.spec && feature == other.feature;
+            }
+        };
+
+        struct SpecKeyHash
+        {
+            size_t operator()(const SpecKey& key) const;
+            size_t operator()(const FeatureKey& key) const;
+        };
+
+        iterator make_iterator(size_t index) { return iterator(paragraphs.begin() + index + 1); }
+        const_iterator make_iterator(size_t index) const { return const_iterator(paragraphs.begin() + index + 1); }
+
+        void index_paragraph(size_t index);
+        const std::vector<size_t>* find_spec_indices(const std::string& name, const Triplet& triplet) const;
+        Optional<size_t> find_index(const std::string& name, const Triplet& triplet, const std::string& feature) const;
+
         std::vector<std::unique_ptr<StatusParagraph>> paragraphs;
+
+        // Positions in paragraphs of the last paragraph for each (name, triplet, feature)
+        std::unordered_map<FeatureKey, size_t, SpecKeyHash> feature_index;
+        // Positions in paragraphs of every paragraph for each (name, triplet), in order
+        std::unordered_map<SpecKey, std::vector<size_t>, SpecKeyHash> spec_index;
     };
 
     void serialize(const StatusParagraphs& pgh, std::string& out_str);
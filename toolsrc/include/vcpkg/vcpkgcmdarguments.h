@@ -75,6 +75,8 @@ namespace vcpkg
 
         std::unique_ptr<std::string> vcpkg_root_dir;
         std::unique_ptr<std::string> triplet;
+        std::unique_ptr<std::string> max_cpus;
+        std::unique_ptr<std::string> max_memory;
         Optional<bool> debug = nullopt;
         Optional<bool> sendmetrics = nullopt;
         Optional<bool> printmetrics = nullopt;
@@ -8,7 +8,11 @@ namespace vcpkg
 {
     StatusParagraphs database_load_check(const VcpkgPaths& paths);
 
-    void write_update(const VcpkgPaths& paths, const StatusParagraph& p);
+    /// <summary>
+    /// Durably appends the paragraphs to the status journal as one record. After a crash, either all or none of
+    /// them are replayed by the next database_load_check().
+    /// </summary>
+    void write_updates(const VcpkgPaths& paths, Span<const StatusParagraph> pghs);
 
     struct StatusParagraphAndAssociatedFiles
     {
@@ -17,6 +21,11 @@ namespace vcpkg
     };
 
     std::vector<StatusParagraph*> get_installed_ports(const StatusParagraphs& status_db);
+
+    /// <summary>
+    /// Returns the sorted files (but not directories) installed by the package
+    /// </summary>
+    SortedVector<std::string> get_installed_files(const VcpkgPaths& paths, const BinaryParagraph& core_paragraph);
     std::vector<StatusParagraphAndAssociatedFiles> get_installed_files(const VcpkgPaths& paths,
                                                                        const StatusParagraphs& status_db);
 
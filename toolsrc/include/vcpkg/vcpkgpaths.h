@@ -40,6 +40,7 @@ namespace vcpkg
         fs::path port_dir(const std::string& name) const;
         fs::path build_info_file_path(const PackageSpec& spec) const;
         fs::path listfile_path(const BinaryParagraph& pgh) const;
+        fs::path archive_path(const std::string& abi_tag) const;
 
         const std::vector<std::string>& get_available_triplets() const;
         bool is_valid_triplet(const Triplet& t) const;
@@ -48,6 +49,7 @@ namespace vcpkg
         fs::path packages;
         fs::path buildtrees;
         fs::path downloads;
+        fs::path archives;
         fs::path ports;
         fs::path installed;
         fs::path triplets;
@@ -59,9 +61,14 @@ namespace vcpkg
         fs::path vcpkg_dir;
         fs::path vcpkg_dir_status_file;
         fs::path vcpkg_dir_info;
+        fs::path vcpkg_dir_status_journal;
         fs::path vcpkg_dir_updates;
+        fs::path vcpkg_dir_owns_index;
 
         fs::path ports_cmake;
+        fs::path ports_index_file;
+        fs::path tools_cache_file;
+        fs::path build_history_file;
 
         const fs::path& get_cmake_exe() const;
         const fs::path& get_git_exe() const;
@@ -0,0 +1,58 @@
+#include "tests.pch.h"
+
+#include <vcpkg/base/hash.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Hash = vcpkg::Hash;
+
+namespace UnitTest1
+{
+    class HashTests : public TestClass<HashTests>
+    {
+        TEST_METHOD(empty_string)
+        {
+            Assert::AreEqual("da39a3ee5e6b4b0d3255bfef95601890afd80709",
+                             Hash::get_string_hash("", Hash::Algorithm::SHA1).c_str());
+            Assert::AreEqual("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                             Hash::get_string_hash("", Hash::Algorithm::SHA256).c_str());
+            Assert::AreEqual("cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+                             "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e",
+                             Hash::get_string_hash("", Hash::Algorithm::SHA512).c_str());
+        }
+
+        TEST_METHOD(abc)
+        {
+            Assert::AreEqual("a9993e364706816aba3e25717850c26c9cd0d89d",
+                             Hash::get_string_hash("abc", Hash::Algorithm::SHA1).c_str());
+            Assert::AreEqual("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+                             Hash::get_string_hash("abc", Hash::Algorithm::SHA256).c_str());
+            Assert::AreEqual("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                             "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+                             Hash::get_string_hash("abc", Hash::Algorithm::SHA512).c_str());
+        }
+
+        TEST_METHOD(million_a_in_pieces)
+        {
+            const std::string piece(1000, 'a');
+            auto hasher = Hash::get_hasher_for(Hash::Algorithm::SHA256);
+            for (int i = 0; i < 1000; ++i)
+                hasher->add_bytes(piece.data(), piece.size());
+
+            Assert::AreEqual("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+                             hasher->get_hash().c_str());
+            // get_hash() resets the hasher
+            Assert::AreEqual("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                             hasher->get_hash().c_str());
+        }
+
+        TEST_METHOD(algorithm_from_string)
+        {
+            Assert::IsTrue(Hash::algorithm_from_string("SHA512").value_or_exit(VCPKG_LINE_INFO) ==
+                           Hash::Algorithm::SHA512);
+            Assert::IsTrue(Hash::algorithm_from_string("sha1").value_or_exit(VCPKG_LINE_INFO) ==
+                           Hash::Algorithm::SHA1);
+            Assert::IsFalse(Hash::algorithm_from_string("md5").has_value());
+        }
+    };
+}
@@ -0,0 +1,75 @@
+#include "tests.pch.h"
+
+#include <vcpkg/base/archives.h>
+#include <vcpkg/base/inflate.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Archives = vcpkg::Archives;
+namespace Inflate = vcpkg::Inflate;
+
+namespace UnitTest1
+{
+    class InflateTests : public TestClass<InflateTests>
+    {
+        static std::string inflate(const char* data, size_t size)
+        {
+            static const std::string label = "test data";
+
+            Inflate::Inflater inflater(data, size, label);
+            std::string ret;
+            const char* output;
+            size_t output_size;
+            while (inflater.next(output, output_size))
+                ret.append(output, output_size);
+
+            Assert::AreEqual(size, inflater.consumed());
+            return ret;
+        }
+
+        TEST_METHOD(crc32_check_value)
+        {
+            Assert::AreEqual(0xcbf43926u, Inflate::crc32(0, "123456789", 9));
+            // Continuing over the pieces of the input gives the same result
+            Assert::AreEqual(0xcbf43926u, Inflate::crc32(Inflate::crc32(0, "1234", 4), "56789", 5));
+        }
+
+        TEST_METHOD(stored_block)
+        {
+            static const char DATA[] = "\x01\x05\x00\xfa\xff\x76\x63\x70\x6b\x67";
+            Assert::AreEqual("vcpkg", inflate(DATA, sizeof(DATA) - 1).c_str());
+        }
+
+        TEST_METHOD(fixed_huffman_block)
+        {
+            static const char DATA[] = "\x4b\x4c\x4a\x4e\xc4\x40\x00";
+            Assert::AreEqual("abcabcabcabcabcabcabc", inflate(DATA, sizeof(DATA) - 1).c_str());
+        }
+
+        TEST_METHOD(dynamic_huffman_block)
+        {
+            static const char DATA[] =
+                "\x6d\xd2\x31\x0e\x83\x40\x10\x43\xd1\x9e\x53\xec\x11\xb0\x9d\x40\x38\xd0\xa2\x20\xa1\x50\xb0\xf7"
+                "\x57\x94\x32\x9a\xdf\xfe\xca\x4f\x33\xe7\xf1\xe9\x6d\x6e\xd7\xde\xc6\xbb\xb7\xd1\xef\x31\x9d\xbf"
+                "\xa4\x9a\x5c\x53\x6a\x7a\xd4\xf4\xac\x69\xa9\x69\xad\xe9\x55\xd3\x06\x53\x69\x3e\xec\x17\x00\x04"
+                "\x02\x01\x41\x60\x10\x20\x04\x0a\x01\x43\xe0\x30\x38\x4c\x77\x00\x87\xc1\x61\x70\x18\x1c\x06\x87"
+                "\xc1\x61\x70\x18\x1c\x01\x47\xc0\x11\x7a\x28\x70\x04\x1c\x01\x47\xc0\x11\x70\x04\x1c\xf9\x77\x7c"
+                "\x01";
+
+            std::string expected;
+            for (int i = 0; i < 40; ++i)
+                expected += "line " + std::to_string(i) + " of the test\n";
+            Assert::AreEqual(expected, inflate(DATA, sizeof(DATA) - 1));
+        }
+
+        TEST_METHOD(detect_archive_format)
+        {
+            std::string tar(512, '\0');
+            tar.replace(257, 6, "ustar", 6);
+            Assert::IsTrue(Archives::detect_format(tar.data(), tar.size()) == Archives::ArchiveFormat::TAR);
+            Assert::IsTrue(Archives::detect_format("\x1f\x8b\x08\x00", 4) == Archives::ArchiveFormat::GZIP_TAR);
+            Assert::IsTrue(Archives::detect_format("PK\x03\x04", 4) == Archives::ArchiveFormat::ZIP);
+            Assert::IsTrue(Archives::detect_format("BZh9", 4) == Archives::ArchiveFormat::OTHER);
+        }
+    };
+}
@@ -340,6 +340,44 @@ namespace UnitTest1
             Assert::AreEqual("v1", pghs[0]["f1"].c_str());
         }
 
+        TEST_METHOD(parsed_paragraphs_field_ids)
+        {
+            const vcpkg::Paragraphs::ParsedParagraphs pghs("Source: zlib\r\n"
+                                                           "Description: d1\r\n"
+                                                           "  d2\r\n"
+                                                           "\r\n"
+                                                           "Feature: f\n"
+                                                           "X-Custom: c\n");
+            Assert::AreEqual(size_t(2), pghs.size());
+            Assert::AreEqual(size_t(2), pghs[0].size());
+            Assert::IsTrue(pghs[0][0].id == vcpkg::Parse::FieldId::SOURCE);
+            Assert::AreEqual("zlib", pghs[0][0].value_string().c_str());
+            Assert::IsTrue(pghs[0][1].id == vcpkg::Parse::FieldId::DESCRIPTION);
+            Assert::AreEqual("d1\n  d2", pghs[0][1].value_string().c_str());
+            Assert::AreEqual(size_t(2), pghs[1].size());
+            Assert::IsTrue(pghs[1][0].id == vcpkg::Parse::FieldId::FEATURE);
+            Assert::IsTrue(pghs[1][1].id == vcpkg::Parse::FieldId::UNKNOWN);
+            Assert::AreEqual("X-Custom", std::string(pghs[1][1].name).c_str());
+        }
+
+        TEST_METHOD(parsed_paragraphs_control_file)
+        {
+            const vcpkg::Paragraphs::ParsedParagraphs pghs("Source: s\n"
+                                                           "Version: v\n"
+                                                           "Build-Depends: a, b\n"
+                                                           "\n"
+                                                           "Feature: f\n"
+                                                           "Description: d\n");
+            auto m_pgh = vcpkg::SourceControlFile::parse_control_file(pghs.paragraphs());
+            Assert::IsTrue(m_pgh.has_value());
+            auto& pgh = *m_pgh.get();
+
+            Assert::AreEqual("s", pgh->core_paragraph->name.c_str());
+            Assert::AreEqual(size_t(2), pgh->core_paragraph->depends.size());
+            Assert::AreEqual(size_t(1), pgh->feature_paragraphs.size());
+            Assert::AreEqual("d", pgh->feature_paragraphs[0]->description.c_str());
+        }
+
         TEST_METHOD(BinaryParagraph_serialize_min)
         {
             vcpkg::BinaryParagraph pgh({
@@ -78,5 +78,52 @@ Status: purge ok not-installed
             auto it = status_db.find_installed(unsafe_pspec("ffmpeg", Triplet::X64_WINDOWS));
             Assert::IsTrue(it != status_db.end());
         }
+
+        TEST_METHOD(insert_replaces_existing_paragraph)
+        {
+            auto pghs = parse_paragraphs(R"(
+Package: ffmpeg
+Version: 3.3.3
+Architecture: x64-windows
+Multi-Arch: same
+Description:
+Status: install ok installed
+
+Package: ffmpeg
+Feature: openssl
+Depends: openssl
+Architecture: x64-windows
+Multi-Arch: same
+Description:
+Status: install ok installed
+
+Package: zlib
+Version: 1.2.11
+Architecture: x64-windows
+Multi-Arch: same
+Description:
+Status: purge ok not-installed
+)");
+            Assert::IsTrue(!!pghs);
+            if (!pghs) return;
+
+            auto& raw_pghs = *pghs.get();
+            StatusParagraphs status_db(Util::fmap(
+                raw_pghs, [](RawParagraph& rpgh) { return std::make_unique<StatusParagraph>(RawParagraph(rpgh)); }));
+
+            auto zlib = std::make_unique<StatusParagraph>(RawParagraph(raw_pghs[2]));
+            zlib->want = Want::INSTALL;
+            zlib->state = InstallState::INSTALLED;
+            status_db.insert(std::move(zlib));
+
+            Assert::IsTrue(status_db.is_installed(unsafe_pspec("zlib", Triplet::X64_WINDOWS)));
+            Assert::AreEqual(size_t(2), status_db.find_all("ffmpeg", Triplet::X64_WINDOWS).size());
+            Assert::IsTrue(status_db.find("ffmpeg", Triplet::X64_WINDOWS, "openssl") != status_db.end());
+            Assert::IsTrue(status_db.find("ffmpeg", Triplet::X86_WINDOWS) == status_db.end());
+
+            // The replaced paragraph keeps its position
+            Assert::AreEqual(size_t(3), static_cast<size_t>(std::distance(status_db.begin(), status_db.end())));
+            Assert::AreEqual("zlib", (*status_db.begin())->package.spec.name().c_str());
+        }
     };
 }
@@ -18,6 +18,7 @@
 #include <vcpkg/globalstate.h>
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
+#include <vcpkg/install.h>
 #include <vcpkg/metrics.h>
 #include <vcpkg/paragraphs.h>
 #include <vcpkg/userconfig.h>
@@ -109,6 +110,15 @@ static void inner(const VcpkgCmdArguments& args)
 #endif
     Checks::check_exit(VCPKG_LINE_INFO, exit_code == 0, "Changing the working dir failed");
 
+    if (args.max_cpus != nullptr)
+    {
+        GlobalState::max_cpus = Install::parse_jobs(*args.max_cpus);
+    }
+    if (args.max_memory != nullptr)
+    {
+        GlobalState::max_memory_bytes = Install::parse_memory_size(*args.max_memory);
+    }
+
     if (args.command != "autocomplete")
     {
         Commands::Version::warn_if_vcpkg_version_mismatch(paths);
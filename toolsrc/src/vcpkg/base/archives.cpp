@@ -0,0 +1,1015 @@
+#include "pch.h"
+
+#include <vcpkg/base/archives.h>
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/inflate.h>
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+
+namespace vcpkg::Archives
+{
+    ArchiveFormat detect_format(const char* data, size_t size)
+    {
+        static const size_t USTAR_MAGIC_OFFSET = 257;
+
+        const auto starts_with = [&](const char* magic, size_t magic_size) {
+            return size >= magic_size && memcmp(data, magic, magic_size) == 0;
+        };
+
+        // Only gzip with the deflate method (8) can be decoded
+        if (starts_with("\x1f\x8b\x08", 3)) return ArchiveFormat::GZIP_TAR;
+        // An empty zip file is only an end of central directory record
+        if (starts_with("PK\x03\x04", 4) || starts_with("PK\x05\x06", 4)) return ArchiveFormat::ZIP;
+        if (size >= 512 && memcmp(data + USTAR_MAGIC_OFFSET, "ustar", 5) == 0) return ArchiveFormat::TAR;
+        return ArchiveFormat::OTHER;
+    }
+
+    /// <summary>
+    /// Turns the name of an archive member into a path relative to the destination. Returns an empty path for the
+    /// destination itself, and exits for names that would escape it.
+    /// </summary>
+    static fs::path to_relative_path(const std::string& name, const std::string& label)
+    {
+#if defined(_WIN32)
+        static const char SEPARATORS[] = "/\\";
+#else
+        static const char SEPARATORS[] = "/";
+#endif
+
+        fs::path ret;
+        bool is_absolute = !name.empty() && strchr(SEPARATORS, name[0]) != nullptr;
+        for (size_t begin = 0; begin <= name.size();)
+        {
+            const size_t end = std::min(name.find_first_of(SEPARATORS, begin), name.size());
+            const std::string part = name.substr(begin, end - begin);
+#if defined(_WIN32)
+            // A drive letter
+            is_absolute = is_absolute || part.find(':') != std::string::npos;
+#endif
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               !is_absolute && part != "..",
+                               "Refusing to extract %s from %s, because it is outside the destination",
+                               name,
+                               label);
+            if (!part.empty() && part != ".") ret /= fs::u8path(part);
+            begin = end + 1;
+        }
+
+        return ret;
+    }
+
+    /// <summary>
+    /// Converts the Unix times stored in archives to file times, which may count from a different epoch. Files keep
+    /// the exact times of the archive, whose relative order build systems like autotools depend on.
+    /// </summary>
+    struct FileTimes
+    {
+        FileTimes()
+        {
+            using std::chrono::duration_cast;
+            using std::chrono::microseconds;
+
+            const auto file_now = duration_cast<microseconds>(fs::file_time_type::clock::now().time_since_epoch());
+            const auto system_now = duration_cast<microseconds>(std::chrono::system_clock::now().time_since_epoch());
+            // The epochs differ by whole seconds, so rounding drops the time that passed between the two calls
+            epoch_offset = std::chrono::round<std::chrono::seconds>(file_now - system_now);
+        }
+
+        fs::file_time_type from_unix_time(int64_t seconds) const
+        {
+            return fs::file_time_type(std::chrono::duration_cast<fs::file_time_type::duration>(
+                std::chrono::seconds(seconds) + epoch_offset));
+        }
+
+        std::chrono::seconds epoch_offset;
+    };
+
+    struct FileAttributes
+    {
+        bool executable = false;
+        int64_t mtime = 0;
+    };
+
+    static void apply_attributes(const fs::path& path, const FileAttributes& attributes, const FileTimes& times)
+    {
+        std::error_code ec;
+#if !defined(_WIN32)
+        if (attributes.executable)
+        {
+            using fs::stdfs::perms;
+            fs::stdfs::permissions(
+                path, perms::owner_exec | perms::group_exec | perms::others_exec | perms::add_perms, ec);
+        }
+#endif
+        // The times are a courtesy; a file system that cannot store them must not fail the extraction
+        fs::stdfs::last_write_time(path, times.from_unix_time(attributes.mtime), ec);
+    }
+
+    static void check_stream(const std::ofstream& out, const fs::path& path)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, out.good(), "Failed to write %s", path.u8string());
+    }
+
+    struct ExtractedFile
+    {
+        fs::path path;
+        std::string contents;
+        FileAttributes attributes;
+    };
+
+    /// <summary>
+    /// Writes small files in batches on a background thread, so that writing overlaps decoding the next batch. The
+    /// files of a batch are written in parallel.
+    /// </summary>
+    class BatchWriter
+    {
+    public:
+        static const size_t BATCH_BYTES = 32 * 1024 * 1024;
+        static const size_t BATCH_FILES = 4096;
+
+        explicit BatchWriter(const FileTimes& times) : m_times(times) {}
+        BatchWriter(const BatchWriter&) = delete;
+        BatchWriter& operator=(const BatchWriter&) = delete;
+        ~BatchWriter() { wait(); }
+
+        void add(ExtractedFile&& file)
+        {
+            // Writing the same path twice in one batch would race
+            std::string key = file.path.generic_u8string();
+            if (m_batch_paths.count(key) != 0) flush();
+            m_batch_paths.insert(std::move(key));
+
+            m_batch_bytes += file.contents.size();
+            m_batch.push_back(std::move(file));
+            if (m_batch_bytes >= BATCH_BYTES || m_batch.size() >= BATCH_FILES) flush();
+        }
+
+        /// <summary>
+        /// Starts writing the pending files once the previous batch is done
+        /// </summary>
+        void flush()
+        {
+            wait();
+            if (m_batch.empty()) return;
+
+            m_thread = std::thread([this, batch = std::move(m_batch)]() {
+                Util::parallel_for(batch.size(), [&](const size_t i) { write(batch[i]); });
+            });
+            m_batch.clear();
+            m_batch_paths.clear();
+            m_batch_bytes = 0;
+        }
+
+        /// <summary>
+        /// Writes everything added so far before returning
+        /// </summary>
+        void drain()
+        {
+            flush();
+            wait();
+        }
+
+    private:
+        void wait()
+        {
+            if (m_thread.joinable()) m_thread.join();
+        }
+
+        void write(const ExtractedFile& file) const
+        {
+            {
+                std::ofstream out(file.path, std::ios::binary | std::ios::trunc);
+                out.write(file.contents.data(), static_cast<std::streamsize>(file.contents.size()));
+                out.close();
+                check_stream(out, file.path);
+            }
+
+            apply_attributes(file.path, file.attributes, m_times);
+        }
+
+        const FileTimes& m_times;
+        std::vector<ExtractedFile> m_batch;
+        std::unordered_set<std::string> m_batch_paths;
+        size_t m_batch_bytes = 0;
+        std::thread m_thread;
+    };
+
+    struct Link
+    {
+        fs::path path;
+        std::string target;
+        bool is_hard_link;
+    };
+
+    /// <summary>
+    /// Links are created after every file, so that no file is ever written through a link from the archive. Where
+    /// symbolic links cannot be created, such as on Windows without developer mode, the target file is copied.
+    /// </summary>
+    static void create_links(Files::Filesystem& fs,
+                             const fs::path& destination,
+                             const std::vector<Link>& links,
+                             const std::string& label)
+    {
+        for (const Link& link : links)
+        {
+            const fs::path path = destination / link.path;
+            std::error_code ec;
+            fs.remove(path, ec);
+
+            fs::path target;
+            if (link.is_hard_link)
+            {
+                target = destination / to_relative_path(link.target, label);
+                fs.create_hard_link(target, path, ec);
+            }
+            else
+            {
+                target = path.parent_path() / fs::u8path(link.target);
+                fs::stdfs::create_symlink(fs::u8path(link.target), path, ec);
+            }
+
+            if (ec && fs.is_regular_file(target))
+            {
+                fs.copy_file(target, path, fs::copy_options::overwrite_existing, ec);
+            }
+
+            if (ec)
+            {
+                System::println(System::Color::warning,
+                                "Warning: Could not create %s -> %s from %s: %s",
+                                link.path.generic_u8string(),
+                                link.target,
+                                label,
+                                ec.message());
+            }
+        }
+    }
+
+    /// <summary>
+    /// Parses a numeric field of a tar header: octal padded with spaces or NULs, or base-256 for values too large
+    /// for the field
+    /// </summary>
+    static uint64_t parse_tar_number(const char* field, const size_t size)
+    {
+        const auto bytes = reinterpret_cast<const unsigned char*>(field);
+        uint64_t value = 0;
+        if (bytes[0] & 0x80)
+        {
+            value = bytes[0] & 0x7f;
+            for (size_t i = 1; i < size; ++i)
+                value = (value << 8) | bytes[i];
+            return value;
+        }
+
+        size_t i = 0;
+        while (i < size && (field[i] == ' ' || field[i] == '\0'))
+            ++i;
+        for (; i < size && field[i] >= '0' && field[i] <= '7'; ++i)
+            value = value * 8 + static_cast<uint64_t>(field[i] - '0');
+        return value;
+    }
+
+    static std::string read_tar_string(const char* field, const size_t size)
+    {
+        const void* end = memchr(field, '\0', size);
+        return std::string(field, end ? static_cast<const char*>(end) : field + size);
+    }
+
+    /// <summary>
+    /// Extracts a tar stream that arrives in pieces of any size, such as the output of a decompressor
+    /// </summary>
+    class TarReader
+    {
+    public:
+        TarReader(Files::Filesystem& fs, const fs::path& destination, const FileTimes& times, const std::string& label)
+            : m_fs(fs), m_destination(destination), m_times(times), m_writer(times), m_label(label)
+        {
+        }
+
+        void feed(const char* data, size_t size)
+        {
+            while (size != 0 && m_state != State::END)
+            {
+                size_t count = 0;
+                switch (m_state)
+                {
+                    case State::HEADER:
+                        count = std::min(size, BLOCK_SIZE - m_header_size);
+                        memcpy(m_header + m_header_size, data, count);
+                        m_header_size += count;
+                        if (m_header_size == BLOCK_SIZE)
+                        {
+                            m_header_size = 0;
+                            read_header();
+                        }
+                        break;
+                    case State::DATA:
+                        count = static_cast<size_t>(std::min<uint64_t>(size, m_remaining));
+                        add_entry_data(data, count);
+                        m_remaining -= count;
+                        if (m_remaining == 0) end_entry();
+                        break;
+                    case State::PADDING:
+                        count = std::min(size, m_padding);
+                        m_padding -= count;
+                        if (m_padding == 0) m_state = State::HEADER;
+                        break;
+                    default: Checks::unreachable(VCPKG_LINE_INFO);
+                }
+
+                data += count;
+                size -= count;
+            }
+        }
+
+        /// <summary>
+        /// Checks that the archive ended after a whole member, and finishes writing it
+        /// </summary>
+        void finish()
+        {
+            // Some writers leave out the two zero blocks that should end the archive
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               m_state == State::END || (m_state == State::HEADER && m_header_size == 0),
+                               "Unexpected end of archive %s",
+                               m_label);
+            m_writer.drain();
+            create_links(m_fs, m_destination, m_links, m_label);
+        }
+
+    private:
+        static constexpr size_t BLOCK_SIZE = 512;
+        // Files above this size are written while they are decoded, instead of being held in memory for a batch
+        static constexpr uint64_t LARGE_FILE_SIZE = 16 * 1024 * 1024;
+        static constexpr uint64_t MAX_METADATA_SIZE = 1024 * 1024;
+
+        enum class State
+        {
+            HEADER,
+            DATA,
+            PADDING,
+            END,
+        };
+
+        enum class EntryKind
+        {
+            FILE,
+            LARGE_FILE,
+            LONG_NAME,
+            LONG_LINK_NAME,
+            PAX_HEADER,
+            SKIPPED,
+        };
+
+        bool verify_checksum() const
+        {
+            static const size_t CHECKSUM_OFFSET = 148;
+            static const size_t CHECKSUM_SIZE = 8;
+
+            // The checksum field counts as spaces. Some old writers summed signed chars.
+            uint64_t unsigned_sum = 0;
+            int64_t signed_sum = 0;
+            for (size_t i = 0; i < BLOCK_SIZE; ++i)
+            {
+                const bool in_field = i >= CHECKSUM_OFFSET && i < CHECKSUM_OFFSET + CHECKSUM_SIZE;
+                const char c = in_field ? ' ' : m_header[i];
+                unsigned_sum += static_cast<unsigned char>(c);
+                signed_sum += static_cast<signed char>(c);
+            }
+
+            const uint64_t expected = parse_tar_number(m_header + CHECKSUM_OFFSET, CHECKSUM_SIZE);
+            return expected == unsigned_sum || static_cast<int64_t>(expected) == signed_sum;
+        }
+
+        void read_header()
+        {
+            if (std::all_of(m_header, m_header + BLOCK_SIZE, [](char c) { return c == '\0'; }))
+            {
+                m_state = State::END;
+                return;
+            }
+
+            Checks::check_exit(VCPKG_LINE_INFO, verify_checksum(), "Invalid tar header in %s", m_label);
+
+            const char type = m_header[156];
+            uint64_t size = parse_tar_number(m_header + 124, 12);
+            m_attributes.mtime = static_cast<int64_t>(parse_tar_number(m_header + 136, 12));
+            m_attributes.executable = (parse_tar_number(m_header + 100, 8) & 0111) != 0;
+
+            std::string name = read_tar_string(m_header, 100);
+            const bool is_ustar = memcmp(m_header + 257, "ustar", 5) == 0;
+            if (is_ustar && m_header[345] != '\0')
+            {
+                name = read_tar_string(m_header + 345, 155) + '/' + name;
+            }
+
+            std::string link_name = read_tar_string(m_header + 157, 100);
+
+            // Extended names and attributes from the preceding members apply to this member only
+            if (!m_long_name.empty()) name = std::move(m_long_name);
+            if (!m_long_link_name.empty()) link_name = std::move(m_long_link_name);
+            for (auto&& record : m_pax_records)
+            {
+                if (record.first == "path") name = record.second;
+                if (record.first == "linkpath") link_name = record.second;
+                if (record.first == "size") size = std::strtoull(record.second.c_str(), nullptr, 10);
+                if (record.first == "mtime") m_attributes.mtime = std::strtoll(record.second.c_str(), nullptr, 10);
+            }
+
+            m_long_name.clear();
+            m_long_link_name.clear();
+            m_pax_records.clear();
+
+            m_kind = EntryKind::SKIPPED;
+            m_path = to_relative_path(name, m_label);
+            switch (type)
+            {
+                case '0':
+                case '\0':
+                case '7':
+                    if (m_path.empty()) break;
+                    ensure_directory(m_path.parent_path());
+                    if (size > LARGE_FILE_SIZE)
+                    {
+                        // A batch may still be writing an earlier copy of this file
+                        m_writer.drain();
+                        m_kind = EntryKind::LARGE_FILE;
+                        m_large_file.open(m_destination / m_path, std::ios::binary | std::ios::trunc);
+                        check_stream(m_large_file, m_destination / m_path);
+                    }
+                    else
+                    {
+                        m_kind = EntryKind::FILE;
+                        m_data.reserve(static_cast<size_t>(size));
+                    }
+                    break;
+                case '5': ensure_directory(m_path); break;
+                case '1':
+                case '2':
+                    if (!m_path.empty())
+                    {
+                        ensure_directory(m_path.parent_path());
+                        m_links.push_back({m_path, link_name, type == '1'});
+                    }
+                    // Hard links may carry the size of their target, but never its contents
+                    size = 0;
+                    break;
+                case 'L': m_kind = EntryKind::LONG_NAME; break;
+                case 'K': m_kind = EntryKind::LONG_LINK_NAME; break;
+                case 'x': m_kind = EntryKind::PAX_HEADER; break;
+                // Global pax headers ('g'), devices and fifos are not extracted
+                default: break;
+            }
+
+            if (m_kind == EntryKind::LONG_NAME || m_kind == EntryKind::LONG_LINK_NAME ||
+                m_kind == EntryKind::PAX_HEADER)
+            {
+                Checks::check_exit(
+                    VCPKG_LINE_INFO, size <= MAX_METADATA_SIZE, "Invalid extended tar header in %s", m_label);
+            }
+
+            m_remaining = size;
+            m_padding = static_cast<size_t>((BLOCK_SIZE - size % BLOCK_SIZE) % BLOCK_SIZE);
+            if (size == 0)
+            {
+                end_entry();
+            }
+            else
+            {
+                m_state = State::DATA;
+            }
+        }
+
+        void add_entry_data(const char* data, const size_t size)
+        {
+            switch (m_kind)
+            {
+                case EntryKind::LARGE_FILE:
+                    m_large_file.write(data, static_cast<std::streamsize>(size));
+                    check_stream(m_large_file, m_destination / m_path);
+                    break;
+                case EntryKind::SKIPPED: break;
+                default: m_data.append(data, size); break;
+            }
+        }
+
+        void end_entry()
+        {
+            switch (m_kind)
+            {
+                case EntryKind::FILE:
+                    m_writer.add({m_destination / m_path, std::move(m_data), m_attributes});
+                    m_data = std::string();
+                    break;
+                case EntryKind::LARGE_FILE:
+                    m_large_file.close();
+                    check_stream(m_large_file, m_destination / m_path);
+                    m_large_file.clear();
+                    apply_attributes(m_destination / m_path, m_attributes, m_times);
+                    break;
+                case EntryKind::LONG_NAME: m_long_name = read_tar_string(m_data.data(), m_data.size()); break;
+                case EntryKind::LONG_LINK_NAME:
+                    m_long_link_name = read_tar_string(m_data.data(), m_data.size());
+                    break;
+                case EntryKind::PAX_HEADER: read_pax_records(); break;
+                case EntryKind::SKIPPED: break;
+                default: Checks::unreachable(VCPKG_LINE_INFO);
+            }
+
+            m_data.clear();
+            m_state = m_padding == 0 ? State::HEADER : State::PADDING;
+        }
+
+        /// <summary>
+        /// Reads records of the form "<length> <key>=<value>\n", where the length counts the whole record
+        /// </summary>
+        void read_pax_records()
+        {
+            for (size_t position = 0; position < m_data.size();)
+            {
+                const size_t space = m_data.find(' ', position);
+                const size_t length = static_cast<size_t>(std::strtoull(m_data.c_str() + position, nullptr, 10));
+                const size_t end = position + length;
+                const size_t equals = m_data.find('=', space);
+                Checks::check_exit(VCPKG_LINE_INFO,
+                                   space != std::string::npos && length != 0 && end <= m_data.size() &&
+                                       equals < end && m_data[end - 1] == '\n',
+                                   "Invalid pax header in %s",
+                                   m_label);
+                m_pax_records.emplace_back(m_data.substr(space + 1, equals - space - 1),
+                                           m_data.substr(equals + 1, end - 1 - (equals + 1)));
+                position = end;
+            }
+        }
+
+        void ensure_directory(const fs::path& directory)
+        {
+            if (directory.empty() || !m_created_directories.insert(directory.generic_u8string()).second) return;
+
+            std::error_code ec;
+            m_fs.create_directories(m_destination / directory, ec);
+            Checks::check_exit(
+                VCPKG_LINE_INFO, !ec, "Failed to create %s: %s", (m_destination / directory).u8string(), ec.message());
+        }
+
+        Files::Filesystem& m_fs;
+        const fs::path& m_destination;
+        const FileTimes& m_times;
+        BatchWriter m_writer;
+        const std::string& m_label;
+
+        State m_state = State::HEADER;
+        char m_header[BLOCK_SIZE];
+        size_t m_header_size = 0;
+        uint64_t m_remaining = 0;
+        size_t m_padding = 0;
+
+        EntryKind m_kind = EntryKind::SKIPPED;
+        fs::path m_path;
+        FileAttributes m_attributes;
+        std::string m_data;
+        std::ofstream m_large_file;
+
+        std::string m_long_name;
+        std::string m_long_link_name;
+        std::vector<std::pair<std::string, std::string>> m_pax_records;
+
+        std::unordered_set<std::string> m_created_directories;
+        std::vector<Link> m_links;
+    };
+
+    /// <summary>
+    /// Bounds-checked little-endian reads from an archive mapped into memory
+    /// </summary>
+    struct ZipView
+    {
+        const char* at(const uint64_t offset, const uint64_t count) const
+        {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               offset <= size && count <= size - offset,
+                               "Unexpected end of archive %s",
+                               label);
+            return data + offset;
+        }
+
+        uint16_t read_u16(const uint64_t offset) const
+        {
+            const auto bytes = reinterpret_cast<const unsigned char*>(at(offset, 2));
+            return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+        }
+
+        uint32_t read_u32(const uint64_t offset) const
+        {
+            const auto bytes = reinterpret_cast<const unsigned char*>(at(offset, 4));
+            return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) | (uint32_t(bytes[2]) << 16) |
+                   (uint32_t(bytes[3]) << 24);
+        }
+
+        uint64_t read_u64(const uint64_t offset) const
+        {
+            return uint64_t(read_u32(offset)) | (uint64_t(read_u32(offset + 4)) << 32);
+        }
+
+        const char* data;
+        uint64_t size;
+        const std::string& label;
+    };
+
+    /// <summary>
+    /// Hashes the archive up to a point, as the decoder gets there
+    /// </summary>
+    struct IncrementalHasher
+    {
+        void hash_to(const size_t end)
+        {
+            if (hasher && end > hashed) hasher->add_bytes(data + hashed, end - hashed);
+            hashed = std::max(hashed, end);
+        }
+
+        Hash::Hasher* hasher;
+        const char* data;
+        size_t hashed;
+    };
+
+    static void extract_tar(TarReader& reader, const char* data, const size_t size, IncrementalHasher& hash)
+    {
+        static const size_t CHUNK_SIZE = 1024 * 1024;
+
+        for (size_t offset = 0; offset < size; offset += CHUNK_SIZE)
+        {
+            const size_t count = std::min(CHUNK_SIZE, size - offset);
+            hash.hash_to(offset + count);
+            reader.feed(data + offset, count);
+        }
+    }
+
+    /// <summary>
+    /// Returns the offset of the deflate data of the gzip member at the offset (RFC 1952)
+    /// </summary>
+    static size_t skip_gzip_header(const char* data, const size_t size, size_t offset, const std::string& label)
+    {
+        static const size_t HEADER_SIZE = 10;
+        static const unsigned char FHCRC = 0x02;
+        static const unsigned char FEXTRA = 0x04;
+        static const unsigned char FNAME = 0x08;
+        static const unsigned char FCOMMENT = 0x10;
+
+        const auto check_available = [&](const size_t count) {
+            Checks::check_exit(VCPKG_LINE_INFO, count <= size - offset, "Unexpected end of archive %s", label);
+        };
+
+        check_available(HEADER_SIZE);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           memcmp(data + offset, "\x1f\x8b\x08", 3) == 0,
+                           "Invalid gzip header in %s",
+                           label);
+        const auto flags = static_cast<unsigned char>(data[offset + 3]);
+        offset += HEADER_SIZE;
+
+        if (flags & FEXTRA)
+        {
+            check_available(2);
+            const auto bytes = reinterpret_cast<const unsigned char*>(data + offset);
+            const size_t extra_size = bytes[0] | (bytes[1] << 8);
+            check_available(2 + extra_size);
+            offset += 2 + extra_size;
+        }
+
+        for (const unsigned char string_flag : {FNAME, FCOMMENT})
+        {
+            if ((flags & string_flag) == 0) continue;
+            const void* end = memchr(data + offset, '\0', size - offset);
+            Checks::check_exit(VCPKG_LINE_INFO, end != nullptr, "Unexpected end of archive %s", label);
+            offset = static_cast<size_t>(static_cast<const char*>(end) - data) + 1;
+        }
+
+        if (flags & FHCRC)
+        {
+            check_available(2);
+            offset += 2;
+        }
+
+        return offset;
+    }
+
+    static void extract_gzip_tar(TarReader& reader,
+                                 const char* data,
+                                 const size_t size,
+                                 IncrementalHasher& hash,
+                                 const std::string& label)
+    {
+        static const size_t TRAILER_SIZE = 8;
+
+        // A gzip file may hold several members, whose contents are concatenated
+        size_t offset = 0;
+        do
+        {
+            offset = skip_gzip_header(data, size, offset, label);
+            Inflate::Inflater inflater(data + offset, size - offset, label);
+            uint32_t crc = 0;
+            uint64_t total_size = 0;
+            const char* output;
+            size_t output_size;
+            while (inflater.next(output, output_size))
+            {
+                hash.hash_to(offset + inflater.consumed());
+                crc = Inflate::crc32(crc, output, output_size);
+                total_size += output_size;
+                reader.feed(output, output_size);
+            }
+
+            offset += inflater.consumed();
+            Checks::check_exit(VCPKG_LINE_INFO, TRAILER_SIZE <= size - offset, "Unexpected end of archive %s", label);
+            const ZipView trailer{data + offset, TRAILER_SIZE, label};
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               crc == trailer.read_u32(0) && static_cast<uint32_t>(total_size) == trailer.read_u32(4),
+                               "Corrupt data in archive %s",
+                               label);
+            offset += TRAILER_SIZE;
+        } while (size - offset >= 3 && memcmp(data + offset, "\x1f\x8b\x08", 3) == 0);
+    }
+
+    struct ZipEntry
+    {
+        std::string name;
+        fs::path path;
+        uint16_t method;
+        uint32_t crc;
+        uint64_t compressed_size;
+        uint64_t size;
+        uint64_t local_header_offset;
+        bool is_directory;
+        bool is_symlink;
+        FileAttributes attributes;
+    };
+
+    static int64_t from_dos_time(const uint16_t date, const uint16_t time)
+    {
+        std::tm tm{};
+        tm.tm_year = ((date >> 9) & 0x7f) + 80;
+        tm.tm_mon = ((date >> 5) & 0xf) - 1;
+        tm.tm_mday = date & 0x1f;
+        tm.tm_hour = time >> 11;
+        tm.tm_min = (time >> 5) & 0x3f;
+        tm.tm_sec = (time & 0x1f) * 2;
+        tm.tm_isdst = -1;
+        return static_cast<int64_t>(std::mktime(&tm));
+    }
+
+    /// <summary>
+    /// Finds the central directory through the end of central directory record, and its zip64 form if present
+    /// </summary>
+    static std::pair<uint64_t, uint64_t> find_central_directory(const ZipView& view)
+    {
+        static const uint32_t EOCD_SIGNATURE = 0x06054b50;
+        static const uint64_t EOCD_SIZE = 22;
+        static const uint64_t MAX_COMMENT_SIZE = 0xffff;
+        static const uint32_t ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+        static const uint64_t ZIP64_LOCATOR_SIZE = 20;
+        static const uint32_t ZIP64_EOCD_SIGNATURE = 0x06064b50;
+
+        Checks::check_exit(VCPKG_LINE_INFO, view.size >= EOCD_SIZE, "Invalid zip file %s", view.label);
+        const uint64_t lowest = view.size - std::min(view.size, EOCD_SIZE + MAX_COMMENT_SIZE);
+        uint64_t eocd = view.size - EOCD_SIZE;
+        while (view.read_u32(eocd) != EOCD_SIGNATURE)
+        {
+            Checks::check_exit(VCPKG_LINE_INFO, eocd > lowest, "Invalid zip file %s", view.label);
+            --eocd;
+        }
+
+        uint64_t entry_count = view.read_u16(eocd + 10);
+        uint64_t directory_offset = view.read_u32(eocd + 16);
+        if (eocd >= ZIP64_LOCATOR_SIZE && view.read_u32(eocd - ZIP64_LOCATOR_SIZE) == ZIP64_LOCATOR_SIGNATURE)
+        {
+            const uint64_t zip64_eocd = view.read_u64(eocd - ZIP64_LOCATOR_SIZE + 8);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               view.read_u32(zip64_eocd) == ZIP64_EOCD_SIGNATURE,
+                               "Invalid zip file %s",
+                               view.label);
+            entry_count = view.read_u64(zip64_eocd + 32);
+            directory_offset = view.read_u64(zip64_eocd + 48);
+        }
+
+        return {directory_offset, entry_count};
+    }
+
+    /// <summary>
+    /// Returns nullopt if any entry needs an external tool
+    /// </summary>
+    static Optional<std::vector<ZipEntry>> read_central_directory(const ZipView& view)
+    {
+        static const uint32_t HEADER_SIGNATURE = 0x02014b50;
+        static const uint64_t HEADER_SIZE = 46;
+        static const uint16_t ZIP64_EXTRA = 0x0001;
+        static const uint16_t EXTENDED_TIMESTAMP_EXTRA = 0x5455;
+        static const uint32_t ZIP64_MARKER = 0xffffffff;
+        static const unsigned HOST_UNIX = 3;
+        static const unsigned HOST_OSX = 19;
+        static const uint32_t UNIX_FILE_TYPE = 0170000;
+        static const uint32_t UNIX_SYMLINK = 0120000;
+
+        const auto directory = find_central_directory(view);
+        std::vector<ZipEntry> entries;
+        uint64_t offset = directory.first;
+        for (uint64_t i = 0; i < directory.second; ++i)
+        {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               view.read_u32(offset) == HEADER_SIGNATURE,
+                               "Invalid zip file %s",
+                               view.label);
+            const uint16_t name_size = view.read_u16(offset + 28);
+            const uint16_t extra_size = view.read_u16(offset + 30);
+            const uint16_t comment_size = view.read_u16(offset + 32);
+
+            ZipEntry entry;
+            entry.name = std::string(view.at(offset + HEADER_SIZE, name_size), name_size);
+            const unsigned host = view.read_u16(offset + 4) >> 8;
+            const uint16_t flags = view.read_u16(offset + 8);
+            entry.method = view.read_u16(offset + 10);
+            entry.crc = view.read_u32(offset + 16);
+            entry.compressed_size = view.read_u32(offset + 20);
+            entry.size = view.read_u32(offset + 24);
+            entry.local_header_offset = view.read_u32(offset + 42);
+            entry.attributes.mtime = from_dos_time(view.read_u16(offset + 14), view.read_u16(offset + 12));
+
+            // Encrypted entries and methods other than stored and deflated are left to an external tool
+            if ((flags & 1) != 0 || (entry.method != 0 && entry.method != 8)) return nullopt;
+
+            const uint32_t unix_mode = (host == HOST_UNIX || host == HOST_OSX) ? view.read_u32(offset + 38) >> 16 : 0;
+            entry.is_symlink = (unix_mode & UNIX_FILE_TYPE) == UNIX_SYMLINK;
+            entry.attributes.executable = (unix_mode & 0111) != 0;
+            entry.is_directory = !entry.name.empty() && entry.name.back() == '/';
+
+            uint64_t extra = offset + HEADER_SIZE + name_size;
+            const uint64_t extra_end = extra + extra_size;
+            while (extra + 4 <= extra_end)
+            {
+                const uint16_t id = view.read_u16(extra);
+                const uint16_t size = view.read_u16(extra + 2);
+                uint64_t field = extra + 4;
+                if (id == ZIP64_EXTRA)
+                {
+                    // Only the values that overflowed their 32-bit fields are present, in this order
+                    for (uint64_t* value : {&entry.size, &entry.compressed_size, &entry.local_header_offset})
+                    {
+                        if (*value != ZIP64_MARKER) continue;
+                        *value = view.read_u64(field);
+                        field += 8;
+                    }
+                }
+                else if (id == EXTENDED_TIMESTAMP_EXTRA && size >= 5 && (*view.at(field, 1) & 1))
+                {
+                    entry.attributes.mtime = static_cast<int32_t>(view.read_u32(field + 1));
+                }
+
+                extra += 4 + size;
+            }
+
+            entry.path = to_relative_path(entry.name, view.label);
+            entries.push_back(std::move(entry));
+            offset += HEADER_SIZE + name_size + extra_size + comment_size;
+        }
+
+        return entries;
+    }
+
+    /// <summary>
+    /// Decodes one entry, passing its contents to the callback piece by piece, and checks its size and CRC
+    /// </summary>
+    template<class Callback>
+    static void decode_zip_entry(const ZipView& view, const ZipEntry& entry, Callback&& callback)
+    {
+        static const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+        static const uint64_t LOCAL_HEADER_SIZE = 30;
+
+        const std::string label = view.label + ": " + entry.name;
+        const uint64_t header = entry.local_header_offset;
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           view.read_u32(header) == LOCAL_HEADER_SIGNATURE,
+                           "Invalid zip file %s",
+                           label);
+        const uint64_t data_offset =
+            header + LOCAL_HEADER_SIZE + view.read_u16(header + 26) + uint64_t(view.read_u16(header + 28));
+        const char* data = view.at(data_offset, entry.compressed_size);
+
+        uint32_t crc = 0;
+        uint64_t size = 0;
+        const auto add_output = [&](const char* output, const size_t output_size) {
+            crc = Inflate::crc32(crc, output, output_size);
+            size += output_size;
+            callback(output, output_size);
+        };
+
+        if (entry.method == 0)
+        {
+            add_output(data, static_cast<size_t>(entry.compressed_size));
+        }
+        else
+        {
+            Inflate::Inflater inflater(data, static_cast<size_t>(entry.compressed_size), label);
+            const char* output;
+            size_t output_size;
+            while (inflater.next(output, output_size))
+                add_output(output, output_size);
+        }
+
+        Checks::check_exit(
+            VCPKG_LINE_INFO, crc == entry.crc && size == entry.size, "Corrupt data in archive %s", label);
+    }
+
+    static bool extract_zip(Files::Filesystem& fs,
+                            const ZipView& view,
+                            const fs::path& destination,
+                            const FileTimes& times,
+                            Hash::Hasher* hasher)
+    {
+        const Optional<std::vector<ZipEntry>> maybe_entries = read_central_directory(view);
+        const auto entries = maybe_entries.get();
+        if (entries == nullptr) return false;
+
+        // Hash the whole file alongside the extraction, since entries are not stored in the order they are read
+        std::thread hash_thread;
+        if (hasher) hash_thread = std::thread([&]() { hasher->add_bytes(view.data, static_cast<size_t>(view.size)); });
+
+        // When a path appears more than once, the last entry wins, as with unzip
+        std::map<std::string, size_t> last_entry_of_path;
+        for (size_t i = 0; i < entries->size(); ++i)
+        {
+            const fs::path& path = (*entries)[i].path;
+            if (!path.empty()) last_entry_of_path[path.generic_u8string()] = i;
+        }
+
+        std::vector<const ZipEntry*> files;
+        std::vector<Link> links;
+        std::error_code ec;
+        for (auto&& path_and_entry : last_entry_of_path)
+        {
+            const ZipEntry& entry = (*entries)[path_and_entry.second];
+            const fs::path path = destination / entry.path;
+            fs.create_directories(entry.is_directory ? path : path.parent_path(), ec);
+            Checks::check_exit(VCPKG_LINE_INFO, !ec, "Failed to create %s: %s", path.u8string(), ec.message());
+            if (entry.is_directory) continue;
+
+            if (entry.is_symlink)
+            {
+                std::string target;
+                decode_zip_entry(view, entry, [&](const char* output, size_t size) { target.append(output, size); });
+                links.push_back({entry.path, std::move(target), false});
+            }
+            else
+            {
+                files.push_back(&entry);
+            }
+        }
+
+        Util::parallel_for(files.size(), [&](const size_t i) {
+            const ZipEntry& entry = *files[i];
+            const fs::path path = destination / entry.path;
+            {
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                decode_zip_entry(view, entry, [&](const char* output, size_t size) {
+                    out.write(output, static_cast<std::streamsize>(size));
+                });
+                out.close();
+                check_stream(out, path);
+            }
+
+            apply_attributes(path, entry.attributes, times);
+        });
+
+        create_links(fs, destination, links, view.label);
+        if (hash_thread.joinable()) hash_thread.join();
+        return true;
+    }
+
+    bool extract(Files::Filesystem& fs,
+                 const Files::MappedFile& archive,
+                 ArchiveFormat format,
+                 const fs::path& destination,
+                 Hash::Hasher* hasher,
+                 const std::string& label)
+    {
+        const FileTimes times;
+        if (format == ArchiveFormat::ZIP)
+        {
+            return extract_zip(fs, ZipView{archive.data(), archive.size(), label}, destination, times, hasher);
+        }
+
+        Checks::check_exit(VCPKG_LINE_INFO, format != ArchiveFormat::OTHER, "Unsupported archive %s", label);
+        TarReader reader(fs, destination, times, label);
+        IncrementalHasher hash{hasher, archive.data(), 0};
+        if (format == ArchiveFormat::GZIP_TAR)
+        {
+            extract_gzip_tar(reader, archive.data(), archive.size(), hash, label);
+        }
+        else
+        {
+            extract_tar(reader, archive.data(), archive.size(), hash);
+        }
+
+        // Anything after the end of the archive, such as padding, is still part of the file that was downloaded
+        hash.hash_to(archive.size());
+        reader.finish();
+        return true;
+    }
+}
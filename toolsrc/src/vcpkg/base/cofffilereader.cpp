@@ -2,128 +2,138 @@
 
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/cofffilereader.h>
-
-using namespace std;
+#include <vcpkg/base/optional.h>
 
 namespace vcpkg::CoffFileReader
 {
-#if defined(_WIN32)
-    template<class T>
-    static T reinterpret_bytes(const char* data)
+    /// <summary>
+    /// Bounds-checked, little-endian reads from a file mapped into memory. Nothing is copied out of the mapping.
+    /// </summary>
+    struct FileView
     {
-        return (*reinterpret_cast<const T*>(&data[0]));
-    }
+        static FileView open(const fs::path& path)
+        {
+            auto maybe_file = Files::MappedFile::open(path);
+            const auto file = maybe_file.get();
+            Checks::check_exit(
+                VCPKG_LINE_INFO, file != nullptr, "Could not open file %s for reading", path.generic_string());
+            return FileView{std::move(*file), path};
+        }
 
-    template<class T>
-    static T read_value_from_stream(fstream& fs)
-    {
-        T data;
-        fs.read(reinterpret_cast<char*>(&data), sizeof data);
-        return data;
-    }
+        const char* at(const uint64_t offset, const uint64_t count) const
+        {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               offset <= file.size() && count <= file.size() - offset,
+                               "Unexpected end of file %s",
+                               path.generic_string());
+            return file.data() + offset;
+        }
 
-    template<class T>
-    static T peek_value_from_stream(fstream& fs)
-    {
-        const std::streampos original_pos = fs.tellg();
-        T data;
-        fs.read(reinterpret_cast<char*>(&data), sizeof data);
-        fs.seekg(original_pos);
-        return data;
-    }
+        uint16_t read_u16(const uint64_t offset) const
+        {
+            const auto bytes = reinterpret_cast<const unsigned char*>(at(offset, 2));
+            return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+        }
 
-    static void verify_equal_strings(
-        const LineInfo& line_info, const char* expected, const char* actual, int size, const char* label)
-    {
-        Checks::check_exit(line_info,
-                           memcmp(expected, actual, size) == 0,
-                           "Incorrect string (%s) found. Expected: (%s) but found (%s)",
-                           label,
-                           expected,
-                           actual);
-    }
+        uint64_t size() const { return file.size(); }
 
-    static void read_and_verify_PE_signature(fstream& fs)
+        uint32_t read_u32(const uint64_t offset) const
+        {
+            const auto bytes = reinterpret_cast<const unsigned char*>(at(offset, 4));
+            return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) | (uint32_t(bytes[2]) << 16) |
+                   (uint32_t(bytes[3]) << 24);
+        }
+
+        uint64_t read_u64(const uint64_t offset) const
+        {
+            return uint64_t(read_u32(offset)) | (uint64_t(read_u32(offset + 4)) << 32);
+        }
+
+        void verify_equal_strings(const LineInfo& line_info,
+                                  const uint64_t offset,
+                                  const char* expected,
+                                  const size_t size,
+                                  const char* label) const
+        {
+            const char* actual = at(offset, size);
+            Checks::check_exit(line_info,
+                               memcmp(expected, actual, size) == 0,
+                               "Incorrect string (%s) found. Expected: (%s) but found (%s)",
+                               label,
+                               std::string(expected, size),
+                               std::string(actual, size));
+        }
+
+        Files::MappedFile file;
+        const fs::path& path;
+    };
+
+    static uint64_t read_and_verify_PE_signature(const FileView& view)
     {
         static const size_t OFFSET_TO_PE_SIGNATURE_OFFSET = 0x3c;
 
         static const char* PE_SIGNATURE = "PE\0\0";
         static const size_t PE_SIGNATURE_SIZE = 4;
 
-        fs.seekg(OFFSET_TO_PE_SIGNATURE_OFFSET, ios_base::beg);
-        const int32_t offset_to_PE_signature = read_value_from_stream<int32_t>(fs);
-
-        fs.seekg(offset_to_PE_signature);
-        char signature[PE_SIGNATURE_SIZE];
-        fs.read(signature, PE_SIGNATURE_SIZE);
-        verify_equal_strings(VCPKG_LINE_INFO, PE_SIGNATURE, signature, PE_SIGNATURE_SIZE, "PE_SIGNATURE");
-        fs.seekg(offset_to_PE_signature + PE_SIGNATURE_SIZE, ios_base::beg);
+        const uint32_t offset_to_PE_signature = view.read_u32(OFFSET_TO_PE_SIGNATURE_OFFSET);
+        view.verify_equal_strings(
+            VCPKG_LINE_INFO, offset_to_PE_signature, PE_SIGNATURE, PE_SIGNATURE_SIZE, "PE_SIGNATURE");
+        return offset_to_PE_signature + PE_SIGNATURE_SIZE;
     }
 
-    static fpos_t align_to_size(const uint64_t unaligned, const uint64_t alignment_size)
+    static uint64_t align_to_size(const uint64_t unaligned, const uint64_t alignment_size)
     {
-        fpos_t aligned = unaligned - 1;
-        aligned /= alignment_size;
-        aligned += 1;
-        aligned *= alignment_size;
-        return aligned;
+        return (unaligned + alignment_size - 1) / alignment_size * alignment_size;
     }
 
     struct CoffFileHeader
     {
         static const size_t HEADER_SIZE = 20;
 
-        static CoffFileHeader read(fstream& fs)
-        {
-            CoffFileHeader ret;
-            ret.data.resize(HEADER_SIZE);
-            fs.read(&ret.data[0], HEADER_SIZE);
-            return ret;
-        }
-
-        MachineType machine_type() const
+        static MachineType machine_type(const FileView& view, const uint64_t header_offset)
         {
             static const size_t MACHINE_TYPE_OFFSET = 0;
-            static const size_t MACHINE_TYPE_SIZE = 2;
 
-            std::string machine_field_as_string = data.substr(MACHINE_TYPE_OFFSET, MACHINE_TYPE_SIZE);
-            const uint16_t machine = reinterpret_bytes<uint16_t>(machine_field_as_string.c_str());
-            return to_machine_type(machine);
+            view.at(header_offset, HEADER_SIZE);
+            return to_machine_type(view.read_u16(header_offset + MACHINE_TYPE_OFFSET));
         }
-
-    private:
-        std::string data;
     };
 
     struct ArchiveMemberHeader
     {
         static const size_t HEADER_SIZE = 60;
 
-        static ArchiveMemberHeader read(fstream& fs)
+        static ArchiveMemberHeader read(const FileView& view, const uint64_t header_offset)
         {
             static const size_t HEADER_END_OFFSET = 58;
             static const char* HEADER_END = "`\n";
             static const size_t HEADER_END_SIZE = 2;
 
             ArchiveMemberHeader ret;
-            ret.data.resize(HEADER_SIZE);
-            fs.read(&ret.data[0], HEADER_SIZE);
+            ret.data = view.at(header_offset, HEADER_SIZE);
 
             if (ret.data[0] != '\0') // Due to freeglut. github issue #223
             {
-                const std::string header_end = ret.data.substr(HEADER_END_OFFSET, HEADER_END_SIZE);
-                verify_equal_strings(
-                    VCPKG_LINE_INFO, HEADER_END, header_end.c_str(), HEADER_END_SIZE, "LIB HEADER_END");
+                view.verify_equal_strings(VCPKG_LINE_INFO,
+                                          header_offset + HEADER_END_OFFSET,
+                                          HEADER_END,
+                                          HEADER_END_SIZE,
+                                          "LIB HEADER_END");
             }
 
             return ret;
         }
 
-        std::string name() const
+        bool is_linker_member() const
+        {
+            // The name of both linker members is "/" padded with spaces
+            return data[0] == '/' && data[1] == ' ';
+        }
+
+        bool is_special_member() const
         {
-            static const size_t HEADER_NAME_OFFSET = 0;
-            static const size_t HEADER_NAME_SIZE = 16;
-            return data.substr(HEADER_NAME_OFFSET, HEADER_NAME_SIZE);
+            // Linker members, the longnames member "//" and GNU's "/<SYM64>/"; "/123" names a regular member
+            return data[0] == '/' && !(data[1] >= '0' && data[1] <= '9');
         }
 
         uint64_t member_size() const
@@ -132,182 +142,325 @@ namespace vcpkg::CoffFileReader
 
             static const size_t HEADER_SIZE_OFFSET = 48;
             static const size_t HEADER_SIZE_FIELD_SIZE = 10;
-            const std::string as_string = data.substr(HEADER_SIZE_OFFSET, HEADER_SIZE_FIELD_SIZE);
-            // This is in ASCII decimal representation
-            const uint64_t value = std::strtoull(as_string.c_str(), nullptr, 10);
 
-            const uint64_t aligned = align_to_size(value, ALIGNMENT_SIZE);
-            return aligned;
+            // This is in ASCII decimal representation, padded with spaces
+            uint64_t value = 0;
+            const char* field = data + HEADER_SIZE_OFFSET;
+            for (size_t i = 0; i < HEADER_SIZE_FIELD_SIZE && field[i] >= '0' && field[i] <= '9'; ++i)
+            {
+                value = value * 10 + static_cast<uint64_t>(field[i] - '0');
+            }
+
+            return align_to_size(value, ALIGNMENT_SIZE);
         }
 
-        std::string data;
+        const char* data;
     };
 
-    struct OffsetsArray
+    static std::vector<uint32_t> read_member_offsets(const FileView& view,
+                                                     const uint64_t offsets_offset,
+                                                     const uint32_t offset_count)
     {
-        static OffsetsArray read(fstream& fs, const uint32_t offset_count)
-        {
-            static const size_t OFFSET_WIDTH = 4;
+        static const size_t OFFSET_WIDTH = 4;
 
-            std::string raw_offsets;
-            const size_t raw_offset_size = offset_count * OFFSET_WIDTH;
-            raw_offsets.resize(raw_offset_size);
-            fs.read(&raw_offsets[0], raw_offset_size);
+        view.at(offsets_offset, uint64_t(offset_count) * OFFSET_WIDTH);
 
-            OffsetsArray ret;
-            for (uint32_t i = 0; i < offset_count; ++i)
+        std::vector<uint32_t> offsets;
+        offsets.reserve(offset_count);
+        for (uint32_t i = 0; i < offset_count; ++i)
+        {
+            const uint32_t value = view.read_u32(offsets_offset + OFFSET_WIDTH * i);
+
+            // Ignore offsets that point to offset 0. See vcpkg github #223 #288 #292
+            if (value != 0)
             {
-                const std::string value_as_string = raw_offsets.substr(OFFSET_WIDTH * i, OFFSET_WIDTH * (i + 1));
-                const uint32_t value = reinterpret_bytes<uint32_t>(value_as_string.c_str());
+                offsets.push_back(value);
+            }
+        }
 
-                // Ignore offsets that point to offset 0. See vcpkg github #223 #288 #292
-                if (value != 0)
-                {
-                    ret.data.push_back(value);
-                }
+        // Sort the offsets, because it is possible for them to be unsorted. See vcpkg github #292
+        std::sort(offsets.begin(), offsets.end());
+        return offsets;
+    }
+
+    /// <summary>
+    /// Archives written by GNU ar and llvm-lib have no second linker member, so visit every member in turn
+    /// </summary>
+    static std::vector<uint64_t> walk_member_offsets(const FileView& view, uint64_t marker)
+    {
+        std::vector<uint64_t> offsets;
+        while (marker + ArchiveMemberHeader::HEADER_SIZE <= view.size())
+        {
+            const ArchiveMemberHeader header = ArchiveMemberHeader::read(view, marker);
+            if (!header.is_special_member())
+            {
+                offsets.push_back(marker);
             }
 
-            // Sort the offsets, because it is possible for them to be unsorted. See vcpkg github #292
-            std::sort(ret.data.begin(), ret.data.end());
-            return ret;
+            marker += ArchiveMemberHeader::HEADER_SIZE + header.member_size();
         }
 
-        std::vector<uint32_t> data;
-    };
+        return offsets;
+    }
 
     struct ImportHeader
     {
         static const size_t HEADER_SIZE = 20;
 
-        static ImportHeader read(fstream& fs)
+        static MachineType machine_type(const FileView& view, const uint64_t header_offset)
         {
             static const size_t SIG1_OFFSET = 0;
             static const uint16_t SIG1 = static_cast<uint16_t>(MachineType::UNKNOWN);
-            static const size_t SIG1_SIZE = 2;
 
             static const size_t SIG2_OFFSET = 2;
             static const uint16_t SIG2 = 0xFFFF;
-            static const size_t SIG2_SIZE = 2;
 
-            ImportHeader ret;
-            ret.data.resize(HEADER_SIZE);
-            fs.read(&ret.data[0], HEADER_SIZE);
+            static const size_t MACHINE_TYPE_OFFSET = 6;
+
+            view.at(header_offset, HEADER_SIZE);
 
-            const std::string sig1_as_string = ret.data.substr(SIG1_OFFSET, SIG1_SIZE);
-            const uint16_t sig1 = reinterpret_bytes<uint16_t>(sig1_as_string.c_str());
-            Checks::check_exit(VCPKG_LINE_INFO, sig1 == SIG1, "Sig1 was incorrect. Expected %s but got %s", SIG1, sig1);
+            const uint16_t sig1 = view.read_u16(header_offset + SIG1_OFFSET);
+            Checks::check_exit(VCPKG_LINE_INFO, sig1 == SIG1, "Sig1 was incorrect. Expected %u but got %u", SIG1, sig1);
 
-            const std::string sig2_as_string = ret.data.substr(SIG2_OFFSET, SIG2_SIZE);
-            const uint16_t sig2 = reinterpret_bytes<uint16_t>(sig2_as_string.c_str());
-            Checks::check_exit(VCPKG_LINE_INFO, sig2 == SIG2, "Sig2 was incorrect. Expected %s but got %s", SIG2, sig2);
+            const uint16_t sig2 = view.read_u16(header_offset + SIG2_OFFSET);
+            Checks::check_exit(VCPKG_LINE_INFO, sig2 == SIG2, "Sig2 was incorrect. Expected %u but got %u", SIG2, sig2);
 
+            return to_machine_type(view.read_u16(header_offset + MACHINE_TYPE_OFFSET));
+        }
+    };
+
+    static uint64_t read_and_verify_archive_file_signature(const FileView& view)
+    {
+        static const char* FILE_START = "!<arch>\n";
+        static const size_t FILE_START_SIZE = 8;
+
+        view.verify_equal_strings(VCPKG_LINE_INFO, 0, FILE_START, FILE_START_SIZE, "LIB FILE_START");
+        return FILE_START_SIZE;
+    }
+
+    /// <summary>
+    /// The optional header of an image, and the section table used to find data directories in the file
+    /// </summary>
+    struct ImageHeaders
+    {
+        static const size_t SECTION_HEADER_SIZE = 40;
+
+        static ImageHeaders read(const FileView& view, const uint64_t coff_header_offset)
+        {
+            static const size_t NUMBER_OF_SECTIONS_OFFSET = 2;
+            static const size_t SIZE_OF_OPTIONAL_HEADER_OFFSET = 16;
+
+            static const uint16_t PE32_MAGIC = 0x10b;
+            static const uint16_t PE32_PLUS_MAGIC = 0x20b;
+
+            ImageHeaders ret;
+            const uint64_t optional_header_offset = coff_header_offset + CoffFileHeader::HEADER_SIZE;
+            const uint16_t size_of_optional_header =
+                view.read_u16(coff_header_offset + SIZE_OF_OPTIONAL_HEADER_OFFSET);
+
+            ret.optional_header_offset = optional_header_offset;
+            ret.section_count = view.read_u16(coff_header_offset + NUMBER_OF_SECTIONS_OFFSET);
+            ret.section_table_offset = optional_header_offset + size_of_optional_header;
+
+            if (size_of_optional_header == 0)
+            {
+                return ret;
+            }
+
+            const uint16_t magic = view.read_u16(optional_header_offset);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               magic == PE32_MAGIC || magic == PE32_PLUS_MAGIC,
+                               "Unknown optional header magic 0x%x in %s",
+                               magic,
+                               view.path.generic_string());
+            ret.has_optional_header = true;
+            ret.is_pe32_plus = magic == PE32_PLUS_MAGIC;
+
+            const uint64_t count_offset = optional_header_offset + (ret.is_pe32_plus ? 108 : 92);
+            ret.data_directory_count = view.read_u32(count_offset);
+            ret.data_directories_offset = count_offset + 4;
+            ret.image_base = ret.is_pe32_plus ? view.read_u64(optional_header_offset + 24)
+                                              : view.read_u32(optional_header_offset + 28);
             return ret;
         }
 
-        MachineType machine_type() const
+        uint16_t dll_characteristics(const FileView& view) const
         {
-            static const size_t MACHINE_TYPE_OFFSET = 6;
-            static const size_t MACHINE_TYPE_SIZE = 2;
+            static const size_t DLL_CHARACTERISTICS_OFFSET = 70;
+
+            if (!has_optional_header) return 0;
+            return view.read_u16(optional_header_offset + DLL_CHARACTERISTICS_OFFSET);
+        }
+
+        /// <summary>
+        /// Returns the RVA and size of a data directory, or zeros if the image does not have it
+        /// </summary>
+        std::pair<uint32_t, uint32_t> data_directory(const FileView& view, const uint32_t index) const
+        {
+            if (index >= data_directory_count) return {0, 0};
+
+            const uint64_t offset = data_directories_offset + 8 * uint64_t(index);
+            return {view.read_u32(offset), view.read_u32(offset + 4)};
+        }
+
+        /// <summary>
+        /// Translates a relative virtual address to an offset in the file, using the section that contains it
+        /// </summary>
+        Optional<uint64_t> rva_to_offset(const FileView& view, const uint32_t rva) const
+        {
+            for (uint32_t i = 0; i < section_count; ++i)
+            {
+                const uint64_t section = section_table_offset + SECTION_HEADER_SIZE * uint64_t(i);
+                const uint32_t virtual_size = view.read_u32(section + 8);
+                const uint32_t virtual_address = view.read_u32(section + 12);
+                const uint32_t size_of_raw_data = view.read_u32(section + 16);
+                const uint32_t pointer_to_raw_data = view.read_u32(section + 20);
+
+                const uint32_t extent = std::max(virtual_size, size_of_raw_data);
+                if (rva >= virtual_address && rva - virtual_address < extent)
+                {
+                    return pointer_to_raw_data + uint64_t(rva - virtual_address);
+                }
+            }
 
-            std::string machine_field_as_string = data.substr(MACHINE_TYPE_OFFSET, MACHINE_TYPE_SIZE);
-            const uint16_t machine = reinterpret_bytes<uint16_t>(machine_field_as_string.c_str());
-            return to_machine_type(machine);
+            return nullopt;
         }
 
-    private:
-        std::string data;
+        bool has_optional_header = false;
+        bool is_pe32_plus = false;
+        uint64_t image_base = 0;
+        uint64_t optional_header_offset = 0;
+        uint64_t section_table_offset = 0;
+        uint32_t section_count = 0;
+        uint64_t data_directories_offset = 0;
+        uint32_t data_directory_count = 0;
     };
 
-    static void read_and_verify_archive_file_signature(fstream& fs)
+    static std::string read_c_string_at_rva(const FileView& view, const ImageHeaders& headers, const uint32_t rva)
     {
-        static const char* FILE_START = "!<arch>\n";
-        static const size_t FILE_START_SIZE = 8;
+        const Optional<uint64_t> maybe_offset = headers.rva_to_offset(view, rva);
+        const auto offset = maybe_offset.get();
+        Checks::check_exit(VCPKG_LINE_INFO, offset != nullptr, "Invalid name RVA in %s", view.path.generic_string());
+
+        const char* begin = view.at(*offset, 0);
+        const void* end = memchr(begin, '\0', view.size() - *offset);
+        Checks::check_exit(
+            VCPKG_LINE_INFO, end != nullptr, "Unterminated name in %s", view.path.generic_string());
+        return std::string(begin, static_cast<const char*>(end));
+    }
+
+    static bool read_has_exports(const FileView& view, const ImageHeaders& headers)
+    {
+        static const uint32_t EXPORT_DIRECTORY = 0;
+        static const size_t NUMBER_OF_FUNCTIONS_OFFSET = 20;
 
-        fs.seekg(fs.beg);
+        const auto directory = headers.data_directory(view, EXPORT_DIRECTORY);
+        if (directory.first == 0 || directory.second == 0) return false;
 
-        char file_start[FILE_START_SIZE];
-        fs.read(file_start, FILE_START_SIZE);
-        verify_equal_strings(VCPKG_LINE_INFO, FILE_START, file_start, FILE_START_SIZE, "LIB FILE_START");
+        const Optional<uint64_t> maybe_offset = headers.rva_to_offset(view, directory.first);
+        const auto offset = maybe_offset.get();
+        return offset != nullptr && view.read_u32(*offset + NUMBER_OF_FUNCTIONS_OFFSET) != 0;
     }
 
-    DllInfo read_dll(const fs::path& path)
+    static void read_dependencies(const FileView& view, const ImageHeaders& headers, std::vector<std::string>& out)
     {
-        std::fstream fs(path, std::ios::in | std::ios::binary | std::ios::ate);
-        Checks::check_exit(VCPKG_LINE_INFO, fs.is_open(), "Could not open file %s for reading", path.generic_string());
+        static const uint32_t IMPORT_DIRECTORY = 1;
+        static const size_t IMPORT_DESCRIPTOR_SIZE = 20;
+        static const size_t IMPORT_NAME_OFFSET = 12;
+
+        static const uint32_t DELAY_IMPORT_DIRECTORY = 13;
+        static const size_t DELAY_IMPORT_DESCRIPTOR_SIZE = 32;
+        static const size_t DELAY_IMPORT_NAME_OFFSET = 4;
+        // Descriptors without this attribute hold virtual addresses instead of RVAs (Visual C++ 6)
+        static const uint32_t DELAY_IMPORT_RVA_BASED = 1;
+
+        const auto imports = headers.data_directory(view, IMPORT_DIRECTORY);
+        const Optional<uint64_t> maybe_imports_offset =
+            imports.first == 0 ? nullopt : headers.rva_to_offset(view, imports.first);
+        if (const auto offset = maybe_imports_offset.get())
+        {
+            for (uint64_t descriptor = *offset;; descriptor += IMPORT_DESCRIPTOR_SIZE)
+            {
+                const uint32_t name_rva = view.read_u32(descriptor + IMPORT_NAME_OFFSET);
+                if (name_rva == 0) break;
+                out.push_back(read_c_string_at_rva(view, headers, name_rva));
+            }
+        }
 
-        read_and_verify_PE_signature(fs);
-        CoffFileHeader header = CoffFileHeader::read(fs);
-        const MachineType machine = header.machine_type();
-        return {machine};
+        const auto delay_imports = headers.data_directory(view, DELAY_IMPORT_DIRECTORY);
+        const Optional<uint64_t> maybe_delay_imports_offset =
+            delay_imports.first == 0 ? nullopt : headers.rva_to_offset(view, delay_imports.first);
+        if (const auto offset = maybe_delay_imports_offset.get())
+        {
+            for (uint64_t descriptor = *offset;; descriptor += DELAY_IMPORT_DESCRIPTOR_SIZE)
+            {
+                const uint32_t attributes = view.read_u32(descriptor);
+                uint64_t name = view.read_u32(descriptor + DELAY_IMPORT_NAME_OFFSET);
+                if (name == 0) break;
+                if ((attributes & DELAY_IMPORT_RVA_BASED) == 0) name -= headers.image_base;
+                out.push_back(read_c_string_at_rva(view, headers, static_cast<uint32_t>(name)));
+            }
+        }
     }
 
-    struct Marker
+    DllInfo read_dll(const fs::path& path)
     {
-        void set_to_offset(const fpos_t position) { this->m_absolute_position = position; }
-
-        void set_to_current_pos(fstream& fs) { this->m_absolute_position = fs.tellg().seekpos(); }
+        static const uint16_t IMAGE_DLLCHARACTERISTICS_APPCONTAINER = 0x1000;
 
-        void seek_to_marker(fstream& fs) const { fs.seekg(this->m_absolute_position, ios_base::beg); }
+        const FileView view = FileView::open(path);
 
-        void advance_by(const uint64_t offset) { this->m_absolute_position += offset; }
+        const uint64_t header_offset = read_and_verify_PE_signature(view);
+        DllInfo info;
+        info.machine_type = CoffFileHeader::machine_type(view, header_offset);
 
-    private:
-        fpos_t m_absolute_position = 0;
-    };
+        const ImageHeaders headers = ImageHeaders::read(view, header_offset);
+        info.is_app_container = (headers.dll_characteristics(view) & IMAGE_DLLCHARACTERISTICS_APPCONTAINER) != 0;
+        info.has_exports = read_has_exports(view, headers);
+        read_dependencies(view, headers, info.dependencies);
+        return info;
+    }
 
     LibInfo read_lib(const fs::path& path)
     {
-        std::fstream fs(path, std::ios::in | std::ios::binary | std::ios::ate);
-        Checks::check_exit(VCPKG_LINE_INFO, fs.is_open(), "Could not open file %s for reading", path.generic_string());
-
-        read_and_verify_archive_file_signature(fs);
+        const FileView view = FileView::open(path);
 
-        Marker marker;
-        marker.set_to_current_pos(fs);
+        uint64_t marker = read_and_verify_archive_file_signature(view);
 
         // First Linker Member
-        const ArchiveMemberHeader first_linker_member_header = ArchiveMemberHeader::read(fs);
+        const ArchiveMemberHeader first_linker_member_header = ArchiveMemberHeader::read(view, marker);
         Checks::check_exit(VCPKG_LINE_INFO,
-                           first_linker_member_header.name().substr(0, 2) == "/ ",
+                           first_linker_member_header.is_linker_member(),
                            "Could not find proper first linker member");
-        marker.advance_by(ArchiveMemberHeader::HEADER_SIZE + first_linker_member_header.member_size());
-        marker.seek_to_marker(fs);
+        marker += ArchiveMemberHeader::HEADER_SIZE + first_linker_member_header.member_size();
 
-        const ArchiveMemberHeader second_linker_member_header = ArchiveMemberHeader::read(fs);
-        Checks::check_exit(VCPKG_LINE_INFO,
-                           second_linker_member_header.name().substr(0, 2) == "/ ",
-                           "Could not find proper second linker member");
-        // The first 4 bytes contains the number of archive members
-        const uint32_t archive_member_count = read_value_from_stream<uint32_t>(fs);
-        const OffsetsArray offsets = OffsetsArray::read(fs, archive_member_count);
-        marker.advance_by(ArchiveMemberHeader::HEADER_SIZE + second_linker_member_header.member_size());
-        marker.seek_to_marker(fs);
-
-        const bool hasLongnameMemberHeader = peek_value_from_stream<uint16_t>(fs) == 0x2F2F;
-        if (hasLongnameMemberHeader)
+        std::vector<uint64_t> offsets;
+        const ArchiveMemberHeader second_linker_member_header = ArchiveMemberHeader::read(view, marker);
+        if (second_linker_member_header.is_linker_member())
+        {
+            // The first 4 bytes contains the number of archive members
+            const uint64_t second_linker_member_offset = marker + ArchiveMemberHeader::HEADER_SIZE;
+            const uint32_t archive_member_count = view.read_u32(second_linker_member_offset);
+            const std::vector<uint32_t> member_offsets =
+                read_member_offsets(view, second_linker_member_offset + 4, archive_member_count);
+            offsets.assign(member_offsets.cbegin(), member_offsets.cend());
+        }
+        else
         {
-            const ArchiveMemberHeader longnames_member_header = ArchiveMemberHeader::read(fs);
-            marker.advance_by(ArchiveMemberHeader::HEADER_SIZE + longnames_member_header.member_size());
-            marker.seek_to_marker(fs);
+            offsets = walk_member_offsets(view, marker);
         }
 
         std::set<MachineType> machine_types;
         // Next we have the obj and pseudo-object files
-        for (const uint32_t offset : offsets.data)
+        for (const uint64_t offset : offsets)
         {
-            marker.set_to_offset(offset + ArchiveMemberHeader::HEADER_SIZE); // Skip the header, no need to read it.
-            marker.seek_to_marker(fs);
-            const uint16_t first_two_bytes = peek_value_from_stream<uint16_t>(fs);
+            const uint64_t member_offset = offset + ArchiveMemberHeader::HEADER_SIZE; // Skip the header
+            const uint16_t first_two_bytes = view.read_u16(member_offset);
             const bool isImportHeader = to_machine_type(first_two_bytes) == MachineType::UNKNOWN;
-            const MachineType machine =
-                isImportHeader ? ImportHeader::read(fs).machine_type() : CoffFileHeader::read(fs).machine_type();
+            const MachineType machine = isImportHeader ? ImportHeader::machine_type(view, member_offset)
+                                                       : CoffFileHeader::machine_type(view, member_offset);
             machine_types.insert(machine);
         }
 
         return {std::vector<MachineType>(machine_types.cbegin(), machine_types.cend())};
     }
-#else
-    DllInfo read_dll(const fs::path& path) { exit(-1); }
-    LibInfo read_lib(const fs::path& path) { exit(-1); }
-#endif
 }
@@ -0,0 +1,299 @@
+#include "pch.h"
+
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/elffilereader.h>
+
+namespace vcpkg::ElfFileReader
+{
+    /// <summary>
+    /// Bounds-checked reads from a range of a file mapped into memory, honoring the byte order of the ELF file
+    /// </summary>
+    struct ElfView
+    {
+        const char* at(const uint64_t offset, const uint64_t count) const
+        {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               offset <= size && count <= size - offset,
+                               "Unexpected end of ELF file %s",
+                               label);
+            return data + offset;
+        }
+
+        uint64_t read(const uint64_t offset, const size_t width) const
+        {
+            const auto bytes = reinterpret_cast<const unsigned char*>(at(offset, width));
+            uint64_t value = 0;
+            for (size_t i = 0; i < width; ++i)
+            {
+                const size_t shift = 8 * (big_endian ? width - 1 - i : i);
+                value |= uint64_t(bytes[i]) << shift;
+            }
+
+            return value;
+        }
+
+        uint16_t read_u16(const uint64_t offset) const { return static_cast<uint16_t>(read(offset, 2)); }
+        uint32_t read_u32(const uint64_t offset) const { return static_cast<uint32_t>(read(offset, 4)); }
+        /// <summary>
+        /// Reads an address or offset, which is 4 bytes wide in ELF32 files and 8 bytes wide in ELF64 files
+        /// </summary>
+        uint64_t read_word(const uint64_t offset) const { return read(offset, is_64 ? 8 : 4); }
+
+        std::string read_c_string(const uint64_t offset, const uint64_t limit) const
+        {
+            const char* begin = at(offset, 0);
+            const uint64_t available = std::min<uint64_t>(limit, size - offset);
+            const void* end = memchr(begin, '\0', available);
+            Checks::check_exit(VCPKG_LINE_INFO, end != nullptr, "Unterminated string in ELF file %s", label);
+            return std::string(begin, static_cast<const char*>(end));
+        }
+
+        const char* data;
+        uint64_t size;
+        const std::string& label;
+        bool big_endian;
+        bool is_64;
+    };
+
+    struct SectionHeader
+    {
+        static const uint32_t SHT_DYNAMIC = 6;
+
+        static SectionHeader read(const ElfView& view, const uint64_t header_offset)
+        {
+            SectionHeader ret;
+            ret.name = view.read_u32(header_offset);
+            ret.type = view.read_u32(header_offset + 4);
+            ret.offset = view.read_word(header_offset + (view.is_64 ? 24 : 16));
+            ret.size = view.read_word(header_offset + (view.is_64 ? 32 : 20));
+            ret.link = view.read_u32(header_offset + (view.is_64 ? 40 : 24));
+            return ret;
+        }
+
+        uint32_t name;
+        uint32_t type;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t link;
+    };
+
+    static const char ELF_MAGIC[] = {'\x7f', 'E', 'L', 'F'};
+
+    static bool has_elf_magic(const char* data, const uint64_t size)
+    {
+        return size >= sizeof(ELF_MAGIC) && memcmp(data, ELF_MAGIC, sizeof(ELF_MAGIC)) == 0;
+    }
+
+    static ElfType to_elf_type(const uint16_t value)
+    {
+        switch (value)
+        {
+            case 1: return ElfType::RELOCATABLE;
+            case 2: return ElfType::EXECUTABLE;
+            case 3: return ElfType::SHARED_OBJECT;
+            default: return ElfType::OTHER;
+        }
+    }
+
+    static std::string read_soname(const ElfView& view,
+                                   const SectionHeader& dynamic,
+                                   const std::vector<SectionHeader>& sections)
+    {
+        static const uint64_t DT_NULL = 0;
+        static const uint64_t DT_SONAME = 14;
+
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           dynamic.link < sections.size(),
+                           "Invalid string table index in ELF file %s",
+                           view.label);
+        const SectionHeader& strtab = sections[dynamic.link];
+
+        const uint64_t entry_size = view.is_64 ? 16 : 8;
+        view.at(dynamic.offset, dynamic.size);
+        for (uint64_t entry = dynamic.offset; entry + entry_size <= dynamic.offset + dynamic.size; entry += entry_size)
+        {
+            const uint64_t tag = view.read_word(entry);
+            if (tag == DT_NULL) break;
+            if (tag != DT_SONAME) continue;
+
+            const uint64_t name_offset = view.read_word(entry + entry_size / 2);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               name_offset < strtab.size,
+                               "Invalid SONAME offset in ELF file %s",
+                               view.label);
+            return view.read_c_string(strtab.offset + name_offset, strtab.size - name_offset);
+        }
+
+        return "";
+    }
+
+    static ElfInfo read_elf_header(const char* data, const uint64_t size, const std::string& label)
+    {
+        static const size_t EI_CLASS = 4;
+        static const size_t EI_DATA = 5;
+        static const size_t EI_NIDENT = 16;
+
+        Checks::check_exit(VCPKG_LINE_INFO, size >= EI_NIDENT, "Unexpected end of ELF file %s", label);
+
+        ElfInfo info;
+        switch (data[EI_CLASS])
+        {
+            case 1: info.elf_class = ElfClass::ELF32; break;
+            case 2: info.elf_class = ElfClass::ELF64; break;
+            default:
+                Checks::exit_with_message(
+                    VCPKG_LINE_INFO, "Unknown ELF class %d in file %s", static_cast<int>(data[EI_CLASS]), label);
+        }
+
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           data[EI_DATA] == 1 || data[EI_DATA] == 2,
+                           "Unknown ELF byte order %d in file %s",
+                           static_cast<int>(data[EI_DATA]),
+                           label);
+
+        const ElfView view{data, size, label, data[EI_DATA] == 2, info.elf_class == ElfClass::ELF64};
+        info.type = to_elf_type(view.read_u16(16));
+        info.machine = static_cast<ElfMachine>(view.read_u16(18));
+        info.has_debug_info = false;
+
+        const uint64_t section_headers_offset = view.read_word(view.is_64 ? 40 : 32);
+        const uint64_t section_header_size = view.read_u16(view.is_64 ? 58 : 46);
+        uint64_t section_count = view.read_u16(view.is_64 ? 60 : 48);
+        uint32_t section_names_index = view.read_u16(view.is_64 ? 62 : 50);
+        if (section_headers_offset == 0)
+        {
+            return info;
+        }
+
+        // Files with too many sections for the header store the real values in the first section header
+        const SectionHeader first = SectionHeader::read(view, section_headers_offset);
+        if (section_count == 0) section_count = first.size;
+        if (section_names_index == 0xffff) section_names_index = first.link;
+
+        const uint64_t min_section_header_size = view.is_64 ? 64 : 40;
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           section_header_size >= min_section_header_size &&
+                               section_count <= size / section_header_size,
+                           "Invalid section headers in ELF file %s",
+                           label);
+        view.at(section_headers_offset, section_count * section_header_size);
+        std::vector<SectionHeader> sections;
+        sections.reserve(section_count);
+        for (uint64_t i = 0; i < section_count; ++i)
+        {
+            sections.push_back(SectionHeader::read(view, section_headers_offset + i * section_header_size));
+        }
+
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           section_names_index < sections.size(),
+                           "Invalid section name table index in ELF file %s",
+                           label);
+        const SectionHeader& names = sections[section_names_index];
+
+        for (const SectionHeader& section : sections)
+        {
+            if (section.type == SectionHeader::SHT_DYNAMIC && info.soname.empty())
+            {
+                info.soname = read_soname(view, section, sections);
+            }
+
+            if (!info.has_debug_info && section.name < names.size)
+            {
+                const std::string name = view.read_c_string(names.offset + section.name, names.size - section.name);
+                info.has_debug_info = name == ".debug_info" || name == ".zdebug_info";
+            }
+        }
+
+        return info;
+    }
+
+    /// <summary>
+    /// Parses a field of an archive member header, which holds an ASCII decimal number padded with spaces
+    /// </summary>
+    static uint64_t parse_decimal_field(const char* field, const size_t field_size)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < field_size && field[i] >= '0' && field[i] <= '9'; ++i)
+        {
+            value = value * 10 + static_cast<uint64_t>(field[i] - '0');
+        }
+
+        return value;
+    }
+
+    static Files::MappedFile open_mapped(const fs::path& path)
+    {
+        auto maybe_file = Files::MappedFile::open(path);
+        const auto file = maybe_file.get();
+        Checks::check_exit(
+            VCPKG_LINE_INFO, file != nullptr, "Could not open file %s for reading", path.generic_string());
+        return std::move(*file);
+    }
+
+    Optional<ElfInfo> read_elf(const fs::path& path)
+    {
+        const Files::MappedFile file = open_mapped(path);
+        if (!has_elf_magic(file.data(), file.size()))
+        {
+            return nullopt;
+        }
+
+        return read_elf_header(file.data(), file.size(), path.generic_string());
+    }
+
+    Optional<ArchiveInfo> read_archive(const fs::path& path)
+    {
+        static const char FILE_START[] = "!<arch>\n";
+        static const size_t FILE_START_SIZE = 8;
+
+        static const size_t HEADER_SIZE = 60;
+        static const size_t HEADER_SIZE_OFFSET = 48;
+        static const size_t HEADER_SIZE_FIELD_SIZE = 10;
+
+        // BSD ar stores long member names between the header and the contents, as "#1/<length of name>"
+        static const char BSD_LONG_NAME[] = "#1/";
+        static const size_t BSD_LONG_NAME_SIZE = 3;
+
+        const Files::MappedFile file = open_mapped(path);
+        const std::string label = path.generic_string();
+        if (file.size() < FILE_START_SIZE || memcmp(file.data(), FILE_START, FILE_START_SIZE) != 0)
+        {
+            return nullopt;
+        }
+
+        ArchiveInfo ret;
+        uint64_t marker = FILE_START_SIZE;
+        while (marker + HEADER_SIZE <= file.size())
+        {
+            const char* header = file.data() + marker;
+            const uint64_t member_size = parse_decimal_field(header + HEADER_SIZE_OFFSET, HEADER_SIZE_FIELD_SIZE);
+            uint64_t contents_offset = marker + HEADER_SIZE;
+            uint64_t contents_size = member_size;
+            if (memcmp(header, BSD_LONG_NAME, BSD_LONG_NAME_SIZE) == 0)
+            {
+                const uint64_t name_size = parse_decimal_field(header + BSD_LONG_NAME_SIZE, 16 - BSD_LONG_NAME_SIZE);
+                Checks::check_exit(VCPKG_LINE_INFO, name_size <= member_size, "Invalid archive member in %s", label);
+                contents_offset += name_size;
+                contents_size -= name_size;
+            }
+
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               contents_offset <= file.size() && contents_size <= file.size() - contents_offset,
+                               "Unexpected end of archive %s",
+                               label);
+
+            // Symbol tables and the long name table are not ELF files, so they are skipped along with anything else
+            const char* contents = file.data() + contents_offset;
+            if (has_elf_magic(contents, contents_size))
+            {
+                ret.objects.push_back(read_elf_header(contents, contents_size, label));
+            }
+
+            // Members are aligned to an even offset
+            marker = contents_offset + contents_size;
+            marker += marker % 2;
+        }
+
+        return ret;
+    }
+}
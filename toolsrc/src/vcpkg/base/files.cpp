@@ -4,6 +4,21 @@
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
 namespace vcpkg::Files
 {
     static const std::regex FILESYSTEM_INVALID_CHARACTERS_REGEX = std::regex(R"([\/:*?"<>|])");
@@ -112,6 +127,10 @@ namespace vcpkg::Files
         {
             fs::stdfs::rename(oldpath, newpath);
         }
+        virtual void rename(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) override
+        {
+            fs::stdfs::rename(oldpath, newpath, ec);
+        }
         virtual bool remove(const fs::path& path) override { return fs::stdfs::remove(path); }
         virtual bool remove(const fs::path& path, std::error_code& ec) override { return fs::stdfs::remove(path, ec); }
         virtual std::uintmax_t remove_all(const fs::path& path, std::error_code& ec) override
@@ -159,11 +178,67 @@ namespace vcpkg::Files
         {
             return fs::stdfs::copy_file(oldpath, newpath, opts, ec);
         }
+        virtual bool clone_file(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) override
+        {
+            ec.clear();
+#if defined(__linux__) && defined(FICLONE)
+            const int source = open(oldpath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (source == -1)
+            {
+                ec.assign(errno, std::generic_category());
+                return false;
+            }
+
+            struct stat source_stat;
+            int target = -1;
+            if (fstat(source, &source_stat) == 0)
+            {
+                target = open(newpath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, source_stat.st_mode & 07777);
+            }
+
+            if (target == -1)
+            {
+                ec.assign(errno, std::generic_category());
+                close(source);
+                return false;
+            }
+
+            const bool cloned = ioctl(target, FICLONE, source) == 0;
+            if (!cloned) ec.assign(errno, std::generic_category());
+            close(target);
+            close(source);
+            if (!cloned) unlink(newpath.c_str());
+            return cloned;
+#elif defined(__APPLE__)
+            if (clonefile(oldpath.c_str(), newpath.c_str(), 0) == 0) return true;
+            ec.assign(errno, std::generic_category());
+            return false;
+#else
+            ec = std::make_error_code(std::errc::operation_not_supported);
+            return false;
+#endif
+        }
+        virtual void create_hard_link(const fs::path& oldpath, const fs::path& newpath, std::error_code& ec) override
+        {
+            fs::stdfs::create_hard_link(oldpath, newpath, ec);
+        }
 
         virtual fs::file_status status(const fs::path& path, std::error_code& ec) const override
         {
             return fs::stdfs::status(path, ec);
         }
+        virtual fs::file_status symlink_status(const fs::path& path, std::error_code& ec) const override
+        {
+            return fs::stdfs::symlink_status(path, ec);
+        }
+        virtual std::uintmax_t file_size(const fs::path& path, std::error_code& ec) const override
+        {
+            return fs::stdfs::file_size(path, ec);
+        }
+        virtual fs::file_time_type last_write_time(const fs::path& path, std::error_code& ec) const override
+        {
+            return fs::stdfs::last_write_time(path, ec);
+        }
         virtual void write_contents(const fs::path& file_path, const std::string& data) override
         {
             FILE* f = nullptr;
@@ -180,6 +255,52 @@ namespace vcpkg::Files
 
             Checks::check_exit(VCPKG_LINE_INFO, count == data.size());
         }
+        virtual void write_contents(const fs::path& file_path,
+                                    const std::string& data,
+                                    std::error_code& ec) override
+        {
+            ec.clear();
+            std::fstream output(file_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            if (output.fail())
+            {
+                ec = std::make_error_code(std::errc::permission_denied);
+                return;
+            }
+
+            output.write(data.data(), data.size());
+            output.close();
+            if (output.fail())
+            {
+                ec = std::make_error_code(std::errc::io_error);
+            }
+        }
+        virtual void append_contents(const fs::path& file_path,
+                                     const std::string& data,
+                                     std::error_code& ec) override
+        {
+            ec.clear();
+            FILE* f = nullptr;
+#if defined(_WIN32)
+            if (_wfopen_s(&f, file_path.native().c_str(), L"ab") != 0) f = nullptr;
+#else
+            f = fopen(file_path.native().c_str(), "ab");
+#endif
+            if (f == nullptr)
+            {
+                ec = std::make_error_code(std::errc::permission_denied);
+                return;
+            }
+
+            const auto count = fwrite(data.data(), sizeof(data[0]), data.size(), f);
+            bool ok = count == data.size() && fflush(f) == 0;
+#if defined(_WIN32)
+            ok = ok && _commit(_fileno(f)) == 0;
+#else
+            ok = ok && fsync(fileno(f)) == 0;
+#endif
+            if (fclose(f) != 0) ok = false;
+            if (!ok) ec = std::make_error_code(std::errc::io_error);
+        }
     };
 
     Filesystem& get_real_filesystem()
@@ -188,6 +309,138 @@ namespace vcpkg::Files
         return real_fs;
     }
 
+    Expected<MappedFile> MappedFile::open(const fs::path& file_path)
+    {
+        MappedFile ret;
+#if defined(_WIN32)
+        const HANDLE file_handle = CreateFileW(file_path.native().c_str(),
+                                               GENERIC_READ,
+                                               FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                               nullptr,
+                                               OPEN_EXISTING,
+                                               FILE_ATTRIBUTE_NORMAL,
+                                               nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            return std::make_error_code(std::errc::no_such_file_or_directory);
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle, &file_size) || static_cast<unsigned long long>(file_size.QuadPart) > SIZE_MAX)
+        {
+            CloseHandle(file_handle);
+            return std::make_error_code(std::errc::file_too_large);
+        }
+
+        if (file_size.QuadPart == 0)
+        {
+            CloseHandle(file_handle);
+            return std::move(ret);
+        }
+
+        const HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file_handle);
+        if (mapping_handle == nullptr)
+        {
+            return std::make_error_code(std::errc::io_error);
+        }
+
+        // The view keeps the mapping alive after its handle is closed
+        const void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping_handle);
+        if (view == nullptr)
+        {
+            return std::make_error_code(std::errc::io_error);
+        }
+
+        ret.m_data = static_cast<const char*>(view);
+        ret.m_size = static_cast<size_t>(file_size.QuadPart);
+#else
+        const int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            return std::error_code(errno, std::generic_category());
+        }
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            const std::error_code ec(errno, std::generic_category());
+            close(fd);
+            return ec;
+        }
+
+        if (file_stat.st_size == 0)
+        {
+            close(fd);
+            return std::move(ret);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        void* view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED)
+        {
+            return std::error_code(errno, std::generic_category());
+        }
+
+        ret.m_data = static_cast<const char*>(view);
+        ret.m_size = static_cast<size_t>(file_stat.st_size);
+#endif
+        return std::move(ret);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept : m_data(other.m_data), m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() { reset(); }
+
+    void MappedFile::reset()
+    {
+        if (m_data != nullptr)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            munmap(const_cast<char*>(m_data), m_size);
+#endif
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    void write_contents_atomically(Filesystem& fs,
+                                   const fs::path& file_path,
+                                   const std::string& data,
+                                   std::error_code& ec)
+    {
+        const fs::path tmp_path =
+            file_path.parent_path() /
+            Strings::format("%s.%lu.tmp", file_path.filename().u8string(), System::get_current_process_id());
+        fs.create_directories(file_path.parent_path(), ec);
+        fs.write_contents(tmp_path, data, ec);
+        if (!ec) fs.rename(tmp_path, file_path, ec);
+        if (ec)
+        {
+            std::error_code ignored;
+            fs.remove(tmp_path, ignored);
+        }
+    }
+
     bool has_invalid_chars_for_filesystem(const std::string& s)
     {
         return std::regex_search(s, FILESYSTEM_INVALID_CHARACTERS_REGEX);
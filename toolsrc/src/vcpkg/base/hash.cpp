@@ -0,0 +1,465 @@
+#include "pch.h"
+
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/util.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VCPKG_HASH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+namespace vcpkg::Hash
+{
+    namespace
+    {
+        template<class Word>
+        Word rotr(const Word value, const int bits)
+        {
+            return (value >> bits) | (value << (sizeof(Word) * 8 - bits));
+        }
+
+        // Written out so that compilers turn them into a load and a byte swap
+        uint32_t load_big_endian_32(const unsigned char* bytes)
+        {
+            return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) |
+                   uint32_t(bytes[3]);
+        }
+
+        uint64_t load_big_endian_64(const unsigned char* bytes)
+        {
+            return (uint64_t(load_big_endian_32(bytes)) << 32) | load_big_endian_32(bytes + 4);
+        }
+
+        // One SHA-2 round; callers rotate the roles of the eight working variables instead of moving them
+        template<class Word, int S0A, int S0B, int S0C, int S1A, int S1B, int S1C>
+        void sha2_round(Word a, Word b, Word c, Word& d, Word e, Word f, Word g, Word& h, const Word k_plus_w)
+        {
+            const Word tmp1 = h + (rotr(e, S1A) ^ rotr(e, S1B) ^ rotr(e, S1C)) + ((e & f) ^ (~e & g)) + k_plus_w;
+            d += tmp1;
+            h = tmp1 + (rotr(a, S0A) ^ rotr(a, S0B) ^ rotr(a, S0C)) + ((a & b) ^ (a & c) ^ (b & c));
+        }
+
+        template<class Word, int S0A, int S0B, int S0C, int S1A, int S1B, int S1C>
+        void sha2_rounds(Word state[8], const Word* round_constants, const Word* w, const size_t rounds)
+        {
+            const auto round = &sha2_round<Word, S0A, S0B, S0C, S1A, S1B, S1C>;
+            Word a = state[0], b = state[1], c = state[2], d = state[3];
+            Word e = state[4], f = state[5], g = state[6], h = state[7];
+            for (size_t i = 0; i < rounds; i += 8)
+            {
+                round(a, b, c, d, e, f, g, h, round_constants[i] + w[i]);
+                round(h, a, b, c, d, e, f, g, round_constants[i + 1] + w[i + 1]);
+                round(g, h, a, b, c, d, e, f, round_constants[i + 2] + w[i + 2]);
+                round(f, g, h, a, b, c, d, e, round_constants[i + 3] + w[i + 3]);
+                round(e, f, g, h, a, b, c, d, round_constants[i + 4] + w[i + 4]);
+                round(d, e, f, g, h, a, b, c, round_constants[i + 5] + w[i + 5]);
+                round(c, d, e, f, g, h, a, b, round_constants[i + 6] + w[i + 6]);
+                round(b, c, d, e, f, g, h, a, round_constants[i + 7] + w[i + 7]);
+            }
+
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+
+        struct Sha1Algorithm
+        {
+            using Word = uint32_t;
+            static constexpr size_t BLOCK_SIZE = 64;
+            static constexpr size_t LENGTH_SIZE = 8;
+            static constexpr size_t STATE_WORDS = 5;
+
+            static constexpr Word INITIAL_STATE[STATE_WORDS] = {
+                0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+            static void process_blocks(Word state[STATE_WORDS], const unsigned char* data, size_t count)
+            {
+                for (; count != 0; --count, data += BLOCK_SIZE)
+                {
+                    // The message schedule is expanded as the rounds consume it, sixteen words at a time
+                    Word w[16];
+                    for (size_t i = 0; i < 16; ++i)
+                        w[i] = load_big_endian_32(data + i * 4);
+                    const auto schedule = [&](const size_t i) -> Word {
+                        if (i < 16) return w[i];
+                        Word& w_i = w[i & 15];
+                        w_i = rotr<Word>(w[(i - 3) & 15] ^ w[(i - 8) & 15] ^ w[(i - 14) & 15] ^ w_i, 31);
+                        return w_i;
+                    };
+
+                    Word a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+                    const auto round = [&](const Word f, const Word k, const Word w_i) {
+                        const Word tmp = rotr<Word>(a, 27) + f + e + k + w_i;
+                        e = d;
+                        d = c;
+                        c = rotr<Word>(b, 2);
+                        b = a;
+                        a = tmp;
+                    };
+
+                    size_t i = 0;
+                    for (; i < 20; ++i)
+                        round((b & c) | (~b & d), 0x5a827999, schedule(i));
+                    for (; i < 40; ++i)
+                        round(b ^ c ^ d, 0x6ed9eba1, schedule(i));
+                    for (; i < 60; ++i)
+                        round((b & c) | (b & d) | (c & d), 0x8f1bbcdc, schedule(i));
+                    for (; i < 80; ++i)
+                        round(b ^ c ^ d, 0xca62c1d6, schedule(i));
+
+                    state[0] += a;
+                    state[1] += b;
+                    state[2] += c;
+                    state[3] += d;
+                    state[4] += e;
+                }
+            }
+        };
+
+        constexpr uint32_t SHA256_ROUND_CONSTANTS[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+
+        void sha256_process_blocks_portable(uint32_t state[8], const unsigned char* data, size_t count)
+        {
+            for (; count != 0; --count, data += 64)
+            {
+                uint32_t w[64];
+                for (size_t i = 0; i < 16; ++i)
+                    w[i] = load_big_endian_32(data + i * 4);
+                for (size_t i = 16; i < 64; ++i)
+                {
+                    const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                sha2_rounds<uint32_t, 2, 13, 22, 6, 11, 25>(state, SHA256_ROUND_CONSTANTS, w, 64);
+            }
+        }
+
+#if defined(VCPKG_HASH_X86)
+        bool cpu_has_sha_extensions()
+        {
+            // SHA is CPUID.(EAX=7,ECX=0):EBX[29]; the SHA-NI code below also uses SSSE3 and SSE4.1
+#if defined(_MSC_VER)
+            int regs[4];
+            __cpuid(regs, 0);
+            if (regs[0] < 7) return false;
+            __cpuid(regs, 1);
+            const bool has_sse = (regs[2] & (1 << 9)) && (regs[2] & (1 << 19));
+            __cpuidex(regs, 7, 0);
+            return has_sse && (regs[1] & (1 << 29));
+#else
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (__get_cpuid_max(0, nullptr) < 7) return false;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+            const bool has_sse = (ecx & (1u << 9)) && (ecx & (1u << 19));
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            return has_sse && (ebx & (1u << 29));
+#endif
+        }
+
+#if !defined(_MSC_VER)
+        __attribute__((target("sha,sse4.1,ssse3")))
+#endif
+        void sha256_process_blocks_sha_ni(uint32_t state[8], const unsigned char* data, size_t count)
+        {
+            const __m128i byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+            // The SHA instructions keep the state as ABEF and CDGH
+            __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xb1);
+            __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1b);
+            __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+            state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+            for (; count != 0; --count, data += 64)
+            {
+                const __m128i abef_save = state0;
+                const __m128i cdgh_save = state1;
+
+                // Four rounds per group; w holds the last sixteen message schedule words
+                __m128i w[4];
+                for (size_t group = 0; group < 16; ++group)
+                {
+                    __m128i& current = w[group % 4];
+                    if (group < 4)
+                    {
+                        current = _mm_shuffle_epi8(
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + group * 16)), byte_swap_mask);
+                    }
+                    else
+                    {
+                        const __m128i& previous = w[(group + 3) % 4];
+                        __m128i next = _mm_sha256msg1_epu32(current, w[(group + 1) % 4]);
+                        next = _mm_add_epi32(next, _mm_alignr_epi8(previous, w[(group + 2) % 4], 4));
+                        current = _mm_sha256msg2_epu32(next, previous);
+                    }
+
+                    __m128i msg = _mm_add_epi32(
+                        current, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_ROUND_CONSTANTS[group * 4])));
+                    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+                    msg = _mm_shuffle_epi32(msg, 0x0e);
+                    state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+                }
+
+                state0 = _mm_add_epi32(state0, abef_save);
+                state1 = _mm_add_epi32(state1, cdgh_save);
+            }
+
+            tmp = _mm_shuffle_epi32(state0, 0x1b);
+            state1 = _mm_shuffle_epi32(state1, 0xb1);
+            state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+            state1 = _mm_alignr_epi8(state1, tmp, 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+        }
+#endif
+
+        struct Sha256Algorithm
+        {
+            using Word = uint32_t;
+            static constexpr size_t BLOCK_SIZE = 64;
+            static constexpr size_t LENGTH_SIZE = 8;
+            static constexpr size_t STATE_WORDS = 8;
+
+            static constexpr Word INITIAL_STATE[STATE_WORDS] = {
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+            static void process_blocks(Word state[STATE_WORDS], const unsigned char* data, size_t count)
+            {
+#if defined(VCPKG_HASH_X86)
+                static const auto process = cpu_has_sha_extensions() ? &sha256_process_blocks_sha_ni
+                                                                     : &sha256_process_blocks_portable;
+#else
+                static const auto process = &sha256_process_blocks_portable;
+#endif
+                process(state, data, count);
+            }
+        };
+
+        struct Sha512Algorithm
+        {
+            using Word = uint64_t;
+            static constexpr size_t BLOCK_SIZE = 128;
+            static constexpr size_t LENGTH_SIZE = 16;
+            static constexpr size_t STATE_WORDS = 8;
+
+            static constexpr Word INITIAL_STATE[STATE_WORDS] = {
+                0x6a09e667f3bcc908,
+                0xbb67ae8584caa73b,
+                0x3c6ef372fe94f82b,
+                0xa54ff53a5f1d36f1,
+                0x510e527fade682d1,
+                0x9b05688c2b3e6c1f,
+                0x1f83d9abfb41bd6b,
+                0x5be0cd19137e2179,
+            };
+
+            static constexpr Word ROUND_CONSTANTS[80] = {
+                0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538,
+                0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242, 0x12835b0145706fbe,
+                0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+                0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+                0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5, 0x983e5152ee66dfab,
+                0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+                0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed,
+                0x53380d139d95b3df, 0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+                0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+                0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8, 0x19a4c116b8d2d0c8, 0x1e376c085141ab53,
+                0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373,
+                0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+                0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b, 0xca273eceea26619c,
+                0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba, 0x0a637dc5a2c898a6,
+                0x113f9804bef90dae, 0x1b710b35131c471b, 0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+                0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+            };
+
+            static void process_blocks(Word state[STATE_WORDS], const unsigned char* data, size_t count)
+            {
+                for (; count != 0; --count, data += BLOCK_SIZE)
+                {
+                    Word w[80];
+                    for (size_t i = 0; i < 16; ++i)
+                        w[i] = load_big_endian_64(data + i * 8);
+                    for (size_t i = 16; i < 80; ++i)
+                    {
+                        const Word s0 = rotr(w[i - 15], 1) ^ rotr(w[i - 15], 8) ^ (w[i - 15] >> 7);
+                        const Word s1 = rotr(w[i - 2], 19) ^ rotr(w[i - 2], 61) ^ (w[i - 2] >> 6);
+                        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                    }
+
+                    sha2_rounds<Word, 28, 34, 39, 14, 18, 41>(state, ROUND_CONSTANTS, w, 80);
+                }
+            }
+        };
+
+        // Buffers input into whole blocks for Algo, and applies the final padding and length
+        template<class Algo>
+        struct BlockHasher final : Hasher
+        {
+            using Word = typename Algo::Word;
+
+            BlockHasher() { clear(); }
+
+            virtual void add_bytes(const void* data, size_t size) override
+            {
+                if (size == 0) return;
+
+                auto bytes = static_cast<const unsigned char*>(data);
+                total_size += size;
+
+                if (buffered != 0)
+                {
+                    const size_t taken = std::min(size, Algo::BLOCK_SIZE - buffered);
+                    std::memcpy(buffer + buffered, bytes, taken);
+                    buffered += taken;
+                    bytes += taken;
+                    size -= taken;
+                    if (buffered != Algo::BLOCK_SIZE) return;
+                    Algo::process_blocks(state, buffer, 1);
+                    buffered = 0;
+                }
+
+                // Whole blocks are hashed straight from the caller's memory
+                const size_t whole_blocks = size / Algo::BLOCK_SIZE;
+                if (whole_blocks != 0)
+                {
+                    Algo::process_blocks(state, bytes, whole_blocks);
+                    bytes += whole_blocks * Algo::BLOCK_SIZE;
+                    size -= whole_blocks * Algo::BLOCK_SIZE;
+                }
+
+                std::memcpy(buffer, bytes, size);
+                buffered = size;
+            }
+
+            virtual std::string get_hash() override
+            {
+                const uint64_t total_bits = total_size * 8;
+
+                unsigned char padding[2 * Algo::BLOCK_SIZE] = {0x80};
+                size_t padding_size = Algo::BLOCK_SIZE - buffered;
+                if (padding_size < Algo::LENGTH_SIZE + 1) padding_size += Algo::BLOCK_SIZE;
+                for (size_t i = 0; i < 8; ++i)
+                    padding[padding_size - 1 - i] = static_cast<unsigned char>(total_bits >> (i * 8));
+                add_bytes(padding, padding_size);
+
+                static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+                std::string result;
+                result.reserve(Algo::STATE_WORDS * sizeof(Word) * 2);
+                for (const Word word : state)
+                {
+                    for (size_t shift = sizeof(Word) * 8; shift != 0; shift -= 4)
+                        result.push_back(HEX_DIGITS[(word >> (shift - 4)) & 0xf]);
+                }
+
+                clear();
+                return result;
+            }
+
+            virtual void clear() override
+            {
+                std::copy(std::begin(Algo::INITIAL_STATE), std::end(Algo::INITIAL_STATE), state);
+                buffered = 0;
+                total_size = 0;
+            }
+
+        private:
+            Word state[Algo::STATE_WORDS];
+            unsigned char buffer[Algo::BLOCK_SIZE];
+            size_t buffered;
+            uint64_t total_size;
+        };
+    }
+
+    Optional<Algorithm> algorithm_from_string(const std::string& name)
+    {
+        const std::string lowercase = Strings::ascii_to_lowercase(name);
+        if (lowercase == "sha1") return Algorithm::SHA1;
+        if (lowercase == "sha256") return Algorithm::SHA256;
+        if (lowercase == "sha512") return Algorithm::SHA512;
+        return nullopt;
+    }
+
+    const char* to_string(Algorithm algo)
+    {
+        switch (algo)
+        {
+            case Algorithm::SHA1: return "SHA1";
+            case Algorithm::SHA256: return "SHA256";
+            case Algorithm::SHA512: return "SHA512";
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
+    std::unique_ptr<Hasher> get_hasher_for(Algorithm algo)
+    {
+        switch (algo)
+        {
+            case Algorithm::SHA1: return std::make_unique<BlockHasher<Sha1Algorithm>>();
+            case Algorithm::SHA256: return std::make_unique<BlockHasher<Sha256Algorithm>>();
+            case Algorithm::SHA512: return std::make_unique<BlockHasher<Sha512Algorithm>>();
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
+    std::string get_bytes_hash(const void* data, size_t size, Algorithm algo)
+    {
+        auto hasher = get_hasher_for(algo);
+        hasher->add_bytes(data, size);
+        return hasher->get_hash();
+    }
+
+    std::string get_string_hash(const std::string& s, Algorithm algo)
+    {
+        return get_bytes_hash(s.data(), s.size(), algo);
+    }
+
+    Expected<std::string> get_file_hash(const fs::path& path, Algorithm algo)
+    {
+        auto maybe_mapped = Files::MappedFile::open(path);
+        if (const auto mapped = maybe_mapped.get())
+        {
+            return get_bytes_hash(mapped->data(), mapped->size(), algo);
+        }
+
+        // Files that cannot be mapped, such as very large files in a 32-bit process, are streamed instead
+        std::ifstream file_stream(path, std::ios_base::in | std::ios_base::binary);
+        if (!file_stream) return maybe_mapped.error();
+
+        auto hasher = get_hasher_for(algo);
+        std::vector<char> chunk(1024 * 1024);
+        while (file_stream)
+        {
+            file_stream.read(chunk.data(), chunk.size());
+            hasher->add_bytes(chunk.data(), static_cast<size_t>(file_stream.gcount()));
+        }
+
+        if (!file_stream.eof()) return std::make_error_code(std::errc::io_error);
+        return hasher->get_hash();
+    }
+
+    std::vector<Expected<std::string>> get_files_hash(const std::vector<fs::path>& paths, Algorithm algo)
+    {
+        return Util::parallel_fmap(paths, [algo](const fs::path& path) { return get_file_hash(path, algo); });
+    }
+}
@@ -0,0 +1,434 @@
+#include "pch.h"
+
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/inflate.h>
+
+namespace vcpkg::Inflate
+{
+    // Slicing-by-8: table k holds the CRC of a byte followed by k zero bytes, so 8 bytes are folded in at once
+    static const std::array<std::array<uint32_t, 256>, 8>& get_crc32_tables()
+    {
+        static const auto tables = []() {
+            std::array<std::array<uint32_t, 256>, 8> ret;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+                }
+                ret[0][i] = c;
+            }
+
+            for (size_t k = 1; k < 8; ++k)
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    ret[k][i] = ret[0][ret[k - 1][i] & 0xFF] ^ (ret[k - 1][i] >> 8);
+                }
+            }
+
+            return ret;
+        }();
+        return tables;
+    }
+
+    uint32_t crc32(uint32_t crc, const void* data, size_t size)
+    {
+        const auto& t = get_crc32_tables();
+        auto bytes = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+        for (; size >= 8; size -= 8, bytes += 8)
+        {
+            const uint32_t low = crc ^ (uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 | uint32_t(bytes[2]) << 16 |
+                                        uint32_t(bytes[3]) << 24);
+            crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+                  t[3][bytes[4]] ^ t[2][bytes[5]] ^ t[1][bytes[6]] ^ t[0][bytes[7]];
+        }
+
+        for (; size != 0; --size, ++bytes)
+        {
+            crc = t[0][(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+    static constexpr size_t WINDOW_SIZE = 32768;
+    static constexpr size_t PIECE_SIZE = 256 * 1024;
+    static constexpr unsigned MAX_MATCH = 258;
+    static constexpr unsigned END_OF_BLOCK = 256;
+
+    static constexpr uint16_t LENGTH_BASE[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                               31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static constexpr uint8_t LENGTH_EXTRA[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                               2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static constexpr uint16_t DIST_BASE[] = {1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+                                             33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+                                             1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static constexpr uint8_t DIST_EXTRA[] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                             6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    bool Inflater::Huffman::build(const uint8_t* lengths, const unsigned count)
+    {
+        std::fill(std::begin(counts), std::end(counts), uint16_t(0));
+        std::fill(std::begin(fast), std::end(fast), uint16_t(0));
+        for (unsigned i = 0; i < count; ++i)
+        {
+            ++counts[lengths[i]];
+        }
+        counts[0] = 0;
+
+        // Incomplete codes are allowed, as zlib does for a lone distance code; their unused codes fail to decode
+        int left = 1;
+        for (unsigned len = 1; len < 16; ++len)
+        {
+            left = (left << 1) - counts[len];
+            if (left < 0) return false;
+        }
+
+        uint16_t offsets[16];
+        uint16_t next_code[16];
+        offsets[1] = 0;
+        next_code[1] = 0;
+        for (unsigned len = 1; len < 15; ++len)
+        {
+            offsets[len + 1] = static_cast<uint16_t>(offsets[len] + counts[len]);
+            next_code[len + 1] = static_cast<uint16_t>((next_code[len] + counts[len]) << 1);
+        }
+
+        for (unsigned symbol = 0; symbol < count; ++symbol)
+        {
+            const unsigned len = lengths[symbol];
+            if (len == 0) continue;
+
+            symbols[offsets[len]++] = static_cast<uint16_t>(symbol);
+            const unsigned code = next_code[len]++;
+            if (len > FAST_BITS) continue;
+
+            // Codes are packed starting from their most significant bit, so they are looked up reversed
+            unsigned reversed = 0;
+            for (unsigned bit = 0; bit < len; ++bit)
+            {
+                reversed |= ((code >> bit) & 1) << (len - 1 - bit);
+            }
+
+            for (unsigned i = reversed; i < (1u << FAST_BITS); i += 1u << len)
+            {
+                fast[i] = static_cast<uint16_t>((symbol << 4) | len);
+            }
+        }
+
+        return true;
+    }
+
+    static const Inflater::Huffman& get_fixed_litlen()
+    {
+        static const auto huffman = []() {
+            uint8_t lengths[288];
+            std::fill(lengths, lengths + 144, uint8_t(8));
+            std::fill(lengths + 144, lengths + 256, uint8_t(9));
+            std::fill(lengths + 256, lengths + 280, uint8_t(7));
+            std::fill(lengths + 280, lengths + 288, uint8_t(8));
+            auto ret = std::make_unique<Inflater::Huffman>();
+            ret->build(lengths, 288);
+            return ret;
+        }();
+        return *huffman;
+    }
+
+    static const Inflater::Huffman& get_fixed_dist()
+    {
+        static const auto huffman = []() {
+            uint8_t lengths[30];
+            std::fill(lengths, lengths + 30, uint8_t(5));
+            auto ret = std::make_unique<Inflater::Huffman>();
+            ret->build(lengths, 30);
+            return ret;
+        }();
+        return *huffman;
+    }
+
+    Inflater::Inflater(const char* data, const size_t size, const std::string& label)
+        : m_begin(reinterpret_cast<const uint8_t*>(data))
+        , m_in(m_begin)
+        , m_end(m_begin + size)
+        , m_window(WINDOW_SIZE + PIECE_SIZE)
+        , m_label(label)
+    {
+    }
+
+    void Inflater::fail() const
+    {
+        Checks::exit_with_message(VCPKG_LINE_INFO, "Invalid or truncated compressed data in %s", m_label);
+    }
+
+    void Inflater::refill()
+    {
+        if (m_end - m_in >= 8)
+        {
+            uint64_t word = 0;
+            for (int i = 7; i >= 0; --i)
+            {
+                word = (word << 8) | m_in[i];
+            }
+
+            m_bits |= word << m_bit_count;
+            m_in += (63 - m_bit_count) >> 3;
+            m_bit_count |= 56;
+            return;
+        }
+
+        while (m_bit_count <= 56 && m_in != m_end)
+        {
+            m_bits |= uint64_t(*m_in++) << m_bit_count;
+            m_bit_count += 8;
+        }
+    }
+
+    uint32_t Inflater::read_bits(const unsigned count)
+    {
+        if (m_bit_count < count)
+        {
+            refill();
+            if (m_bit_count < count) fail();
+        }
+
+        const auto value = static_cast<uint32_t>(m_bits & ((uint64_t(1) << count) - 1));
+        m_bits >>= count;
+        m_bit_count -= count;
+        return value;
+    }
+
+    unsigned Inflater::decode(const Huffman& huffman)
+    {
+        if (m_bit_count < 15) refill();
+
+        const unsigned entry = huffman.fast[m_bits & ((1u << Huffman::FAST_BITS) - 1)];
+        if (entry != 0)
+        {
+            const unsigned len = entry & 15;
+            if (len > m_bit_count) fail();
+            m_bits >>= len;
+            m_bit_count -= len;
+            return entry >> 4;
+        }
+
+        // Codes longer than the fast table are rare; walk the canonical code one bit at a time
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (unsigned len = 1; len < 16 && len <= m_bit_count; ++len)
+        {
+            code |= static_cast<int>((m_bits >> (len - 1)) & 1);
+            const int count = huffman.counts[len];
+            if (code - first < count)
+            {
+                m_bits >>= len;
+                m_bit_count -= len;
+                return huffman.symbols[index + code - first];
+            }
+
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+
+        fail();
+    }
+
+    void Inflater::read_block_header()
+    {
+        m_last_block = read_bits(1) != 0;
+        switch (read_bits(2))
+        {
+            case 0:
+            {
+                // Stored blocks start at a byte boundary; hand the whole bytes still buffered back to the input
+                const unsigned skip = m_bit_count % 8;
+                m_bits >>= skip;
+                m_bit_count -= skip;
+                const uint32_t len = read_bits(16);
+                const uint32_t nlen = read_bits(16);
+                if ((len ^ 0xFFFF) != nlen) fail();
+                m_in -= m_bit_count / 8;
+                m_bits = 0;
+                m_bit_count = 0;
+                m_stored_remaining = len;
+                m_state = State::STORED;
+                return;
+            }
+            case 1:
+                m_litlen = &get_fixed_litlen();
+                m_dist = &get_fixed_dist();
+                m_state = State::HUFFMAN;
+                return;
+            case 2:
+                read_dynamic_tables();
+                m_litlen = &m_dynamic_litlen;
+                m_dist = &m_dynamic_dist;
+                m_state = State::HUFFMAN;
+                return;
+            default: fail();
+        }
+    }
+
+    void Inflater::read_dynamic_tables()
+    {
+        static constexpr uint8_t CODE_LENGTH_ORDER[19] = {
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        const unsigned litlen_count = read_bits(5) + 257;
+        const unsigned dist_count = read_bits(5) + 1;
+        const unsigned code_length_count = read_bits(4) + 4;
+        if (litlen_count > 286 || dist_count > 30) fail();
+
+        uint8_t code_lengths[19] = {};
+        for (unsigned i = 0; i < code_length_count; ++i)
+        {
+            code_lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(read_bits(3));
+        }
+
+        Huffman code_length_huffman;
+        if (!code_length_huffman.build(code_lengths, 19)) fail();
+
+        uint8_t lengths[286 + 30];
+        unsigned index = 0;
+        while (index < litlen_count + dist_count)
+        {
+            const unsigned symbol = decode(code_length_huffman);
+            if (symbol < 16)
+            {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t value = 0;
+            unsigned repeat;
+            if (symbol == 16)
+            {
+                if (index == 0) fail();
+                value = lengths[index - 1];
+                repeat = 3 + read_bits(2);
+            }
+            else if (symbol == 17)
+            {
+                repeat = 3 + read_bits(3);
+            }
+            else
+            {
+                repeat = 11 + read_bits(7);
+            }
+
+            if (index + repeat > litlen_count + dist_count) fail();
+            std::fill(lengths + index, lengths + index + repeat, value);
+            index += repeat;
+        }
+
+        if (lengths[END_OF_BLOCK] == 0) fail();
+        if (!m_dynamic_litlen.build(lengths, litlen_count)) fail();
+        if (!m_dynamic_dist.build(lengths + litlen_count, dist_count)) fail();
+    }
+
+    void Inflater::decode_huffman()
+    {
+        uint8_t* const window = m_window.data();
+        const size_t limit = m_window.size() - MAX_MATCH;
+        size_t out = m_window_end;
+
+        while (out < limit)
+        {
+            const unsigned symbol = decode(*m_litlen);
+            if (symbol < 256)
+            {
+                window[out++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            if (symbol == END_OF_BLOCK)
+            {
+                m_state = m_last_block ? State::DONE : State::BLOCK_HEADER;
+                break;
+            }
+
+            const unsigned length_index = symbol - 257;
+            if (length_index >= 29) fail();
+            const unsigned length = LENGTH_BASE[length_index] + read_bits(LENGTH_EXTRA[length_index]);
+
+            const unsigned dist_index = decode(*m_dist);
+            if (dist_index >= 30) fail();
+            const size_t dist = DIST_BASE[dist_index] + read_bits(DIST_EXTRA[dist_index]);
+            if (dist > out) fail();
+
+            const uint8_t* from = window + out - dist;
+            uint8_t* to = window + out;
+            if (dist >= length)
+            {
+                memcpy(to, from, length);
+            }
+            else
+            {
+                // The match overlaps the bytes it produces, repeating them
+                for (unsigned i = 0; i < length; ++i)
+                {
+                    to[i] = from[i];
+                }
+            }
+
+            out += length;
+        }
+
+        m_window_end = out;
+    }
+
+    bool Inflater::next(const char*& output, size_t& output_size)
+    {
+        // Keep only the history that later matches may refer to
+        if (m_window_end > WINDOW_SIZE)
+        {
+            memmove(m_window.data(), m_window.data() + m_window_end - WINDOW_SIZE, WINDOW_SIZE);
+            m_window_end = WINDOW_SIZE;
+        }
+
+        const size_t start = m_window_end;
+        while (m_state != State::DONE && m_window_end + MAX_MATCH < m_window.size())
+        {
+            switch (m_state)
+            {
+                case State::BLOCK_HEADER: read_block_header(); break;
+                case State::STORED:
+                {
+                    const size_t available = static_cast<size_t>(m_end - m_in);
+                    const size_t count =
+                        std::min({m_stored_remaining, m_window.size() - m_window_end, available});
+                    if (count == 0 && m_stored_remaining != 0) fail();
+                    memcpy(m_window.data() + m_window_end, m_in, count);
+                    m_in += count;
+                    m_window_end += count;
+                    m_stored_remaining -= count;
+                    if (m_stored_remaining == 0)
+                    {
+                        m_state = m_last_block ? State::DONE : State::BLOCK_HEADER;
+                    }
+                    break;
+                }
+                case State::HUFFMAN: decode_huffman(); break;
+                default: Checks::unreachable(VCPKG_LINE_INFO);
+            }
+        }
+
+        if (m_state == State::DONE)
+        {
+            // The stream ends at the byte holding its last bit
+            const unsigned skip = m_bit_count % 8;
+            m_bits >>= skip;
+            m_bit_count -= skip;
+        }
+
+        output = reinterpret_cast<const char*>(m_window.data()) + start;
+        output_size = m_window_end - start;
+        return output_size != 0 || m_state != State::DONE;
+    }
+
+    size_t Inflater::consumed() const { return static_cast<size_t>(m_in - m_begin) - m_bit_count / 8; }
+}
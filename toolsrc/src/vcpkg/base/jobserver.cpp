@@ -0,0 +1,75 @@
+#include "pch.h"
+
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/jobserver.h>
+#include <vcpkg/base/strings.h>
+
+namespace vcpkg::Jobserver
+{
+#if defined(_WIN32)
+    // make on Windows takes the name of a semaphore that counts the free tokens
+    TokenPool::TokenPool(size_t cpus) : m_cpus(cpus)
+    {
+        const std::string name = Strings::format("vcpkg_jobserver_%lu", GetCurrentProcessId());
+        const LONG tokens = static_cast<LONG>(cpus - 1);
+        m_semaphore = CreateSemaphoreW(nullptr, tokens, std::max<LONG>(tokens, 1), Strings::to_utf16(name).c_str());
+        Checks::check_exit(
+            VCPKG_LINE_INFO, m_semaphore != nullptr, "Failed to create the jobserver semaphore: %lu", GetLastError());
+        m_makeflags = Strings::format("-j%zd --jobserver-auth=%s", cpus, name);
+    }
+
+    TokenPool::~TokenPool() { CloseHandle(m_semaphore); }
+
+    void TokenPool::acquire()
+    {
+        const DWORD result = WaitForSingleObject(m_semaphore, INFINITE);
+        Checks::check_exit(VCPKG_LINE_INFO, result == WAIT_OBJECT_0, "Failed to take a jobserver token");
+    }
+
+    void TokenPool::release() { ReleaseSemaphore(m_semaphore, 1, nullptr); }
+#else
+    // Every child process inherits both ends of a pipe that holds one byte per free token
+    TokenPool::TokenPool(size_t cpus) : m_cpus(cpus)
+    {
+        int fds[2];
+        Checks::check_exit(VCPKG_LINE_INFO, pipe(fds) == 0, "Failed to create the jobserver pipe: %d", errno);
+        m_read_fd = fds[0];
+        m_write_fd = fds[1];
+
+        const std::string tokens(cpus - 1, '+');
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           write(m_write_fd, tokens.data(), tokens.size()) == static_cast<ssize_t>(tokens.size()),
+                           "Failed to fill the jobserver pipe: %d",
+                           errno);
+        m_makeflags = Strings::format("-j%zd --jobserver-auth=%d,%d", cpus, m_read_fd, m_write_fd);
+    }
+
+    TokenPool::~TokenPool()
+    {
+        close(m_read_fd);
+        close(m_write_fd);
+    }
+
+    void TokenPool::acquire()
+    {
+        char token;
+        ssize_t result;
+        do
+        {
+            result = read(m_read_fd, &token, 1);
+        } while (result < 0 && errno == EINTR);
+
+        Checks::check_exit(VCPKG_LINE_INFO, result == 1, "Failed to take a jobserver token: %d", errno);
+    }
+
+    void TokenPool::release()
+    {
+        const char token = '+';
+        ssize_t result;
+        do
+        {
+            result = write(m_write_fd, &token, 1);
+        } while (result < 0 && errno == EINTR);
+    }
+#endif
+}
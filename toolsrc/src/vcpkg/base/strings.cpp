@@ -169,4 +169,35 @@ namespace vcpkg::Strings
 
         return output;
     }
+
+    std::string to_json_string(const std::string& str)
+    {
+        std::string encoded = "\"";
+        for (const unsigned char ch : str)
+        {
+            if (ch == '\\')
+            {
+                encoded.append("\\\\");
+            }
+            else if (ch == '"')
+            {
+                encoded.append("\\\"");
+            }
+            else if (ch < 0x20 || ch >= 0x80)
+            {
+                // Note: this treats incoming Strings as Latin-1
+                static constexpr const char HEX[16] = {
+                    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+                encoded.append("\\u00");
+                encoded.push_back(HEX[ch / 16]);
+                encoded.push_back(HEX[ch % 16]);
+            }
+            else
+            {
+                encoded.push_back(ch);
+            }
+        }
+        encoded.push_back('"');
+        return encoded;
+    }
 }
@@ -7,6 +7,14 @@
 
 #include <time.h>
 
+#if !defined(_WIN32)
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif
+
 #pragma comment(lib, "Advapi32")
 
 namespace vcpkg::System
@@ -39,6 +47,15 @@ namespace vcpkg::System
 #endif
     }
 
+    unsigned long get_current_process_id()
+    {
+#if defined(_WIN32)
+        return GetCurrentProcessId();
+#else
+        return static_cast<unsigned long>(getpid());
+#endif
+    }
+
     Optional<CPUArchitecture> to_cpu_architecture(const CStringView& arch)
     {
         if (Strings::case_insensitive_ascii_equals(arch, "x86")) return CPUArchitecture::X86;
@@ -129,7 +146,8 @@ namespace vcpkg::System
             R"(powershell -NoProfile -ExecutionPolicy Bypass -Command "& {& '%s' %s}")", script_path.u8string(), args);
     }
 
-    int cmd_execute_clean(const CStringView cmd_line)
+    ExitCodeAndUsage cmd_execute_clean_with_usage(const CStringView cmd_line,
+                                                  const std::unordered_map<std::string, std::string>& extra_env)
     {
 #if defined(_WIN32)
         static const std::string SYSTEM_ROOT = get_environment_variable("SystemRoot").value_or_exit(VCPKG_LINE_INFO);
@@ -205,6 +223,12 @@ namespace vcpkg::System
         env_cstr.append(L"VSLANG=1033");
         env_cstr.push_back(L'\0');
 
+        for (auto&& name_and_value : extra_env)
+        {
+            env_cstr.append(Strings::to_utf16(name_and_value.first + "=" + name_and_value.second));
+            env_cstr.push_back(L'\0');
+        }
+
         STARTUPINFOW startup_info;
         memset(&startup_info, 0, sizeof(STARTUPINFOW));
         startup_info.cb = sizeof(STARTUPINFOW);
@@ -220,7 +244,7 @@ namespace vcpkg::System
                                                 nullptr,
                                                 nullptr,
                                                 FALSE,
-                                                IDLE_PRIORITY_CLASS | CREATE_UNICODE_ENVIRONMENT,
+                                                IDLE_PRIORITY_CLASS | CREATE_UNICODE_ENVIRONMENT | CREATE_SUSPENDED,
                                                 env_cstr.data(),
                                                 nullptr,
                                                 &startup_info,
@@ -228,6 +252,10 @@ namespace vcpkg::System
 
         Checks::check_exit(VCPKG_LINE_INFO, succeeded, "Process creation failed with error code: %lu", GetLastError());
 
+        // The job accounts for every process that cmd.exe starts. Without it only the exit code is known.
+        const HANDLE job = CreateJobObjectW(nullptr, nullptr);
+        const bool in_job = job != nullptr && AssignProcessToJobObject(job, process_info.hProcess);
+        ResumeThread(process_info.hThread);
         CloseHandle(process_info.hThread);
 
         const DWORD result = WaitForSingleObject(process_info.hProcess, INFINITE);
@@ -235,12 +263,150 @@ namespace vcpkg::System
 
         DWORD exit_code = 0;
         GetExitCodeProcess(process_info.hProcess, &exit_code);
+        CloseHandle(process_info.hProcess);
+
+        ExitCodeAndUsage ret{static_cast<int>(exit_code), {}};
+        if (in_job)
+        {
+            JOBOBJECT_BASIC_AND_IO_ACCOUNTING_INFORMATION accounting;
+            if (QueryInformationJobObject(
+                    job, JobObjectBasicAndIoAccountingInformation, &accounting, sizeof(accounting), nullptr))
+            {
+                // In units of 100ns
+                ret.usage.cpu_time_us =
+                    (accounting.BasicInfo.TotalUserTime.QuadPart + accounting.BasicInfo.TotalKernelTime.QuadPart) / 10;
+                ret.usage.bytes_read = accounting.IoInfo.ReadTransferCount;
+                ret.usage.bytes_written = accounting.IoInfo.WriteTransferCount;
+            }
+
+            JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+            if (QueryInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits), nullptr))
+            {
+                ret.usage.peak_memory_bytes = limits.PeakJobMemoryUsed;
+            }
+        }
+        if (job != nullptr) CloseHandle(job);
 
         Debug::println("CreateProcessW() returned %lu", exit_code);
-        return static_cast<int>(exit_code);
+        return ret;
 #else
+        // The environment of vcpkg, with extra_env replacing variables of the same name
+        std::vector<std::string> env_strings;
+        for (char** entry = environ; *entry != nullptr; ++entry)
+        {
+            const char* const equals = strchr(*entry, '=');
+            if (equals != nullptr && extra_env.find(std::string(*entry, equals - *entry)) != extra_env.end()) continue;
+            env_strings.emplace_back(*entry);
+        }
+        for (auto&& name_and_value : extra_env)
+        {
+            env_strings.push_back(name_and_value.first + "=" + name_and_value.second);
+        }
+
+        std::vector<char*> envp;
+        for (auto&& env_string : env_strings)
+            envp.push_back(&env_string[0]);
+        envp.push_back(nullptr);
+
+        std::string shell_cmd_line = cmd_line.c_str();
+        char sh[] = "sh";
+        char dash_c[] = "-c";
+        char* const argv[] = {sh, dash_c, &shell_cmd_line[0], nullptr};
+
         fflush(nullptr);
-        return system(cmd_line.c_str());
+        Debug::println("posix_spawn(%s)", shell_cmd_line);
+        pid_t pid;
+        const int spawn_error = posix_spawn(&pid, "/bin/sh", nullptr, nullptr, argv, envp.data());
+        Checks::check_exit(
+            VCPKG_LINE_INFO, spawn_error == 0, "Process creation failed with error code: %d", spawn_error);
+
+        // wait4 sums up the usage of the shell and every descendant that was waited for
+        int status = 0;
+        struct rusage usage;
+        pid_t waited;
+        do
+        {
+            waited = wait4(pid, &status, 0, &usage);
+        } while (waited < 0 && errno == EINTR);
+        Checks::check_exit(VCPKG_LINE_INFO, waited == pid, "wait4 failed with error code: %d", errno);
+
+        ExitCodeAndUsage ret;
+        ret.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        ret.usage.cpu_time_us = static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+                                usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#if defined(__APPLE__)
+        ret.usage.peak_memory_bytes = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        ret.usage.peak_memory_bytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+        // Counted in blocks of 512 bytes
+        ret.usage.bytes_read = static_cast<uint64_t>(usage.ru_inblock) * 512;
+        ret.usage.bytes_written = static_cast<uint64_t>(usage.ru_oublock) * 512;
+        ret.usage.context_switches = static_cast<uint64_t>(usage.ru_nvcsw + usage.ru_nivcsw);
+        Debug::println("posix_spawn() returned %d", ret.exit_code);
+        return ret;
+#endif
+    }
+
+    int cmd_execute_clean(const CStringView cmd_line, const std::unordered_map<std::string, std::string>& extra_env)
+    {
+        return cmd_execute_clean_with_usage(cmd_line, extra_env).exit_code;
+    }
+
+    Optional<uint64_t> get_descendants_resident_memory()
+    {
+#if defined(__linux__)
+        struct ProcStat
+        {
+            long pid;
+            long ppid;
+            uint64_t resident_pages;
+        };
+
+        std::vector<ProcStat> processes;
+        std::error_code ec;
+        for (fs::stdfs::directory_iterator it("/proc", ec), end; !ec && it != end; it.increment(ec))
+        {
+            const std::string name = it->path().filename().string();
+            if (name.empty() || !std::isdigit(static_cast<unsigned char>(name[0]))) continue;
+
+            // pid (comm) state ppid ... with the resident set size in pages as the 24th field. The command may
+            // contain spaces and parentheses, so the fields are counted from the last ')'.
+            std::ifstream stat_file(it->path() / "stat");
+            std::string stat;
+            if (!std::getline(stat_file, stat)) continue;
+            const auto comm_end = stat.rfind(')');
+            if (comm_end == std::string::npos) continue;
+
+            // After ") " every field is followed by exactly one space
+            const std::vector<std::string> fields = Strings::split(stat.substr(comm_end + 2), " ");
+            if (fields.size() < 22) continue;
+            processes.push_back({std::atol(name.c_str()),
+                                 std::atol(fields[4 - 3].c_str()),
+                                 std::strtoull(fields[24 - 3].c_str(), nullptr, 10)});
+        }
+        if (processes.empty()) return nullopt;
+
+        std::unordered_map<long, std::vector<const ProcStat*>> children;
+        for (auto&& process : processes)
+            children[process.ppid].push_back(&process);
+
+        uint64_t resident_pages = 0;
+        std::vector<long> pending = {static_cast<long>(getpid())};
+        while (!pending.empty())
+        {
+            const long pid = pending.back();
+            pending.pop_back();
+            for (const ProcStat* child : children[pid])
+            {
+                resident_pages += child->resident_pages;
+                pending.push_back(child->pid);
+            }
+        }
+
+        return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+        return nullopt;
 #endif
     }
 
@@ -27,10 +27,15 @@ namespace vcpkg
     BinaryParagraph::BinaryParagraph() = default;
 
     BinaryParagraph::BinaryParagraph(std::unordered_map<std::string, std::string> fields)
+        : BinaryParagraph(Parse::ParagraphParser(std::move(fields)))
     {
-        using namespace vcpkg::Parse;
+    }
+
+    BinaryParagraph::BinaryParagraph(Parse::ParagraphView fields) : BinaryParagraph(Parse::ParagraphParser(fields)) {}
 
-        ParagraphParser parser(std::move(fields));
+    BinaryParagraph::BinaryParagraph(Parse::ParagraphParser&& parser)
+    {
+        using namespace vcpkg::Parse;
 
         {
             std::string name;
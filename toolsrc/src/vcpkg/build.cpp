@@ -3,10 +3,13 @@
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/chrono.h>
 #include <vcpkg/base/enums.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/jobserver.h>
 #include <vcpkg/base/optional.h>
 #include <vcpkg/base/stringliteral.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/build.h>
+#include <vcpkg/buildhistory.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/dependencies.h>
 #include <vcpkg/globalstate.h>
@@ -61,8 +64,10 @@ namespace vcpkg::Build::Command
                            spec.name());
 
         const StatusParagraphs status_db = database_load_check(paths);
-        const Build::BuildPackageOptions build_package_options{
-            Build::UseHeadVersion::NO, Build::AllowDownloads::YES, Build::CleanBuildtrees::NO};
+        const Build::BuildPackageOptions build_package_options{Build::UseHeadVersion::NO,
+                                                               Build::AllowDownloads::YES,
+                                                               Build::CleanBuildtrees::NO,
+                                                               Build::InstallStrategy::COPY};
 
         const std::unordered_set<std::string> features_as_set(full_spec.features.begin(), full_spec.features.end());
 
@@ -258,37 +263,168 @@ namespace vcpkg::Build
         paths.get_filesystem().write_contents(binary_control_file, start);
     }
 
-    static ExtendedBuildResult do_build_package(const VcpkgPaths& paths,
-                                                const BuildPackageConfig& config,
-                                                const StatusParagraphs& status_db)
+    std::vector<PackageSpec> get_dependency_specs(const SourceControlFile& scf,
+                                                  const std::unordered_set<std::string>& features,
+                                                  const Triplet& triplet)
     {
-        const PackageSpec spec = PackageSpec::from_name_and_triplet(config.scf.core_paragraph->name, config.triplet)
-                                     .value_or_exit(VCPKG_LINE_INFO);
+        std::vector<FeatureSpec> dependencies = filter_dependencies_to_specs(scf.core_paragraph->depends, triplet);
+        for (auto&& feature : scf.feature_paragraphs)
+        {
+            if (!Util::Sets::contains(features, feature->name)) continue;
+            Util::Vectors::concatenate(&dependencies, filter_dependencies_to_specs(feature->depends, triplet));
+        }
 
-        const Triplet& triplet = config.triplet;
+        std::vector<PackageSpec> specs;
+        for (auto&& dependency : dependencies)
         {
-            std::vector<PackageSpec> missing_specs;
-            for (auto&& dep : filter_dependencies(config.scf.core_paragraph->depends, triplet))
-            {
-                auto dep_spec = PackageSpec::from_name_and_triplet(dep, triplet).value_or_exit(VCPKG_LINE_INFO);
-                if (!status_db.is_installed(dep_spec))
-                {
-                    missing_specs.push_back(std::move(dep_spec));
-                }
-            }
-            // Fail the build if any dependencies were missing
-            if (!missing_specs.empty())
+            if (Util::find(specs, dependency.spec()) == specs.end()) specs.push_back(dependency.spec());
+        }
+        return specs;
+    }
+
+    Optional<AbiTagAndInfo> compute_abi_tag(const VcpkgPaths& paths,
+                                            const BuildPackageConfig& config,
+                                            const std::vector<AbiEntry>& dependency_abis)
+    {
+        if (Util::Enum::to_bool(config.build_package_options.use_head_version)) return nullopt;
+
+        auto& fs = paths.get_filesystem();
+        static constexpr auto HASH_ALGORITHM = Hash::Algorithm::SHA1;
+
+        std::vector<AbiEntry> abi_entries = dependency_abis;
+
+        // The CONTROL file, portfile.cmake and patches, followed by the triplet file and ports.cmake
+        std::vector<fs::path> files_to_hash;
+        std::vector<std::string> file_keys;
+        const size_t port_dir_prefix_length = config.port_dir.generic_u8string().size() + 1;
+        for (auto&& file : fs.get_files_recursive(config.port_dir))
+        {
+            if (!fs.is_regular_file(file)) continue;
+            file_keys.push_back(file.generic_u8string().substr(port_dir_prefix_length));
+            files_to_hash.push_back(file);
+        }
+
+        file_keys.push_back("triplet");
+        files_to_hash.push_back(paths.triplets / (config.triplet.canonical_name() + ".cmake"));
+        file_keys.push_back("ports.cmake");
+        files_to_hash.push_back(paths.ports_cmake);
+
+        auto file_hashes = Hash::get_files_hash(files_to_hash, HASH_ALGORITHM);
+        for (size_t i = 0; i < file_hashes.size(); ++i)
+        {
+            if (!file_hashes[i])
             {
-                return {BuildResult::CASCADED_DUE_TO_MISSING_DEPENDENCIES, std::move(missing_specs)};
+                Debug::println("Could not hash %s: %s", files_to_hash[i].u8string(), file_hashes[i].error().message());
+                return nullopt;
             }
+            abi_entries.push_back({std::move(file_keys[i]), std::move(file_hashes[i]).value_or_exit(VCPKG_LINE_INFO)});
+        }
+
+        if (GlobalState::feature_packages)
+        {
+            std::vector<std::string> features(config.feature_list.begin(), config.feature_list.end());
+            std::sort(features.begin(), features.end());
+            abi_entries.push_back({"features", Strings::join(";", features)});
         }
 
+        std::sort(abi_entries.begin(), abi_entries.end(), [](const AbiEntry& left, const AbiEntry& right) {
+            return left.key < right.key;
+        });
+
+        std::string abi_info;
+        for (auto&& entry : abi_entries)
+        {
+            abi_info.append(entry.key).append(" ").append(entry.value).push_back('\n');
+        }
+
+        std::string abi_tag = Hash::get_string_hash(abi_info, HASH_ALGORITHM);
+        return AbiTagAndInfo{std::move(abi_tag), std::move(abi_info)};
+    }
+
+    // Kept next to the build logs, to explain why a package was rebuilt
+    static void write_abi_info(const VcpkgPaths& paths, const BuildPackageConfig& config, const std::string& abi_info)
+    {
+        auto& fs = paths.get_filesystem();
+        std::error_code ec;
+        const fs::path buildtrees_dir = paths.buildtrees / config.scf.core_paragraph->name;
+        const fs::path abi_info_file = buildtrees_dir / (config.triplet.canonical_name() + ".vcpkg_abi_info.txt");
+        fs.create_directories(buildtrees_dir, ec);
+        fs.write_contents(abi_info_file, abi_info, ec);
+        if (ec) Debug::println("Could not write %s: %s", abi_info_file.u8string(), ec.message());
+    }
+
+    static Optional<AbiTagAndInfo> compute_abi_tag(const VcpkgPaths& paths,
+                                                   const BuildPackageConfig& config,
+                                                   const StatusParagraphs& status_db)
+    {
+        std::vector<AbiEntry> dependency_abis;
+        for (auto&& dependency : get_dependency_specs(config.scf, config.feature_list, config.triplet))
+        {
+            const auto it = status_db.find_installed(dependency);
+            if (it == status_db.end() || (*it)->package.abi.empty()) return nullopt;
+            dependency_abis.push_back({dependency.name(), (*it)->package.abi});
+        }
+
+        return compute_abi_tag(paths, config, dependency_abis);
+    }
+
+    static bool restore_from_binary_cache(const VcpkgPaths& paths, const PackageSpec& spec, const fs::path& archive)
+    {
+        auto& fs = paths.get_filesystem();
         const fs::path& cmake_exe_path = paths.get_cmake_exe();
-        const fs::path& git_exe_path = paths.get_git_exe();
+        const fs::path package_dir = paths.package_dir(spec);
+
+        std::error_code ec;
+        fs.remove_all(package_dir, ec);
+        fs.create_directories(package_dir, ec);
+        if (ec) return false;
+
+        const std::string cmd_line = Strings::format(R"("%s" -E chdir "%s" "%s" -E tar xf "%s")",
+                                                     cmake_exe_path.u8string(),
+                                                     package_dir.u8string(),
+                                                     cmake_exe_path.u8string(),
+                                                     archive.u8string());
+        const auto ec_data = System::cmd_execute_and_capture_output(cmd_line);
+        if (ec_data.exit_code == 0) return true;
+
+        System::println(
+            System::Color::warning, "Failed to restore %s from %s:\n%s", spec, archive.u8string(), ec_data.output);
+        fs.remove_all(package_dir, ec);
+        return false;
+    }
 
-        const fs::path ports_cmake_script_path = paths.ports_cmake;
-        const auto pre_build_info = PreBuildInfo::from_triplet_file(paths, triplet);
+    static void write_to_binary_cache(const VcpkgPaths& paths, const PackageSpec& spec, const fs::path& archive)
+    {
+        auto& fs = paths.get_filesystem();
+        const fs::path& cmake_exe_path = paths.get_cmake_exe();
 
+        // Archive to a temporary name first, so that a partial archive is never restored
+        std::error_code ec;
+        const fs::path archive_tmp = archive.parent_path() / (archive.filename().u8string() + ".tmp");
+        fs.create_directories(archive.parent_path(), ec);
+
+        const std::string cmd_line = Strings::format(R"("%s" -E chdir "%s" "%s" -E tar cf "%s" --format=zip .)",
+                                                     cmake_exe_path.u8string(),
+                                                     paths.package_dir(spec).u8string(),
+                                                     cmake_exe_path.u8string(),
+                                                     archive_tmp.u8string());
+        const auto ec_data = System::cmd_execute_and_capture_output(cmd_line);
+        if (ec_data.exit_code == 0) fs.rename(archive_tmp, archive, ec);
+        if (ec_data.exit_code != 0 || ec)
+        {
+            System::println(System::Color::warning, "Failed to add %s to the binary cache", spec);
+            fs.remove(archive_tmp, ec);
+        }
+    }
+
+    /// <summary>
+    /// The command that runs the portfile through ports.cmake, passing `variables` in addition to the usual ones
+    /// </summary>
+    static std::string make_portfile_cmake_cmd(const VcpkgPaths& paths,
+                                               const BuildPackageConfig& config,
+                                               const Toolset& toolset,
+                                               std::vector<System::CMakeVariable> variables)
+    {
         std::string features;
         std::string all_features;
         if (GlobalState::feature_packages)
@@ -307,44 +443,141 @@ namespace vcpkg::Build
             }
         }
 
-        const Toolset& toolset = paths.get_toolset(pre_build_info);
-        const std::string cmd_launch_cmake = System::make_cmake_cmd(
-            cmake_exe_path,
-            ports_cmake_script_path,
+        variables.insert(
+            variables.begin(),
             {
                 {"CMD", "BUILD"},
                 {"PORT", config.scf.core_paragraph->name},
                 {"CURRENT_PORT_DIR", config.port_dir / "/."},
-                {"TARGET_TRIPLET", triplet.canonical_name()},
+                {"TARGET_TRIPLET", config.triplet.canonical_name()},
                 {"VCPKG_PLATFORM_TOOLSET", toolset.version.c_str()},
                 {"VCPKG_USE_HEAD_VERSION",
                  Util::Enum::to_bool(config.build_package_options.use_head_version) ? "1" : "0"},
                 {"_VCPKG_NO_DOWNLOADS", !Util::Enum::to_bool(config.build_package_options.allow_downloads) ? "1" : "0"},
-                {"GIT", git_exe_path},
+                {"GIT", paths.get_git_exe()},
+                {"VCPKG_EXECUTABLE", System::get_exe_path_of_current_process()},
                 {"FEATURES", features},
                 {"ALL_FEATURES", all_features},
             });
 
+        return System::make_cmake_cmd(paths.get_cmake_exe(), paths.ports_cmake, variables);
+    }
+
+    // Guards s_port_mutexes, whose entries are never removed
+    static std::mutex s_port_mutexes_mutex;
+    static std::map<std::string, std::unique_ptr<std::mutex>> s_port_mutexes;
+
+    std::mutex& get_port_mutex(const std::string& port_name)
+    {
+        std::lock_guard<std::mutex> lock(s_port_mutexes_mutex);
+        std::unique_ptr<std::mutex>& port_mutex = s_port_mutexes[port_name];
+        if (!port_mutex) port_mutex = std::make_unique<std::mutex>();
+        return *port_mutex;
+    }
+
+    Jobserver::TokenPool* get_build_jobserver()
+    {
+        static const std::unique_ptr<Jobserver::TokenPool> JOBSERVER =
+            GlobalState::max_cpus != 0 ? std::make_unique<Jobserver::TokenPool>(GlobalState::max_cpus) : nullptr;
+        return JOBSERVER.get();
+    }
+
+    static ExtendedBuildResult do_build_package(const VcpkgPaths& paths,
+                                                const BuildPackageConfig& config,
+                                                const StatusParagraphs& status_db)
+    {
+        const PackageSpec spec = PackageSpec::from_name_and_triplet(config.scf.core_paragraph->name, config.triplet)
+                                     .value_or_exit(VCPKG_LINE_INFO);
+
+        const Triplet& triplet = config.triplet;
+        {
+            std::vector<PackageSpec> missing_specs;
+            for (auto&& dep : filter_dependencies(config.scf.core_paragraph->depends, triplet))
+            {
+                auto dep_spec = PackageSpec::from_name_and_triplet(dep, triplet).value_or_exit(VCPKG_LINE_INFO);
+                if (!status_db.is_installed(dep_spec))
+                {
+                    missing_specs.push_back(std::move(dep_spec));
+                }
+            }
+            // Fail the build if any dependencies were missing
+            if (!missing_specs.empty())
+            {
+                return {BuildResult::CASCADED_DUE_TO_MISSING_DEPENDENCIES, std::move(missing_specs)};
+            }
+        }
+
+        const Optional<AbiTagAndInfo> abi =
+            GlobalState::binary_caching ? compute_abi_tag(paths, config, status_db) : nullopt;
+        if (const auto p_abi = abi.get())
+        {
+            const fs::path archive = paths.archive_path(p_abi->tag);
+            if (paths.get_filesystem().exists(archive))
+            {
+                System::println("Using cached binary package: %s", archive.u8string());
+                if (restore_from_binary_cache(paths, spec, archive))
+                {
+                    auto maybe_bcf = Paragraphs::try_load_cached_control_package(paths, spec);
+                    if (auto p_bcf = maybe_bcf.get())
+                    {
+                        ExtendedBuildResult result{BuildResult::SUCCEEDED,
+                                                   std::make_unique<BinaryControlFile>(std::move(*p_bcf))};
+                        result.restored_from_cache = true;
+                        return result;
+                    }
+                }
+            }
+        }
+
+        if (const auto p_abi = abi.get())
+        {
+            write_abi_info(paths, config, p_abi->info);
+        }
+
+        const auto pre_build_info = PreBuildInfo::from_triplet_file(paths, triplet);
+        const Toolset& toolset = paths.get_toolset(pre_build_info);
+        const std::string cmd_launch_cmake = make_portfile_cmake_cmd(paths, config, toolset, {});
+
         const auto cmd_set_environment = make_build_env_cmd(pre_build_info, toolset);
         const std::string command = Strings::format(R"(%s && %s)", cmd_set_environment, cmd_launch_cmake);
 
         const auto timer = Chrono::ElapsedTimer::create_started();
 
-        const int return_code = System::cmd_execute_clean(command);
+        std::unordered_map<std::string, std::string> build_env;
+        if (const auto jobserver = get_build_jobserver())
+        {
+            build_env.emplace("MAKEFLAGS", jobserver->makeflags());
+        }
+        if (config.concurrency != 0)
+        {
+            build_env.emplace("VCPKG_CONCURRENCY", std::to_string(config.concurrency));
+        }
+
+        const System::ExitCodeAndUsage build_process = System::cmd_execute_clean_with_usage(command, build_env);
         const auto buildtimeus = timer.microseconds();
         const auto spec_string = spec.to_string();
 
         {
             auto locked_metrics = Metrics::g_metrics.lock();
             locked_metrics->track_metric("buildtimeus-" + spec_string, buildtimeus);
-            if (return_code != 0)
+            if (build_process.exit_code != 0)
             {
                 locked_metrics->track_property("error", "build failed");
                 locked_metrics->track_property("build_error", spec_string);
-                return BuildResult::BUILD_FAILED;
+                ExtendedBuildResult result = BuildResult::BUILD_FAILED;
+                result.usage = build_process.usage;
+                return result;
             }
         }
 
+        BuildRecord record;
+        record.port = spec.name();
+        record.triplet = triplet.canonical_name();
+        record.version = config.scf.core_paragraph->version;
+        record.build_time_us = static_cast<uint64_t>(buildtimeus);
+        record.usage = build_process.usage;
+        BuildHistory::record(paths, std::move(record));
+
         const BuildInfo build_info = read_build_info(paths.get_filesystem(), paths.build_info_file_path(spec));
         const size_t error_count = PostBuildLint::perform_all_checks(spec, paths, pre_build_info, build_info);
 
@@ -352,7 +585,9 @@ namespace vcpkg::Build
 
         if (error_count != 0)
         {
-            return BuildResult::POST_BUILD_CHECKS_FAILED;
+            ExtendedBuildResult result = BuildResult::POST_BUILD_CHECKS_FAILED;
+            result.usage = build_process.usage;
+            return result;
         }
         if (GlobalState::feature_packages)
         {
@@ -367,15 +602,28 @@ namespace vcpkg::Build
             }
         }
 
+        if (const auto p_abi = abi.get())
+        {
+            bcf->core_paragraph.abi = p_abi->tag;
+        }
+
         write_binary_control_file(paths, *bcf);
 
-        return {BuildResult::SUCCEEDED, std::move(bcf)};
+        if (const auto p_abi = abi.get())
+        {
+            write_to_binary_cache(paths, spec, paths.archive_path(p_abi->tag));
+        }
+
+        ExtendedBuildResult result{BuildResult::SUCCEEDED, std::move(bcf)};
+        result.usage = build_process.usage;
+        return result;
     }
 
     ExtendedBuildResult build_package(const VcpkgPaths& paths,
                                       const BuildPackageConfig& config,
                                       const StatusParagraphs& status_db)
     {
+        std::lock_guard<std::mutex> port_lock(get_port_mutex(config.scf.core_paragraph->name));
         ExtendedBuildResult result = do_build_package(paths, config, status_db);
 
         if (config.build_package_options.clean_buildtrees == CleanBuildtrees::YES)
@@ -396,6 +644,28 @@ namespace vcpkg::Build
         return result;
     }
 
+    DownloadSourcesResult download_sources(const VcpkgPaths& paths, const BuildPackageConfig& config)
+    {
+        auto& fs = paths.get_filesystem();
+        const std::string& port_name = config.scf.core_paragraph->name;
+        const fs::path failure_file =
+            paths.buildtrees / port_name / Strings::format("download-failure-%s.log", config.triplet.canonical_name());
+        std::error_code ec;
+        fs.remove(failure_file, ec);
+
+        // The build environment is left out: downloading needs no compiler, and setting it up can take seconds
+        const auto pre_build_info = PreBuildInfo::from_triplet_file(paths, config.triplet);
+        const Toolset& toolset = paths.get_toolset(pre_build_info);
+        const std::string command = make_portfile_cmake_cmd(
+            paths, config, toolset, {{"VCPKG_DOWNLOAD_MODE", "1"}, {"VCPKG_DOWNLOAD_FAILURE_FILE", failure_file}});
+
+        // The portfile stops with an error at its first build step, so its exit code means nothing here
+        const auto ec_data = System::cmd_execute_and_capture_output(command);
+        const bool succeeded = !fs.exists(failure_file);
+        fs.remove(failure_file, ec);
+        return {succeeded, ec_data.output};
+    }
+
     const std::string& to_string(const BuildResult build_result)
     {
         static const std::string NULLVALUE_STRING = Enums::nullvalue_to_string("vcpkg::Commands::Build::BuildResult");
@@ -436,9 +706,9 @@ namespace vcpkg::Build
                                Commands::Version::version());
     }
 
-    static BuildInfo inner_create_buildinfo(std::unordered_map<std::string, std::string> pgh)
+    static BuildInfo inner_create_buildinfo(Parse::ParagraphView pgh)
     {
-        Parse::ParagraphParser parser(std::move(pgh));
+        Parse::ParagraphParser parser(pgh);
 
         BuildInfo build_info;
 
@@ -493,19 +763,21 @@ namespace vcpkg::Build
 
     BuildInfo read_build_info(const Files::Filesystem& fs, const fs::path& filepath)
     {
-        const Expected<std::unordered_map<std::string, std::string>> pghs =
-            Paragraphs::get_single_paragraph(fs, filepath);
-        Checks::check_exit(VCPKG_LINE_INFO, pghs.get() != nullptr, "Invalid BUILD_INFO file for package");
-        return inner_create_buildinfo(*pghs.get());
+        const Expected<Paragraphs::ParsedParagraphs> pghs = Paragraphs::get_parsed_paragraphs(fs, filepath);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           pghs.get() != nullptr && pghs.get()->size() == 1,
+                           "Invalid BUILD_INFO file for package");
+        return inner_create_buildinfo((*pghs.get())[0]);
     }
 
-    PreBuildInfo PreBuildInfo::from_triplet_file(const VcpkgPaths& paths, const Triplet& triplet)
+    // Runs the triplet file in a "capture" mode and returns its VARIABLE=VALUE lines
+    static std::vector<std::string> capture_triplet_variables(const VcpkgPaths& paths,
+                                                              const fs::path& triplet_file_path)
     {
         static constexpr CStringView FLAG_GUID = "c35112b6-d1ba-415b-aa5d-81de856ef8eb";
 
         const fs::path& cmake_exe_path = paths.get_cmake_exe();
         const fs::path ports_cmake_script_path = paths.scripts / "get_triplet_environment.cmake";
-        const fs::path triplet_file_path = paths.triplets / (triplet.canonical_name() + ".cmake");
 
         const auto cmd_launch_cmake = System::make_cmake_cmd(cmake_exe_path,
                                                              ports_cmake_script_path,
@@ -517,16 +789,17 @@ namespace vcpkg::Build
 
         const std::vector<std::string> lines = Strings::split(ec_data.output, "\n");
 
-        PreBuildInfo pre_build_info;
+        auto cur = std::find(lines.cbegin(), lines.cend(), FLAG_GUID);
+        if (cur != lines.cend()) ++cur;
+        return std::vector<std::string>(cur, lines.cend());
+    }
 
-        const auto e = lines.cend();
-        auto cur = std::find(lines.cbegin(), e, FLAG_GUID);
-        if (cur != e) ++cur;
+    static PreBuildInfo parse_triplet_variables(const std::vector<std::string>& lines)
+    {
+        PreBuildInfo pre_build_info;
 
-        for (; cur != e; ++cur)
+        for (auto&& line : lines)
         {
-            auto&& line = *cur;
-
             const std::vector<std::string> s = Strings::split(line, "=");
             Checks::check_exit(VCPKG_LINE_INFO,
                                s.size() == 1 || s.size() == 2,
@@ -595,6 +868,83 @@ namespace vcpkg::Build
 
         return pre_build_info;
     }
+
+    // Whether the variables of the triplet may depend on more than the triplet file itself
+    static bool triplet_reads_other_inputs(const std::string& triplet_contents)
+    {
+        static const std::regex OTHER_INPUTS_REGEX(R"(\binclude\s*\(|\$ENV\{)", std::regex::icase);
+        return std::regex_search(triplet_contents, OTHER_INPUTS_REGEX);
+    }
+
+    static std::vector<std::string> load_triplet_variables(const VcpkgPaths& paths,
+                                                           const Triplet& triplet,
+                                                           const fs::path& triplet_file_path)
+    {
+        // The captured variables are also kept on disk, along with the hashes of the files that produced them.
+        // Triplets that include other files or read the environment are captured on every run instead, since
+        // those inputs are not tracked.
+        auto& fs = paths.get_filesystem();
+        const Expected<std::string> triplet_contents = fs.read_contents(triplet_file_path);
+        const auto p_triplet_contents = triplet_contents.get();
+        const auto script_hash =
+            Hash::get_file_hash(paths.scripts / "get_triplet_environment.cmake", Hash::Algorithm::SHA256);
+        const auto p_script_hash = script_hash.get();
+        if (!p_triplet_contents || !p_script_hash || triplet_reads_other_inputs(*p_triplet_contents))
+        {
+            return capture_triplet_variables(paths, triplet_file_path);
+        }
+
+        const std::string cache_key =
+            Hash::get_string_hash(*p_triplet_contents, Hash::Algorithm::SHA256) + " " + *p_script_hash + " ";
+        const fs::path cache_file_path =
+            paths.buildtrees / "triplet_environments" / (triplet.canonical_name() + ".txt");
+        auto maybe_cached_lines = fs.read_lines(cache_file_path);
+        if (const auto cached_lines = maybe_cached_lines.get())
+        {
+            if (cached_lines->size() > 1 && cached_lines->front() == cache_key)
+            {
+                return std::vector<std::string>(std::next(cached_lines->begin()), cached_lines->end());
+            }
+        }
+
+        std::vector<std::string> lines = capture_triplet_variables(paths, triplet_file_path);
+        std::error_code ec;
+        const std::string contents = cache_key + "\n" + Strings::join("\n", lines);
+        Files::write_contents_atomically(fs, cache_file_path, contents, ec);
+        if (ec) Debug::println("Could not write %s: %s", cache_file_path.u8string(), ec.message());
+        return lines;
+    }
+
+    PreBuildInfo PreBuildInfo::from_triplet_file(const VcpkgPaths& paths, const Triplet& triplet)
+    {
+        // Keyed by triplet file path. Each entry has its own lock, held while capturing, so each triplet runs CMake
+        // at most once while different triplets are captured side by side.
+        struct TripletEnvironment
+        {
+            std::mutex mutex;
+            std::unique_ptr<PreBuildInfo> pre_build_info;
+        };
+        static Util::LockGuarded<std::unordered_map<std::string, std::unique_ptr<TripletEnvironment>>>
+            s_triplet_environments;
+
+        const fs::path triplet_file_path = paths.triplets / (triplet.canonical_name() + ".cmake");
+        TripletEnvironment* environment;
+        {
+            auto triplet_environments = s_triplet_environments.lock();
+            auto& entry = (*triplet_environments)[triplet_file_path.u8string()];
+            if (!entry) entry = std::make_unique<TripletEnvironment>();
+            environment = entry.get();
+        }
+
+        std::lock_guard<std::mutex> lock(environment->mutex);
+        if (!environment->pre_build_info)
+        {
+            environment->pre_build_info = std::make_unique<PreBuildInfo>(
+                parse_triplet_variables(load_triplet_variables(paths, triplet, triplet_file_path)));
+        }
+        return *environment->pre_build_info;
+    }
+
     ExtendedBuildResult::ExtendedBuildResult(BuildResult code) : code(code) {}
     ExtendedBuildResult::ExtendedBuildResult(BuildResult code, std::unique_ptr<BinaryControlFile>&& bcf)
         : code(code), binary_control_file(std::move(bcf))
@@ -0,0 +1,114 @@
+#include "pch.h"
+
+#include <vcpkg/buildhistory.h>
+#include <vcpkg/paragraphs.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+
+namespace vcpkg
+{
+    namespace BuildHistoryFields
+    {
+        static const std::string PORT = "Port";
+        static const std::string TRIPLET = "Triplet";
+        static const std::string VERSION = "Version";
+        static const std::string BUILD_TIME_US = "Build-Time-Us";
+        static const std::string CPU_TIME_US = "Cpu-Time-Us";
+        static const std::string PEAK_MEMORY_BYTES = "Peak-Memory-Bytes";
+    }
+
+    // Guards paths.build_history_file against concurrent updates from this process
+    static std::mutex s_build_history_mutex;
+
+    static uint64_t parse_count(const Paragraphs::RawParagraph& pgh, const std::string& field)
+    {
+        const auto it = pgh.find(field);
+        if (it == pgh.end()) return 0;
+        return std::strtoull(it->second.c_str(), nullptr, 10);
+    }
+
+    static std::vector<BuildRecord> read_records(const Files::Filesystem& fs, const fs::path& history_file)
+    {
+        std::vector<BuildRecord> records;
+        auto maybe_paragraphs = Paragraphs::get_paragraphs(fs, history_file);
+        const auto paragraphs = maybe_paragraphs.get();
+        if (!paragraphs) return records;
+
+        for (auto&& pgh : *paragraphs)
+        {
+            const auto port = pgh.find(BuildHistoryFields::PORT);
+            const auto triplet = pgh.find(BuildHistoryFields::TRIPLET);
+            const auto version = pgh.find(BuildHistoryFields::VERSION);
+            if (port == pgh.end() || triplet == pgh.end() || version == pgh.end()) continue;
+
+            BuildRecord record;
+            record.port = port->second;
+            record.triplet = triplet->second;
+            record.version = version->second;
+            record.build_time_us = parse_count(pgh, BuildHistoryFields::BUILD_TIME_US);
+            record.usage.cpu_time_us = parse_count(pgh, BuildHistoryFields::CPU_TIME_US);
+            record.usage.peak_memory_bytes = parse_count(pgh, BuildHistoryFields::PEAK_MEMORY_BYTES);
+            records.push_back(std::move(record));
+        }
+
+        return records;
+    }
+
+    BuildHistory BuildHistory::load(const VcpkgPaths& paths)
+    {
+        BuildHistory history;
+        std::lock_guard<std::mutex> lock(s_build_history_mutex);
+        history.m_records = read_records(paths.get_filesystem(), paths.build_history_file);
+        return history;
+    }
+
+    Optional<const BuildRecord&> BuildHistory::find(const PackageSpec& spec, const std::string& version) const
+    {
+        const std::string triplet = spec.triplet().canonical_name();
+        const BuildRecord* other_version = nullptr;
+        for (auto&& record : m_records)
+        {
+            if (record.port != spec.name() || record.triplet != triplet) continue;
+            if (record.version == version) return record;
+            other_version = &record;
+        }
+
+        if (other_version) return *other_version;
+        return nullopt;
+    }
+
+    void BuildHistory::record(const VcpkgPaths& paths, BuildRecord&& record)
+    {
+        auto& fs = paths.get_filesystem();
+        std::lock_guard<std::mutex> lock(s_build_history_mutex);
+
+        // Records are kept in the order they were made, so the last build of each port comes last
+        std::vector<BuildRecord> records = read_records(fs, paths.build_history_file);
+        Util::erase_remove_if(records, [&](const BuildRecord& r) {
+            return r.port == record.port && r.triplet == record.triplet && r.version == record.version;
+        });
+        records.push_back(std::move(record));
+
+        std::string contents;
+        const auto append_field = [&](const std::string& name, const std::string& value) {
+            contents.append(name).append(": ").append(value).push_back('\n');
+        };
+        for (auto&& r : records)
+        {
+            if (!contents.empty()) contents.push_back('\n');
+            append_field(BuildHistoryFields::PORT, r.port);
+            append_field(BuildHistoryFields::TRIPLET, r.triplet);
+            append_field(BuildHistoryFields::VERSION, r.version);
+            append_field(BuildHistoryFields::BUILD_TIME_US, std::to_string(r.build_time_us));
+            append_field(BuildHistoryFields::CPU_TIME_US, std::to_string(r.usage.cpu_time_us));
+            append_field(BuildHistoryFields::PEAK_MEMORY_BYTES, std::to_string(r.usage.peak_memory_bytes));
+        }
+
+        std::error_code ec;
+        Files::write_contents_atomically(fs, paths.build_history_file, contents, ec);
+        if (ec) Debug::println("Could not write %s: %s", paths.build_history_file.u8string(), ec.message());
+    }
+}
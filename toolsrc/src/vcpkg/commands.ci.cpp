@@ -10,6 +10,7 @@
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
 #include <vcpkg/install.h>
+#include <vcpkg/ownsindex.h>
 #include <vcpkg/vcpkglib.h>
 
 namespace vcpkg::Commands::CI
@@ -21,7 +22,8 @@ namespace vcpkg::Commands::CI
     static Install::InstallSummary run_ci_on_triplet(const Triplet& triplet,
                                                      const VcpkgPaths& paths,
                                                      const std::vector<std::string>& ports,
-                                                     const std::set<std::string>& exclusions_set)
+                                                     const std::set<std::string>& exclusions_set,
+                                                     const size_t jobs)
     {
         Input::check_triplet(triplet, paths);
 
@@ -46,6 +48,7 @@ namespace vcpkg::Commands::CI
             Build::UseHeadVersion::NO,
             Build::AllowDownloads::YES,
             Build::CleanBuildtrees::YES,
+            Build::InstallStrategy::CLONE,
         };
 
         const std::vector<Dependencies::AnyAction> action_plan =
@@ -54,7 +57,7 @@ namespace vcpkg::Commands::CI
                 return Dependencies::AnyAction(std::move(install_action));
             });
 
-        return Install::perform(action_plan, Install::KeepGoing::YES, paths, status_db);
+        return Install::perform(action_plan, Install::KeepGoing::YES, paths, status_db, jobs);
     }
 
     struct TripletAndSummary
@@ -65,10 +68,14 @@ namespace vcpkg::Commands::CI
 
     static constexpr StringLiteral OPTION_EXCLUDE = "--exclude";
     static constexpr StringLiteral OPTION_XUNIT = "--x-xunit";
+    static constexpr StringLiteral OPTION_JSON = "--x-json";
+    static constexpr StringLiteral OPTION_JOBS = "--x-jobs";
 
-    static constexpr std::array<CommandSetting, 2> CI_SETTINGS = {{
+    static constexpr std::array<CommandSetting, 4> CI_SETTINGS = {{
         {OPTION_EXCLUDE, "Comma separated list of ports to skip"},
         {OPTION_XUNIT, "File to output results in XUnit format (internal)"},
+        {OPTION_JSON, "File to output results, with the resources each build used, in JSON format"},
+        {OPTION_JOBS, "Number of ports to build concurrently (0 for one per hardware thread)"},
     }};
 
     const CommandStructure COMMAND_STRUCTURE = {
@@ -91,6 +98,9 @@ namespace vcpkg::Commands::CI
             exclusions_set.insert(exclusions.begin(), exclusions.end());
         }
 
+        const auto it_jobs = options.settings.find(OPTION_JOBS);
+        const size_t jobs = it_jobs == options.settings.end() ? 1 : Install::parse_jobs(it_jobs->second);
+
         std::vector<Triplet> triplets;
         for (const std::string& triplet : args.command_arguments)
         {
@@ -103,13 +113,35 @@ namespace vcpkg::Commands::CI
         }
 
         const std::vector<std::string> ports = Install::get_all_port_names(paths);
-        std::vector<TripletAndSummary> results;
-        for (const Triplet& triplet : triplets)
+        std::vector<TripletAndSummary> results(triplets.size());
+        if (triplets.size() > 1 && jobs > 1)
+        {
+            // The triplets share the process's budget of jobs, so building them together keeps the machine busy
+            // while one triplet waits on a long chain of dependencies
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < triplets.size(); ++i)
+            {
+                threads.emplace_back([&, i]() {
+                    results[i].triplet = triplets[i];
+                    results[i].summary = run_ci_on_triplet(triplets[i], paths, ports, exclusions_set, jobs);
+                });
+            }
+
+            for (auto&& thread : threads)
+                thread.join();
+        }
+        else
         {
-            Install::InstallSummary summary = run_ci_on_triplet(triplet, paths, ports, exclusions_set);
-            results.push_back({triplet, std::move(summary)});
+            for (size_t i = 0; i < triplets.size(); ++i)
+            {
+                results[i].triplet = triplets[i];
+                results[i].summary = run_ci_on_triplet(triplets[i], paths, ports, exclusions_set, jobs);
+            }
         }
 
+        // Each triplet's status database only knows its own changes, so the index is built from a fresh load
+        OwnsIndex(paths.vcpkg_dir_owns_index).update(paths, database_load_check(paths));
+
         for (auto&& result : results)
         {
             System::println("\nTriplet: %s", result.triplet);
@@ -129,6 +161,20 @@ namespace vcpkg::Commands::CI
             paths.get_filesystem().write_contents(fs::u8path(it_xunit->second), xunit_doc);
         }
 
+        auto it_json = options.settings.find(OPTION_JSON);
+        if (it_json != options.settings.end())
+        {
+            std::vector<std::string> json_results;
+            for (auto&& result : results)
+            {
+                std::string triplet_results = result.summary.json_results();
+                if (!triplet_results.empty()) json_results.push_back(std::move(triplet_results));
+            }
+
+            const std::string json_doc = "{\"results\": [\n" + Strings::join(",\n", json_results) + "\n]}\n";
+            paths.get_filesystem().write_contents(fs::u8path(it_json->second), json_doc);
+        }
+
         Checks::exit_success(VCPKG_LINE_INFO);
     }
 }
@@ -43,6 +43,7 @@ namespace vcpkg::Commands
             {"portsdiff", &PortsDiff::perform_and_exit},
             {"autocomplete", &Autocomplete::perform_and_exit},
             {"hash", &Hash::perform_and_exit},
+            {"x-extract", &Extract::perform_and_exit},
             };
         return t;
     }
@@ -21,8 +21,7 @@ namespace vcpkg::Commands::DependInfo
     {
         args.parse_arguments(COMMAND_STRUCTURE);
 
-        std::vector<std::unique_ptr<SourceControlFile>> source_control_files =
-            Paragraphs::load_all_ports(paths.get_filesystem(), paths.ports);
+        std::vector<std::unique_ptr<SourceControlFile>> source_control_files = Paragraphs::load_all_ports(paths);
 
         if (args.command_arguments.size() == 1)
         {
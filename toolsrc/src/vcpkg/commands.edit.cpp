@@ -36,7 +36,7 @@ namespace vcpkg::Commands::Edit
 
     static std::vector<std::string> valid_arguments(const VcpkgPaths& paths)
     {
-        auto sources_and_errors = Paragraphs::try_load_all_ports(paths.get_filesystem(), paths.ports);
+        auto sources_and_errors = Paragraphs::try_load_all_ports(paths);
 
         return Util::fmap(sources_and_errors.paragraphs,
                           [](auto&& pgh) -> std::string { return pgh->core_paragraph->name; });
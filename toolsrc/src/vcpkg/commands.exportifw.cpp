@@ -448,7 +448,8 @@ namespace vcpkg::Export::IFW
                                                                       ifw_package_dir_path / "vcpkg" / "info" /
                                                                           (binary_paragraph.fullstem() + ".list"));
 
-            Install::install_files_and_write_listfile(paths.get_filesystem(), paths.package_dir(action.spec), dirs);
+            Install::install_files_and_write_listfile(
+                paths.get_filesystem(), paths.package_dir(action.spec), dirs, Build::InstallStrategy::CLONE);
             System::println("Exporting package %s... done", display_name);
         }
 
@@ -0,0 +1,146 @@
+#include "pch.h"
+
+#include <vcpkg/base/archives.h>
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/stringliteral.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/commands.h>
+#include <vcpkg/help.h>
+
+namespace vcpkg::Commands::Extract
+{
+    static constexpr StringLiteral OPTION_SHA512 = "--sha512";
+
+    static constexpr std::array<CommandSetting, 1> EXTRACT_SETTINGS = {{
+        {OPTION_SHA512, "Expected SHA512 of the archive, checked while it is extracted"},
+    }};
+
+    const CommandStructure COMMAND_STRUCTURE = {
+        Strings::format("The arguments should be an archive and the directory to extract it into\n%s",
+                        Help::create_example_string("x-extract downloads/zlib1211.tar.gz buildtrees/zlib/src")),
+        2,
+        2,
+        {{}, EXTRACT_SETTINGS},
+        nullptr,
+    };
+
+    /// <summary>
+    /// Moves the contents of one directory into another, merging directories that exist in both and replacing
+    /// everything else
+    /// </summary>
+    static void merge_directory(Files::Filesystem& fs, const fs::path& from, const fs::path& to)
+    {
+        for (const fs::path& source : fs.get_files_non_recursive(from))
+        {
+            const fs::path target = to / source.filename();
+            std::error_code ec;
+            const bool both_directories = fs::is_directory(fs.symlink_status(source, ec)) &&
+                                          fs::is_directory(fs.symlink_status(target, ec));
+            if (both_directories)
+            {
+                merge_directory(fs, source, target);
+                continue;
+            }
+
+            fs.remove_all(target, ec);
+            fs.rename(source, target, ec);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               !ec,
+                               "Failed to move %s to %s: %s",
+                               source.u8string(),
+                               target.u8string(),
+                               ec.message());
+        }
+    }
+
+    static void extract_with_cmake(const VcpkgPaths& paths, const fs::path& archive, const fs::path& destination)
+    {
+        const std::string cmake = paths.get_cmake_exe().u8string();
+        const std::string cmd_line = Strings::format(
+            R"("%s" -E chdir "%s" "%s" -E tar xf "%s")", cmake, destination.u8string(), cmake, archive.u8string());
+        const auto ec_data = System::cmd_execute_and_capture_output(cmd_line);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           ec_data.exit_code == 0,
+                           "Failed to extract %s:\n%s",
+                           archive.u8string(),
+                           ec_data.output);
+    }
+
+    static void check_hash(Files::Filesystem& fs,
+                           vcpkg::Hash::Hasher& hasher,
+                           const std::string& expected_hash,
+                           const std::string& label,
+                           const fs::path& staging)
+    {
+        const std::string actual_hash = hasher.get_hash();
+        if (actual_hash == expected_hash) return;
+
+        std::error_code ec;
+        fs.remove_all(staging, ec);
+        System::println(System::Color::error,
+                        "\nFile does not have expected hash:\n"
+                        "        File path: [ %s ]\n"
+                        "    Expected hash: [ %s ]\n"
+                        "      Actual hash: [ %s ]\n"
+                        "Please delete the file and retry if this file should be downloaded again.",
+                        label,
+                        expected_hash,
+                        actual_hash);
+        Checks::exit_fail(VCPKG_LINE_INFO);
+    }
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
+        const fs::path archive = fs::u8path(args.command_arguments[0]);
+        const fs::path destination = fs::u8path(args.command_arguments[1]);
+        const std::string label = archive.u8string();
+
+        std::string expected_hash;
+        std::unique_ptr<vcpkg::Hash::Hasher> hasher;
+        const auto it_hash = options.settings.find(OPTION_SHA512);
+        if (it_hash != options.settings.end())
+        {
+            expected_hash = Strings::ascii_to_lowercase(it_hash->second);
+            hasher = vcpkg::Hash::get_hasher_for(vcpkg::Hash::Algorithm::SHA512);
+        }
+
+        auto maybe_file = Files::MappedFile::open(archive);
+        const auto file = maybe_file.get();
+        Checks::check_exit(VCPKG_LINE_INFO, file != nullptr, "Could not open archive %s", label);
+
+        // Nothing reaches the destination until the hash is known to match
+        auto& fs = paths.get_filesystem();
+        const fs::path staging = destination / (".x-extract-" + archive.filename().u8string());
+        std::error_code ec;
+        fs.remove_all(staging, ec);
+        fs.create_directories(staging, ec);
+        Checks::check_exit(VCPKG_LINE_INFO, !ec, "Failed to create %s: %s", staging.u8string(), ec.message());
+
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        const Archives::ArchiveFormat format = Archives::detect_format(file->data(), file->size());
+        const bool extracted_natively = format != Archives::ArchiveFormat::OTHER &&
+                                        Archives::extract(fs, *file, format, staging, hasher.get(), label);
+        if (!extracted_natively)
+        {
+            Debug::println("Extracting %s with CMake", label);
+            // Checking first saves extracting a bad archive
+            if (hasher)
+            {
+                hasher->add_bytes(file->data(), file->size());
+                check_hash(fs, *hasher, expected_hash, label, staging);
+                hasher.reset();
+            }
+
+            file->reset();
+            extract_with_cmake(paths, fs::stdfs::absolute(archive), staging);
+        }
+
+        if (hasher) check_hash(fs, *hasher, expected_hash, label, staging);
+        merge_directory(fs, staging, destination);
+        fs.remove_all(staging, ec);
+        Debug::println("Extracted %s in %s", label, timer.to_string());
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+}
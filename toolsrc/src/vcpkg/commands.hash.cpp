@@ -1,5 +1,6 @@
 #include "pch.h"
 
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/commands.h>
@@ -7,7 +8,10 @@
 
 namespace vcpkg::Commands::Hash
 {
-    static void do_file_hash(fs::path const& cmake_exe_path, fs::path const& path, std::string const& hash_type)
+    // For algorithms without a native implementation
+    static std::string get_file_hash_from_cmake(fs::path const& cmake_exe_path,
+                                                fs::path const& path,
+                                                std::string const& hash_type)
     {
         const std::string cmd_line = Strings::format(
             R"("%s" -E %ssum %s)", cmake_exe_path.u8string(), Strings::ascii_to_lowercase(hash_type), path.u8string());
@@ -27,7 +31,7 @@ namespace vcpkg::Commands::Hash
 
         auto hash = output.substr(0, start);
         Util::erase_remove_if(hash, isspace);
-        System::println(hash);
+        return hash;
     }
 
     const CommandStructure COMMAND_STRUCTURE = {
@@ -39,17 +43,34 @@ namespace vcpkg::Commands::Hash
         nullptr,
     };
 
+    static std::string get_file_hash(const VcpkgPaths& paths, fs::path const& path, std::string const& hash_type)
+    {
+        const auto maybe_algo = vcpkg::Hash::algorithm_from_string(hash_type);
+        if (const auto algo = maybe_algo.get())
+        {
+            auto maybe_hash = vcpkg::Hash::get_file_hash(path, *algo);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               maybe_hash.has_value(),
+                               "Failed to hash %s: %s",
+                               path.u8string(),
+                               maybe_hash.error().message());
+            return std::move(maybe_hash).value_or_exit(VCPKG_LINE_INFO);
+        }
+
+        return get_file_hash_from_cmake(paths.get_cmake_exe(), path, hash_type);
+    }
+
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
     {
         args.parse_arguments(COMMAND_STRUCTURE);
 
         if (args.command_arguments.size() == 1)
         {
-            do_file_hash(paths.get_cmake_exe(), args.command_arguments[0], "SHA512");
+            System::println(get_file_hash(paths, args.command_arguments[0], "SHA512"));
         }
         if (args.command_arguments.size() == 2)
         {
-            do_file_hash(paths.get_cmake_exe(), args.command_arguments[0], args.command_arguments[1]);
+            System::println(get_file_hash(paths, args.command_arguments[0], args.command_arguments[1]));
         }
 
         Checks::exit_success(VCPKG_LINE_INFO);
@@ -3,41 +3,54 @@
 #include <vcpkg/base/system.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/help.h>
+#include <vcpkg/ownsindex.h>
 #include <vcpkg/vcpkglib.h>
 
 namespace vcpkg::Commands::Owns
 {
-    static void search_file(const VcpkgPaths& paths, const std::string& file_substr, const StatusParagraphs& status_db)
+    static constexpr StringLiteral OPTION_EXACT = "--x-exact";
+
+    static void search_file(const VcpkgPaths& paths,
+                            const std::string& file_substr,
+                            const StatusParagraphs& status_db,
+                            bool exact_filename)
     {
-        const std::vector<StatusParagraphAndAssociatedFiles> installed_files = get_installed_files(paths, status_db);
-        for (const StatusParagraphAndAssociatedFiles& pgh_and_file : installed_files)
+        OwnsIndex index(paths.vcpkg_dir_owns_index);
+        index.update(paths, status_db);
+
+        for (const std::unique_ptr<StatusParagraph>& pgh : status_db)
         {
-            const StatusParagraph& pgh = pgh_and_file.pgh;
+            if (!pgh->is_installed() || !pgh->package.feature.empty())
+            {
+                continue;
+            }
 
-            for (const std::string& file : pgh_and_file.files)
+            for (const std::string& file : index.find_files(pgh->package.fullstem(), file_substr, exact_filename))
             {
-                if (file.find(file_substr) != std::string::npos)
-                {
-                    System::println("%s: %s", pgh.package.displayname(), file);
-                }
+                System::println("%s: %s", pgh->package.displayname(), file);
             }
         }
     }
+
+    static constexpr std::array<CommandSwitch, 1> OWNS_SWITCHES = {{
+        {OPTION_EXACT, "Only match files whose name is exactly the argument"},
+    }};
+
     const CommandStructure COMMAND_STRUCTURE = {
         Strings::format("The argument should be a pattern to search for. %s",
                         Help::create_example_string("owns zlib.dll")),
         1,
         1,
-        {},
+        {OWNS_SWITCHES, {}},
         nullptr,
     };
 
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
     {
-        args.parse_arguments(COMMAND_STRUCTURE);
+        const ParsedArguments options = args.parse_arguments(COMMAND_STRUCTURE);
 
         const StatusParagraphs status_db = database_load_check(paths);
-        search_file(paths, args.command_arguments[0], status_db);
+        search_file(paths, args.command_arguments[0], status_db, Util::Sets::contains(options.switches, OPTION_EXACT));
         Checks::exit_success(VCPKG_LINE_INFO);
     }
 }
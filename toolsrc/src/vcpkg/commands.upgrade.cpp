@@ -6,6 +6,7 @@
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
 #include <vcpkg/install.h>
+#include <vcpkg/ownsindex.h>
 #include <vcpkg/statusparagraphs.h>
 #include <vcpkg/update.h>
 #include <vcpkg/vcpkglib.h>
@@ -145,6 +146,7 @@ namespace vcpkg::Commands::Upgrade
             Build::UseHeadVersion::NO,
             Build::AllowDownloads::YES,
             Build::CleanBuildtrees::NO,
+            Build::InstallStrategy::CLONE,
         };
 
         // Set build settings for all install actions
@@ -166,9 +168,11 @@ namespace vcpkg::Commands::Upgrade
             Checks::exit_fail(VCPKG_LINE_INFO);
         }
 
-        const Install::InstallSummary summary = Install::perform(plan, keep_going, paths, status_db);
+        const Install::InstallSummary summary = Install::perform(plan, keep_going, paths, status_db, 1);
+        OwnsIndex(paths.vcpkg_dir_owns_index).update(paths, status_db);
 
-        System::println("\nTotal elapsed time: %s\n", summary.total_elapsed_time);
+        System::println("\nTotal elapsed time: %s", summary.total_elapsed_time);
+        System::println("Installed files: %s\n", summary.file_counts.to_string());
 
         if (keep_going == KeepGoing::YES)
         {
@@ -249,7 +249,11 @@ namespace vcpkg::Dependencies
         return scf->second;
     }
 
-    PathsPortFileProvider::PathsPortFileProvider(const VcpkgPaths& paths) : ports(paths) {}
+    // Only the ports a plan needs are loaded here, which is too few to write the index back, so it is only read
+    PathsPortFileProvider::PathsPortFileProvider(const VcpkgPaths& paths)
+        : ports(paths), index(paths.ports_index_file, UpdatePortIndex::NO)
+    {
+    }
 
     Optional<const SourceControlFile&> PathsPortFileProvider::get_control_file(const std::string& spec) const
     {
@@ -259,7 +263,7 @@ namespace vcpkg::Dependencies
             return cache_it->second;
         }
         Parse::ParseExpected<SourceControlFile> source_control_file =
-            Paragraphs::try_load_port(ports.get_filesystem(), ports.port_dir(spec));
+            Paragraphs::try_load_port(ports.get_filesystem(), ports.port_dir(spec), index);
 
         if (auto scf = source_control_file.get())
         {
@@ -718,7 +722,12 @@ namespace vcpkg::Dependencies
                             if (install_action->request_type == RequestType::USER_REQUESTED)
                                 already_installed_plans.emplace_back(install_action);
                             break;
-                        case InstallPlanType::BUILD_AND_INSTALL: new_plans.emplace_back(install_action); break;
+                        case InstallPlanType::BUILD_AND_INSTALL:
+                            if (install_action->in_binary_cache)
+                                only_install_plans.emplace_back(install_action);
+                            else
+                                new_plans.emplace_back(install_action);
+                            break;
                         case InstallPlanType::EXCLUDED: excluded.emplace_back(install_action); break;
                         default: Checks::unreachable(VCPKG_LINE_INFO);
                     }
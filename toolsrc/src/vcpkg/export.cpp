@@ -71,7 +71,9 @@ namespace vcpkg::Export
         static constexpr std::array<ExportPlanType, 2> ORDER = {ExportPlanType::ALREADY_BUILT,
                                                                 ExportPlanType::PORT_AVAILABLE_BUT_NOT_BUILT};
         static constexpr Build::BuildPackageOptions build_options = {Build::UseHeadVersion::NO,
-                                                                     Build::AllowDownloads::YES};
+                                                                     Build::AllowDownloads::YES,
+                                                                     Build::CleanBuildtrees::NO,
+                                                                     Build::InstallStrategy::CLONE};
 
         for (const ExportPlanType plan_type : ORDER)
         {
@@ -417,7 +419,8 @@ namespace vcpkg::Export
                 action.spec.triplet().to_string(),
                 raw_exported_dir_path / "installed" / "vcpkg" / "info" / (binary_paragraph.fullstem() + ".list"));
 
-            Install::install_files_and_write_listfile(paths.get_filesystem(), paths.package_dir(action.spec), dirs);
+            Install::install_files_and_write_listfile(
+                paths.get_filesystem(), paths.package_dir(action.spec), dirs, Build::InstallStrategy::CLONE);
             System::println(System::Color::success, "Exporting package %s... done", display_name);
         }
 
@@ -9,6 +9,9 @@ namespace vcpkg
 
     std::atomic<bool> GlobalState::debugging(false);
     std::atomic<bool> GlobalState::feature_packages(true);
+    std::atomic<bool> GlobalState::binary_caching(false);
+    std::atomic<size_t> GlobalState::max_cpus(0);
+    std::atomic<uint64_t> GlobalState::max_memory_bytes(0);
 
     std::atomic<int> GlobalState::g_init_console_cp(0);
     std::atomic<int> GlobalState::g_init_console_output_cp(0);
@@ -1,9 +1,11 @@
 #include "pch.h"
 
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/jobserver.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
+#include <vcpkg/buildhistory.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/dependencies.h>
 #include <vcpkg/globalstate.h>
@@ -11,6 +13,8 @@
 #include <vcpkg/input.h>
 #include <vcpkg/install.h>
 #include <vcpkg/metrics.h>
+#include <vcpkg/ownershipindex.h>
+#include <vcpkg/ownsindex.h>
 #include <vcpkg/paragraphs.h>
 #include <vcpkg/remove.h>
 #include <vcpkg/vcpkglib.h>
@@ -36,11 +40,98 @@ namespace vcpkg::Install
 
     const fs::path& InstallDir::listfile() const { return this->m_listfile; }
 
-    void install_files_and_write_listfile(Files::Filesystem& fs,
-                                          const fs::path& source_dir,
-                                          const InstallDir& destination_dir)
+    InstalledFileCounts& InstalledFileCounts::operator+=(const InstalledFileCounts& other)
+    {
+        cloned += other.cloned;
+        hardlinked += other.hardlinked;
+        moved += other.moved;
+        copied += other.copied;
+        return *this;
+    }
+
+    std::string InstalledFileCounts::to_string() const
+    {
+        return Strings::format("%zd cloned, %zd hard linked, %zd moved, %zd copied", cloned, hardlinked, moved, copied);
+    }
+
+    namespace
+    {
+        enum class PlacedBy
+        {
+            NONE = 0,
+            CLONE,
+            HARDLINK,
+            MOVE,
+            COPY
+        };
+
+        // Messages are collected per entry while files are installed concurrently, then printed in walk order
+        struct EntryMessages
+        {
+            std::string warning;
+            std::string error;
+        };
+
+        struct FileInstaller
+        {
+            FileInstaller(Files::Filesystem& fs, Build::InstallStrategy strategy)
+                : fs(fs)
+                , try_clone(strategy >= Build::InstallStrategy::CLONE)
+                , try_hardlink(strategy >= Build::InstallStrategy::HARDLINK)
+                , try_move(strategy >= Build::InstallStrategy::MOVE)
+            {
+            }
+
+            PlacedBy install_file(const fs::path& file, const fs::path& target, EntryMessages& messages)
+            {
+                std::error_code ec;
+                if (try_clone)
+                {
+                    if (fs.clone_file(file, target, ec)) return PlacedBy::CLONE;
+                    Debug::println("Could not clone %s: %s", file.u8string(), ec.message());
+                    try_clone = false;
+                }
+
+                if (try_hardlink)
+                {
+                    fs.create_hard_link(file, target, ec);
+                    if (!ec) return PlacedBy::HARDLINK;
+                    Debug::println("Could not hard link %s: %s", file.u8string(), ec.message());
+                    try_hardlink = false;
+                }
+
+                if (try_move)
+                {
+                    fs.rename(file, target, ec);
+                    if (!ec) return PlacedBy::MOVE;
+                    Debug::println("Could not move %s: %s", file.u8string(), ec.message());
+                    try_move = false;
+                }
+
+                fs.copy_file(file, target, fs::copy_options::overwrite_existing, ec);
+                if (ec)
+                {
+                    messages.error = Strings::format("failed: %s: %s", target.u8string(), ec.message());
+                    return PlacedBy::NONE;
+                }
+                return PlacedBy::COPY;
+            }
+
+            Files::Filesystem& fs;
+
+            // All files go from the same source tree to the same destination tree, so a strategy that fails once,
+            // usually because the filesystem does not support it, is not tried again for the remaining files
+            std::atomic<bool> try_clone;
+            std::atomic<bool> try_hardlink;
+            std::atomic<bool> try_move;
+        };
+    }
+
+    InstalledFileCounts install_files_and_write_listfile(Files::Filesystem& fs,
+                                                         const fs::path& source_dir,
+                                                         const InstallDir& destination_dir,
+                                                         Build::InstallStrategy strategy)
     {
-        std::vector<std::string> output;
         std::error_code ec;
 
         const size_t prefix_length = source_dir.native().size();
@@ -58,14 +149,27 @@ namespace vcpkg::Install
         Checks::check_exit(
             VCPKG_LINE_INFO, !ec, "Could not create directory for listfile %s", listfile.generic_string());
 
-        output.push_back(Strings::format(R"(%s/)", destination_subdirectory));
-        auto files = fs.get_files_recursive(source_dir);
-        for (auto&& file : files)
+        const std::vector<fs::path> files = fs.get_files_recursive(source_dir);
+        const std::vector<std::pair<fs::file_status, std::error_code>> statuses =
+            Util::parallel_fmap(files, [&](const fs::path& file) {
+                std::error_code status_ec;
+                const auto status = fs.status(file, status_ec);
+                return std::make_pair(status, status_ec);
+            });
+
+        // Directories are created in walk order, so every parent exists before the files are placed
+        std::vector<EntryMessages> messages(files.size());
+        std::vector<std::string> directory_entries;
+        std::vector<std::string> file_entries;
+        std::vector<size_t> regular_files;
+        directory_entries.push_back(Strings::format(R"(%s/)", destination_subdirectory));
+        for (size_t i = 0; i < files.size(); ++i)
         {
-            const auto status = fs.status(file, ec);
-            if (ec)
+            const fs::path& file = files[i];
+            const fs::file_status status = statuses[i].first;
+            if (statuses[i].second)
             {
-                System::println(System::Color::error, "failed: %s: %s", file.u8string(), ec.message());
+                messages[i].error = Strings::format("failed: %s: %s", file.u8string(), statuses[i].second.message());
                 continue;
             }
 
@@ -78,77 +182,86 @@ namespace vcpkg::Install
             }
 
             const std::string suffix = file.generic_u8string().substr(prefix_length + 1);
-            const fs::path target = destination / suffix;
 
             if (fs::is_directory(status))
             {
+                const fs::path target = destination / suffix;
                 fs.create_directory(target, ec);
                 if (ec)
                 {
-                    System::println(System::Color::error, "failed: %s: %s", target.u8string(), ec.message());
+                    messages[i].error = Strings::format("failed: %s: %s", target.u8string(), ec.message());
                 }
 
                 // Trailing backslash for directories
-                output.push_back(Strings::format(R"(%s/%s/)", destination_subdirectory, suffix));
+                directory_entries.push_back(Strings::format(R"(%s/%s/)", destination_subdirectory, suffix));
                 continue;
             }
 
             if (fs::is_regular_file(status))
             {
-                if (fs.exists(target))
-                {
-                    System::println(System::Color::warning,
-                                    "File %s was already present and will be overwritten",
-                                    target.u8string(),
-                                    ec.message());
-                }
-                fs.copy_file(file, target, fs::copy_options::overwrite_existing, ec);
-                if (ec)
-                {
-                    System::println(System::Color::error, "failed: %s: %s", target.u8string(), ec.message());
-                }
-                output.push_back(Strings::format(R"(%s/%s)", destination_subdirectory, suffix));
+                regular_files.push_back(i);
+                file_entries.push_back(Strings::format(R"(%s/%s)", destination_subdirectory, suffix));
                 continue;
             }
 
             if (!fs::status_known(status))
             {
-                System::println(System::Color::error, "failed: %s: unknown status", file.u8string());
+                messages[i].error = Strings::format("failed: %s: unknown status", file.u8string());
                 continue;
             }
 
-            System::println(System::Color::error, "failed: %s: cannot handle file type", file.u8string());
+            messages[i].error = Strings::format("failed: %s: cannot handle file type", file.u8string());
         }
 
-        std::sort(output.begin(), output.end());
+        FileInstaller installer(fs, strategy);
+        std::vector<PlacedBy> placed_by(files.size(), PlacedBy::NONE);
+        Util::parallel_for(regular_files.size(), [&](const size_t n) {
+            const size_t i = regular_files[n];
+            const fs::path& file = files[i];
+            const fs::path target = destination / file.generic_u8string().substr(prefix_length + 1);
 
-        fs.write_lines(listfile, output);
-    }
+            std::error_code target_ec;
+            if (fs.exists(target))
+            {
+                messages[i].warning =
+                    Strings::format("File %s was already present and will be overwritten", target.u8string());
 
-    static void remove_first_n_chars(std::vector<std::string>* strings, const size_t n)
-    {
-        for (std::string& s : *strings)
-        {
-            s.erase(0, n);
-        }
-    };
+                // Only copying overwrites the existing file in place
+                if (strategy != Build::InstallStrategy::COPY) fs.remove(target, target_ec);
+            }
 
-    static std::vector<std::string> extract_files_in_triplet(
-        const std::vector<StatusParagraphAndAssociatedFiles>& pgh_and_files, const Triplet& triplet)
-    {
-        std::vector<std::string> output;
-        for (const StatusParagraphAndAssociatedFiles& t : pgh_and_files)
+            placed_by[i] = installer.install_file(file, target, messages[i]);
+        });
+
+        InstalledFileCounts counts;
+        for (size_t i = 0; i < files.size(); ++i)
         {
-            if (t.pgh.package.spec.triplet() != triplet)
+            if (!messages[i].warning.empty()) System::println(System::Color::warning, messages[i].warning);
+            if (!messages[i].error.empty()) System::println(System::Color::error, messages[i].error);
+
+            switch (placed_by[i])
             {
-                continue;
+                case PlacedBy::NONE: break;
+                case PlacedBy::CLONE: ++counts.cloned; break;
+                case PlacedBy::HARDLINK: ++counts.hardlinked; break;
+                case PlacedBy::MOVE: ++counts.moved; break;
+                case PlacedBy::COPY: ++counts.copied; break;
+                default: Checks::unreachable(VCPKG_LINE_INFO);
             }
-
-            Util::Vectors::concatenate(&output, t.files);
         }
 
-        std::sort(output.begin(), output.end());
-        return output;
+        std::sort(directory_entries.begin(), directory_entries.end());
+        std::sort(file_entries.begin(), file_entries.end());
+        std::vector<std::string> output;
+        output.reserve(directory_entries.size() + file_entries.size());
+        std::merge(std::make_move_iterator(directory_entries.begin()),
+                   std::make_move_iterator(directory_entries.end()),
+                   std::make_move_iterator(file_entries.begin()),
+                   std::make_move_iterator(file_entries.end()),
+                   std::back_inserter(output));
+
+        fs.write_lines(listfile, output);
+        return counts;
     }
 
     static SortedVector<std::string> build_list_of_package_files(const Files::Filesystem& fs,
@@ -165,32 +278,25 @@ namespace vcpkg::Install
         return SortedVector<std::string>(std::move(package_files));
     }
 
-    static SortedVector<std::string> build_list_of_installed_files(
-        const std::vector<StatusParagraphAndAssociatedFiles>& pgh_and_files, const Triplet& triplet)
-    {
-        std::vector<std::string> installed_files = extract_files_in_triplet(pgh_and_files, triplet);
-        const size_t installed_remove_char_count = triplet.canonical_name().size() + 1; // +1 for the slash
-        remove_first_n_chars(&installed_files, installed_remove_char_count);
-
-        return SortedVector<std::string>(std::move(installed_files));
-    }
-
-    InstallResult install_package(const VcpkgPaths& paths, const BinaryControlFile& bcf, StatusParagraphs* status_db)
+    InstallResult install_package(const VcpkgPaths& paths,
+                                  const BinaryControlFile& bcf,
+                                  Build::InstallStrategy strategy,
+                                  StatusParagraphs* status_db,
+                                  OwnershipIndexes* ownership_indexes,
+                                  InstalledFileCounts* file_counts)
     {
         const fs::path package_dir = paths.package_dir(bcf.core_paragraph.spec);
         const Triplet& triplet = bcf.core_paragraph.spec.triplet();
-        const std::vector<StatusParagraphAndAssociatedFiles> pgh_and_files = get_installed_files(paths, *status_db);
+        OwnershipIndex& ownership_index = ownership_indexes->get(paths, *status_db, triplet);
 
         const SortedVector<std::string> package_files =
             build_list_of_package_files(paths.get_filesystem(), package_dir);
-        const SortedVector<std::string> installed_files = build_list_of_installed_files(pgh_and_files, triplet);
 
         std::vector<std::string> intersection;
-        std::set_intersection(package_files.begin(),
-                              package_files.end(),
-                              installed_files.begin(),
-                              installed_files.end(),
-                              std::back_inserter(intersection));
+        for (auto&& file : package_files)
+        {
+            if (ownership_index.find_owner(file)) intersection.push_back(file);
+        }
 
         if (!intersection.empty())
         {
@@ -205,42 +311,50 @@ namespace vcpkg::Install
             return InstallResult::FILE_CONFLICTS;
         }
 
-        StatusParagraph source_paragraph;
-        source_paragraph.package = bcf.core_paragraph;
-        source_paragraph.want = Want::INSTALL;
-        source_paragraph.state = InstallState::HALF_INSTALLED;
-
-        write_update(paths, source_paragraph);
-        status_db->insert(std::make_unique<StatusParagraph>(source_paragraph));
-
-        std::vector<StatusParagraph> features_spghs;
+        // The core paragraph comes first, followed by one paragraph per feature
+        std::vector<StatusParagraph> spghs;
+        spghs.emplace_back();
+        spghs.back().package = bcf.core_paragraph;
         for (auto&& feature : bcf.features)
         {
-            features_spghs.emplace_back();
+            spghs.emplace_back();
+            spghs.back().package = feature;
+        }
 
-            StatusParagraph& feature_paragraph = features_spghs.back();
-            feature_paragraph.package = feature;
-            feature_paragraph.want = Want::INSTALL;
-            feature_paragraph.state = InstallState::HALF_INSTALLED;
+        for (auto&& spgh : spghs)
+        {
+            spgh.want = Want::INSTALL;
+            spgh.state = InstallState::HALF_INSTALLED;
+        }
 
-            write_update(paths, feature_paragraph);
-            status_db->insert(std::make_unique<StatusParagraph>(feature_paragraph));
+        write_updates(paths, spghs);
+        for (auto&& spgh : spghs)
+        {
+            status_db->insert(std::make_unique<StatusParagraph>(spgh));
         }
 
         const InstallDir install_dir = InstallDir::from_destination_root(
             paths.installed, triplet.to_string(), paths.listfile_path(bcf.core_paragraph));
 
-        install_files_and_write_listfile(paths.get_filesystem(), package_dir, install_dir);
+        *file_counts += install_files_and_write_listfile(paths.get_filesystem(), package_dir, install_dir, strategy);
+        if (strategy == Build::InstallStrategy::MOVE)
+        {
+            // Moved files are gone from the package directory, so it can no longer be installed or exported again
+            std::error_code ec;
+            paths.get_filesystem().remove_all(package_dir, ec);
+        }
+
+        ownership_index.add_package(paths, bcf.core_paragraph);
 
-        source_paragraph.state = InstallState::INSTALLED;
-        write_update(paths, source_paragraph);
-        status_db->insert(std::make_unique<StatusParagraph>(source_paragraph));
+        for (auto&& spgh : spghs)
+        {
+            spgh.state = InstallState::INSTALLED;
+        }
 
-        for (auto&& feature_paragraph : features_spghs)
+        write_updates(paths, spghs);
+        for (auto&& spgh : spghs)
         {
-            feature_paragraph.state = InstallState::INSTALLED;
-            write_update(paths, feature_paragraph);
-            status_db->insert(std::make_unique<StatusParagraph>(feature_paragraph));
+            status_db->insert(std::make_unique<StatusParagraph>(std::move(spgh)));
         }
 
         return InstallResult::SUCCESS;
@@ -249,14 +363,78 @@ namespace vcpkg::Install
     using Build::BuildResult;
     using Build::ExtendedBuildResult;
 
+    static std::string display_name_with_features(const InstallPlanAction& action)
+    {
+        return GlobalState::feature_packages ? action.displayname() : action.spec.to_string();
+    }
+
+    static ExtendedBuildResult build_plan_action(const VcpkgPaths& paths,
+                                                 const InstallPlanAction& action,
+                                                 const StatusParagraphs& status_db,
+                                                 const size_t concurrency = 0)
+    {
+        const std::string display_name = display_name_with_features(action);
+        if (Util::Enum::to_bool(action.build_options.use_head_version))
+            System::println("Building package %s from HEAD... ", display_name);
+        else
+            System::println("Building package %s... ", display_name);
+
+        auto result = [&]() -> Build::ExtendedBuildResult {
+            Build::BuildPackageConfig build_config{action.source_control_file.value_or_exit(VCPKG_LINE_INFO),
+                                                   action.spec.triplet(),
+                                                   paths.port_dir(action.spec),
+                                                   action.build_options,
+                                                   action.feature_list};
+            build_config.concurrency = concurrency;
+            return Build::build_package(paths, build_config, status_db);
+        }();
+
+        if (result.code != Build::BuildResult::SUCCEEDED)
+        {
+            System::println(System::Color::error, Build::create_error_message(result.code, action.spec));
+            return result;
+        }
+
+        System::println("Building package %s... done", display_name);
+
+        result.binary_control_file = std::make_unique<BinaryControlFile>(
+            Paragraphs::try_load_cached_control_package(paths, action.spec).value_or_exit(VCPKG_LINE_INFO));
+        return result;
+    }
+
+    static ExtendedBuildResult install_built_package(const VcpkgPaths& paths,
+                                                     const InstallPlanAction& action,
+                                                     ExtendedBuildResult&& built,
+                                                     StatusParagraphs& status_db,
+                                                     OwnershipIndexes& ownership_indexes,
+                                                     InstalledFileCounts& file_counts)
+    {
+        const std::string name = display_name_with_features(action);
+        System::println("Installing package %s... ", name);
+        const auto install_result = install_package(paths,
+                                                    *built.binary_control_file,
+                                                    action.build_options.install_strategy,
+                                                    &status_db,
+                                                    &ownership_indexes,
+                                                    &file_counts);
+        switch (install_result)
+        {
+            case InstallResult::SUCCESS:
+                System::println(System::Color::success, "Installing package %s... done", name);
+                return std::move(built);
+            case InstallResult::FILE_CONFLICTS: built.code = BuildResult::FILE_CONFLICTS; return std::move(built);
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
     ExtendedBuildResult perform_install_plan_action(const VcpkgPaths& paths,
                                                     const InstallPlanAction& action,
-                                                    StatusParagraphs& status_db)
+                                                    StatusParagraphs& status_db,
+                                                    OwnershipIndexes& ownership_indexes,
+                                                    InstalledFileCounts& file_counts)
     {
         const InstallPlanType& plan_type = action.plan_type;
         const std::string display_name = action.spec.to_string();
-        const std::string display_name_with_features =
-            GlobalState::feature_packages ? action.displayname() : display_name;
 
         const bool is_user_requested = action.request_type == RequestType::USER_REQUESTED;
         const bool use_head_version = Util::Enum::to_bool(action.build_options.use_head_version);
@@ -271,47 +449,11 @@ namespace vcpkg::Install
             return BuildResult::SUCCEEDED;
         }
 
-        auto aux_install = [&](const std::string& name, const BinaryControlFile& bcf) -> BuildResult {
-            System::println("Installing package %s... ", name);
-            const auto install_result = install_package(paths, bcf, &status_db);
-            switch (install_result)
-            {
-                case InstallResult::SUCCESS:
-                    System::println(System::Color::success, "Installing package %s... done", name);
-                    return BuildResult::SUCCEEDED;
-                case InstallResult::FILE_CONFLICTS: return BuildResult::FILE_CONFLICTS;
-                default: Checks::unreachable(VCPKG_LINE_INFO);
-            }
-        };
-
         if (plan_type == InstallPlanType::BUILD_AND_INSTALL)
         {
-            if (use_head_version)
-                System::println("Building package %s from HEAD... ", display_name_with_features);
-            else
-                System::println("Building package %s... ", display_name_with_features);
-
-            auto result = [&]() -> Build::ExtendedBuildResult {
-                const Build::BuildPackageConfig build_config{action.source_control_file.value_or_exit(VCPKG_LINE_INFO),
-                                                             action.spec.triplet(),
-                                                             paths.port_dir(action.spec),
-                                                             action.build_options,
-                                                             action.feature_list};
-                return Build::build_package(paths, build_config, status_db);
-            }();
-
-            if (result.code != Build::BuildResult::SUCCEEDED)
-            {
-                System::println(System::Color::error, Build::create_error_message(result.code, action.spec));
-                return result;
-            }
-
-            System::println("Building package %s... done", display_name_with_features);
-
-            auto bcf = std::make_unique<BinaryControlFile>(
-                Paragraphs::try_load_cached_control_package(paths, action.spec).value_or_exit(VCPKG_LINE_INFO));
-            auto code = aux_install(display_name_with_features, *bcf);
-            return {code, std::move(bcf)};
+            auto result = build_plan_action(paths, action, status_db);
+            if (result.code != BuildResult::SUCCEEDED) return result;
+            return install_built_package(paths, action, std::move(result), status_db, ownership_indexes, file_counts);
         }
 
         if (plan_type == InstallPlanType::EXCLUDED)
@@ -323,13 +465,33 @@ namespace vcpkg::Install
         Checks::unreachable(VCPKG_LINE_INFO);
     }
 
+    static std::string format_megabytes(uint64_t bytes) { return Strings::format("%.1f MB", bytes / 1048576.0); }
+
+    static std::string format_usage(const System::ProcessUsage& usage)
+    {
+        return Strings::format("CPU %.1f s, peak memory %s, read %s, written %s, %s context switches",
+                               usage.cpu_time_us / 1e6,
+                               format_megabytes(usage.peak_memory_bytes),
+                               format_megabytes(usage.bytes_read),
+                               format_megabytes(usage.bytes_written),
+                               std::to_string(usage.context_switches));
+    }
+
     void InstallSummary::print() const
     {
         System::println("RESULTS");
 
         for (const SpecSummary& result : this->results)
         {
-            System::println("    %s: %s: %s", result.spec, Build::to_string(result.build_result.code), result.timing);
+            System::println("    %s: %s: %s%s",
+                            result.spec,
+                            Build::to_string(result.build_result.code),
+                            result.timing,
+                            result.build_result.restored_from_cache ? " (restored from binary cache)" : "");
+            if (const auto usage = result.build_result.usage.get())
+            {
+                System::println("        %s", format_usage(*usage));
+            }
         }
 
         std::map<BuildResult, int> summary;
@@ -350,14 +512,138 @@ namespace vcpkg::Install
         }
     }
 
-    InstallSummary perform(const std::vector<AnyAction>& action_plan,
-                           const KeepGoing keep_going,
-                           const VcpkgPaths& paths,
-                           StatusParagraphs& status_db)
+    namespace
     {
-        std::vector<SpecSummary> results;
+        // Downloads the sources of the plan's builds on a background thread, in plan order, so that the network is
+        // busy while earlier ports compile and each build finds its distfiles already in downloads/
+        class SourcePrefetcher
+        {
+        public:
+            SourcePrefetcher(const VcpkgPaths& paths, const std::vector<AnyAction>& action_plan)
+                : paths(paths), action_plan(action_plan), states(action_plan.size(), State::DONE)
+            {
+                for (size_t i = 0; i < action_plan.size(); ++i)
+                {
+                    if (should_prefetch(action_plan[i])) states[i] = State::PENDING;
+                }
 
-        const auto timer = Chrono::ElapsedTimer::create_started();
+                if (Util::find(states, State::PENDING) != states.end())
+                {
+                    worker = std::thread([this]() { run(); });
+                }
+            }
+
+            SourcePrefetcher(const SourcePrefetcher&) = delete;
+            SourcePrefetcher& operator=(const SourcePrefetcher&) = delete;
+
+            ~SourcePrefetcher() { stop(); }
+
+            /// <summary>
+            /// Called before the action at `index` is performed. Waits for its prefetch if that is running, and
+            /// cancels it if it has not started, since the build downloads everything itself anyway.
+            /// </summary>
+            void claim(const size_t index)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (states[index] == State::PENDING) states[index] = State::DONE;
+                prefetch_finished.wait(lock, [&]() { return states[index] == State::DONE; });
+            }
+
+            /// <summary>
+            /// Lets a running prefetch finish and starts no more
+            /// </summary>
+            void stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+
+                if (worker.joinable()) worker.join();
+            }
+
+        private:
+            enum class State
+            {
+                PENDING,
+                RUNNING,
+                DONE,
+            };
+
+            static bool should_prefetch(const AnyAction& action)
+            {
+                const auto p_install = action.install_action.get();
+                if (!p_install || p_install->plan_type != InstallPlanType::BUILD_AND_INSTALL) return false;
+
+                // Binary cache hits are never built, and builds from HEAD always fetch their sources afresh
+                return !p_install->in_binary_cache &&
+                       Util::Enum::to_bool(p_install->build_options.allow_downloads) &&
+                       !Util::Enum::to_bool(p_install->build_options.use_head_version);
+            }
+
+            void run()
+            {
+                for (size_t i = 0; i < action_plan.size(); ++i)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (stopping) return;
+                        if (states[i] != State::PENDING) continue;
+                        states[i] = State::RUNNING;
+                    }
+
+                    const InstallPlanAction& action = action_plan[i].install_action.value_or_exit(VCPKG_LINE_INFO);
+                    const Build::BuildPackageConfig config{action.source_control_file.value_or_exit(VCPKG_LINE_INFO),
+                                                           action.spec.triplet(),
+                                                           paths.port_dir(action.spec),
+                                                           action.build_options,
+                                                           action.feature_list};
+
+                    // While the port builds for another triplet, its build downloads whatever is missing itself
+                    std::unique_lock<std::mutex> port_lock(Build::get_port_mutex(action.spec.name()),
+                                                           std::try_to_lock);
+                    if (port_lock.owns_lock())
+                    {
+                        const auto timer = Chrono::ElapsedTimer::create_started();
+                        const Build::DownloadSourcesResult result = Build::download_sources(paths, config);
+                        if (result.succeeded)
+                        {
+                            Debug::println("Prefetched the sources of %s in %s", action.spec, timer.to_string());
+                        }
+                        else
+                        {
+                            System::println(System::Color::warning,
+                                            "Prefetching the sources of %s failed",
+                                            action.spec);
+                        }
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    states[i] = State::DONE;
+                    prefetch_finished.notify_all();
+                }
+            }
+
+            const VcpkgPaths& paths;
+            const std::vector<AnyAction>& action_plan;
+
+            std::mutex mutex;
+            std::condition_variable prefetch_finished;
+            std::vector<State> states;
+            bool stopping = false;
+            std::thread worker;
+        };
+    }
+
+    static void perform_serially(const std::vector<AnyAction>& action_plan,
+                                 const KeepGoing keep_going,
+                                 const VcpkgPaths& paths,
+                                 StatusParagraphs& status_db,
+                                 OwnershipIndexes& ownership_indexes,
+                                 SourcePrefetcher& prefetcher,
+                                 std::vector<SpecSummary>& results,
+                                 InstalledFileCounts& file_counts)
+    {
         size_t counter = 0;
         const size_t package_count = action_plan.size();
 
@@ -374,11 +660,15 @@ namespace vcpkg::Install
 
             if (const auto install_action = action.install_action.get())
             {
-                auto result = perform_install_plan_action(paths, *install_action, status_db);
+                prefetcher.claim(counter - 1);
+                auto result =
+                    perform_install_plan_action(paths, *install_action, status_db, ownership_indexes, file_counts);
 
                 if (result.code != BuildResult::SUCCEEDED && keep_going == KeepGoing::NO)
                 {
                     System::println(Build::create_user_troubleshooting_message(install_action->spec));
+                    prefetcher.stop();
+                    ownership_indexes.write(paths.get_filesystem());
                     Checks::exit_fail(VCPKG_LINE_INFO);
                 }
 
@@ -386,7 +676,8 @@ namespace vcpkg::Install
             }
             else if (const auto remove_action = action.remove_action.get())
             {
-                Remove::perform_remove_plan_action(paths, *remove_action, Remove::Purge::YES, &status_db);
+                Remove::perform_remove_plan_action(
+                    paths, *remove_action, Remove::Purge::YES, &status_db, &ownership_indexes);
             }
             else
             {
@@ -396,8 +687,463 @@ namespace vcpkg::Install
             results.back().timing = build_timer.elapsed();
             System::println("Elapsed time for package %s: %s", display_name, results.back().timing.to_string());
         }
+    }
 
-        return InstallSummary{std::move(results), timer.to_string()};
+    namespace
+    {
+        struct ScheduledAction
+        {
+            bool is_build = false;
+            // Index one past the last earlier action this one depends on; it may start once that many are committed
+            size_t ready_after = 0;
+            std::vector<PackageSpec> dependencies;
+            // The actions that install dependencies
+            std::vector<size_t> dependency_actions;
+            uint64_t estimated_us = 0;
+            uint64_t estimated_memory_bytes = 0;
+            // The longest chain of estimated builds from the start of this one to the end of the plan
+            uint64_t critical_path_us = 0;
+        };
+    }
+
+    static std::vector<ScheduledAction> schedule_actions(const std::vector<AnyAction>& action_plan)
+    {
+        std::vector<ScheduledAction> scheduled(action_plan.size());
+        std::unordered_map<PackageSpec, size_t> last_action_for_spec;
+        std::unordered_map<std::string, size_t> last_action_for_port;
+        size_t ready_after_barrier = 0;
+
+        for (size_t i = 0; i < action_plan.size(); ++i)
+        {
+            ScheduledAction& entry = scheduled[i];
+            entry.ready_after = ready_after_barrier;
+
+            const PackageSpec& spec = action_plan[i].spec();
+            if (action_plan[i].remove_action.has_value())
+            {
+                // Removals are rare and only precede reinstalls, so they simply separate everything around them
+                entry.ready_after = i;
+                ready_after_barrier = i + 1;
+            }
+            else if (auto p_install = action_plan[i].install_action.get())
+            {
+                if (p_install->plan_type == InstallPlanType::BUILD_AND_INSTALL)
+                {
+                    entry.is_build = true;
+
+                    const SourceControlFile& scf = p_install->source_control_file.value_or_exit(VCPKG_LINE_INFO);
+                    for (auto&& dependency : Build::get_dependency_specs(scf, p_install->feature_list, spec.triplet()))
+                    {
+                        const auto it = last_action_for_spec.find(dependency);
+                        if (it == last_action_for_spec.end()) continue;
+                        entry.ready_after = std::max(entry.ready_after, it->second + 1);
+                        entry.dependencies.push_back(dependency);
+                        entry.dependency_actions.push_back(it->second);
+                    }
+
+                    // Builds of the same port share its buildtrees directory
+                    const auto it_port = last_action_for_port.find(spec.name());
+                    if (it_port != last_action_for_port.end())
+                    {
+                        entry.ready_after = std::max(entry.ready_after, it_port->second + 1);
+                    }
+                    last_action_for_port[spec.name()] = i;
+                }
+            }
+
+            last_action_for_spec[spec] = i;
+        }
+
+        return scheduled;
+    }
+
+    /// <summary>
+    /// Estimates the time and memory of every build from the history, and the critical path that starts with it.
+    /// Builds without history count as the average recorded build. Returns how many builds had no history.
+    /// </summary>
+    static size_t estimate_builds(const std::vector<AnyAction>& action_plan,
+                                  const BuildHistory& history,
+                                  std::vector<ScheduledAction>& scheduled)
+    {
+        // Chosen so that without any history the longest chains of builds still go first
+        static constexpr uint64_t DEFAULT_ESTIMATE_US = 60 * 1000 * 1000;
+
+        uint64_t total_recorded_us = 0;
+        uint64_t total_recorded_memory_bytes = 0;
+        size_t recorded = 0;
+        std::vector<size_t> unrecorded;
+        for (size_t i = 0; i < action_plan.size(); ++i)
+        {
+            if (!scheduled[i].is_build) continue;
+
+            const InstallPlanAction& install_action = action_plan[i].install_action.value_or_exit(VCPKG_LINE_INFO);
+            const SourceControlFile& scf = install_action.source_control_file.value_or_exit(VCPKG_LINE_INFO);
+            const auto maybe_record = history.find(install_action.spec, scf.core_paragraph->version);
+            if (const auto record = maybe_record.get())
+            {
+                scheduled[i].estimated_us = record->build_time_us;
+                scheduled[i].estimated_memory_bytes = record->usage.peak_memory_bytes;
+                total_recorded_us += record->build_time_us;
+                total_recorded_memory_bytes += record->usage.peak_memory_bytes;
+                ++recorded;
+            }
+            else
+            {
+                unrecorded.push_back(i);
+            }
+        }
+
+        const uint64_t average_us = recorded == 0 ? DEFAULT_ESTIMATE_US : total_recorded_us / recorded;
+        const uint64_t average_memory_bytes = recorded == 0 ? 0 : total_recorded_memory_bytes / recorded;
+        for (const size_t i : unrecorded)
+        {
+            scheduled[i].estimated_us = average_us;
+            scheduled[i].estimated_memory_bytes = average_memory_bytes;
+        }
+
+        // Dependencies always come earlier in the plan, so the paths after an action are known once all later
+        // actions were visited
+        std::vector<uint64_t> longest_successor_path_us(scheduled.size(), 0);
+        for (size_t i = scheduled.size(); i-- > 0;)
+        {
+            scheduled[i].critical_path_us = scheduled[i].estimated_us + longest_successor_path_us[i];
+            for (const size_t dependency : scheduled[i].dependency_actions)
+            {
+                longest_successor_path_us[dependency] =
+                    std::max(longest_successor_path_us[dependency], scheduled[i].critical_path_us);
+            }
+        }
+
+        return unrecorded.size();
+    }
+
+    /// <summary>
+    /// Chooses the build to start next, or returns scheduled.size() if none is ready. The next action to commit goes
+    /// first, since every later commit waits for it; the others go by their critical path (HLFET). Only builds for
+    /// which fits(index) holds may start, and while the next action to commit does not fit, nothing else starts
+    /// either, so that it is not kept waiting by smaller builds.
+    /// </summary>
+    template<class Fits>
+    static size_t pick_next_build(const std::vector<ScheduledAction>& scheduled,
+                                  const std::vector<bool>& launched,
+                                  const size_t committed,
+                                  Fits fits)
+    {
+        size_t best = scheduled.size();
+        for (size_t i = committed; i < scheduled.size(); ++i)
+        {
+            if (launched[i] || !scheduled[i].is_build || scheduled[i].ready_after > committed) continue;
+            if (i == committed) return fits(i) ? i : scheduled.size();
+            if (!fits(i)) continue;
+            if (best == scheduled.size() || scheduled[i].critical_path_us > scheduled[best].critical_path_us)
+                best = i;
+        }
+        return best;
+    }
+
+    /// <summary>
+    /// Runs perform_concurrently() on the estimates alone, with commits taking no time, and returns its wall time
+    /// </summary>
+    static uint64_t estimate_makespan(const std::vector<ScheduledAction>& scheduled,
+                                      const size_t jobs,
+                                      const uint64_t memory_budget_bytes)
+    {
+        std::vector<bool> launched(scheduled.size(), false);
+        std::vector<uint64_t> finish_us(scheduled.size(), 0);
+        std::vector<size_t> running;
+        uint64_t running_memory_bytes = 0;
+        const auto fits = [&](size_t i) {
+            return memory_budget_bytes == 0 || running.empty() ||
+                   running_memory_bytes + scheduled[i].estimated_memory_bytes <= memory_budget_bytes;
+        };
+
+        uint64_t now_us = 0;
+        size_t committed = 0;
+        while (committed < scheduled.size())
+        {
+            while (running.size() < jobs)
+            {
+                const size_t next = pick_next_build(scheduled, launched, committed, fits);
+                if (next == scheduled.size()) break;
+                launched[next] = true;
+                finish_us[next] = now_us + scheduled[next].estimated_us;
+                running.push_back(next);
+                running_memory_bytes += scheduled[next].estimated_memory_bytes;
+            }
+
+            if (!scheduled[committed].is_build || (launched[committed] && finish_us[committed] <= now_us))
+            {
+                ++committed;
+                continue;
+            }
+
+            now_us = finish_us[*std::min_element(running.begin(), running.end(), [&](size_t a, size_t b) {
+                return finish_us[a] < finish_us[b];
+            })];
+            Util::erase_remove_if(running, [&](size_t i) {
+                if (finish_us[i] > now_us) return false;
+                running_memory_bytes -= scheduled[i].estimated_memory_bytes;
+                return true;
+            });
+        }
+        return now_us;
+    }
+
+    static StatusParagraphs copy_status_paragraphs(const StatusParagraphs& status_db,
+                                                   const std::vector<PackageSpec>& specs)
+    {
+        std::vector<std::unique_ptr<StatusParagraph>> paragraphs;
+        for (auto&& spec : specs)
+        {
+            const Optional<InstalledPackageView> installed = status_db.find_all_installed(spec);
+            if (const auto p_installed = installed.get())
+            {
+                paragraphs.push_back(std::make_unique<StatusParagraph>(*p_installed->core));
+                for (auto&& feature : p_installed->features)
+                    paragraphs.push_back(std::make_unique<StatusParagraph>(*feature));
+            }
+        }
+
+        return StatusParagraphs(std::move(paragraphs));
+    }
+
+    namespace
+    {
+        // Shared by all plans that this process performs at once, such as the triplets of a ci run, so that their
+        // builds together stay within `jobs`, the memory budget and the implicit token of the jobserver, and so that
+        // no two of them build the same port at once
+        struct RunningBuilds
+        {
+            std::mutex mutex;
+            std::condition_variable finished;
+            size_t count = 0;
+            uint64_t memory_bytes = 0;
+            bool implicit_token_free = true;
+            std::set<std::string> ports;
+        };
+    }
+
+    static RunningBuilds s_running_builds;
+
+    // Builds ports on up to `jobs` threads as soon as everything they depend on has been committed. Actions are
+    // still committed - installed, removed, skipped or reported as failed - on this thread in plan order, so the
+    // installed tree, the status database and the summary end up exactly as after a serial run.
+    static void perform_concurrently(const std::vector<AnyAction>& action_plan,
+                                     const KeepGoing keep_going,
+                                     const VcpkgPaths& paths,
+                                     StatusParagraphs& status_db,
+                                     OwnershipIndexes& ownership_indexes,
+                                     const size_t jobs,
+                                     SourcePrefetcher& prefetcher,
+                                     std::vector<SpecSummary>& results,
+                                     InstalledFileCounts& file_counts)
+    {
+        const size_t package_count = action_plan.size();
+        std::vector<ScheduledAction> scheduled = schedule_actions(action_plan);
+        estimate_builds(action_plan, BuildHistory::load(paths), scheduled);
+
+        RunningBuilds& running = s_running_builds;
+        std::vector<bool> launched(package_count, false);
+        std::vector<std::thread> builders(package_count);
+        std::vector<std::unique_ptr<ExtendedBuildResult>> built(package_count);
+        std::vector<Chrono::ElapsedTime> build_times(package_count);
+
+        // With a jobserver every build but one pays a token for its first job, so together they stay within the
+        // shared CPU budget. The one that does not uses the implicit token that the pool holds back.
+        Jobserver::TokenPool* const jobserver = Build::get_build_jobserver();
+        // Ninja and msbuild cannot take tokens, so each build gets an even share of the CPUs for them instead
+        const size_t build_concurrency = jobserver ? std::max<size_t>(1, jobserver->cpus() / jobs) : 0;
+
+        // With a memory budget a build only starts if its estimated peak fits next to the running builds. They are
+        // assumed to use their estimates, or what their processes use now if that is more.
+        const uint64_t memory_budget_bytes = GlobalState::max_memory_bytes;
+        size_t reported_memory_wait = package_count;
+
+        // Called with running.mutex held
+        auto launch_ready_builds = [&](const size_t committed) {
+            uint64_t live_memory_bytes = 0;
+            if (memory_budget_bytes != 0 && running.count != 0)
+            {
+                live_memory_bytes = System::get_descendants_resident_memory().value_or(0);
+            }
+
+            const auto fits_memory = [&](size_t i) {
+                const uint64_t in_use_bytes = std::max(running.memory_bytes, live_memory_bytes);
+                return memory_budget_bytes == 0 || running.count == 0 ||
+                       in_use_bytes + scheduled[i].estimated_memory_bytes <= memory_budget_bytes;
+            };
+            // build_package() holds the port lock for the whole build, so a build of a port that another plan is
+            // building would only sit on its slot and token until that one finishes
+            const auto port_is_free = [&](size_t i) { return running.ports.count(action_plan[i].spec().name()) == 0; };
+            const auto fits = [&](size_t i) { return port_is_free(i) && fits_memory(i); };
+
+            while (running.count < jobs)
+            {
+                const size_t i = pick_next_build(scheduled, launched, committed, fits);
+                if (i == package_count)
+                {
+                    const bool next_is_waiting =
+                        scheduled[committed].is_build && !launched[committed] && port_is_free(committed);
+                    if (next_is_waiting && reported_memory_wait != committed)
+                    {
+                        reported_memory_wait = committed;
+                        System::println("Waiting for memory to start %s: it is estimated to use %s MB next to %s MB",
+                                        action_plan[committed].spec(),
+                                        std::to_string(scheduled[committed].estimated_memory_bytes >> 20),
+                                        std::to_string(std::max(running.memory_bytes, live_memory_bytes) >> 20));
+                    }
+                    break;
+                }
+
+                launched[i] = true;
+                ++running.count;
+                running.memory_bytes += scheduled[i].estimated_memory_bytes;
+                running.ports.insert(action_plan[i].spec().name());
+                const bool holds_implicit_token = running.implicit_token_free;
+                running.implicit_token_free = false;
+                System::println("Starting package %zd/%zd: %s", i + 1, package_count, action_plan[i].spec());
+
+                // The status database keeps changing on this thread, so each build checks its own copy
+                builders[i] = std::thread(
+                    [&,
+                     i,
+                     holds_implicit_token,
+                     dependencies_db = copy_status_paragraphs(status_db, scheduled[i].dependencies)]() {
+                        const auto build_timer = Chrono::ElapsedTimer::create_started();
+                        prefetcher.claim(i);
+                        const bool needs_token = jobserver != nullptr && !holds_implicit_token;
+                        if (needs_token) jobserver->acquire();
+                        auto result = std::make_unique<ExtendedBuildResult>(
+                            build_plan_action(paths,
+                                              action_plan[i].install_action.value_or_exit(VCPKG_LINE_INFO),
+                                              dependencies_db,
+                                              build_concurrency));
+                        if (needs_token) jobserver->release();
+                        const auto build_time = build_timer.elapsed();
+
+                        std::lock_guard<std::mutex> lock(running.mutex);
+                        built[i] = std::move(result);
+                        build_times[i] = build_time;
+                        if (holds_implicit_token) running.implicit_token_free = true;
+                        --running.count;
+                        running.memory_bytes -= scheduled[i].estimated_memory_bytes;
+                        running.ports.erase(action_plan[i].spec().name());
+                        running.finished.notify_all();
+                    });
+            }
+        };
+
+        auto wait_for_running_builds = [&]() {
+            for (auto&& builder : builders)
+            {
+                if (builder.joinable()) builder.join();
+            }
+        };
+
+        for (size_t i = 0; i < package_count; ++i)
+        {
+            const AnyAction& action = action_plan[i];
+            const std::string display_name = action.spec().to_string();
+            results.emplace_back(action.spec(), &action);
+
+            {
+                std::unique_lock<std::mutex> lock(running.mutex);
+                launch_ready_builds(i);
+                if (scheduled[i].is_build)
+                {
+                    const auto launch_and_check_built = [&]() {
+                        launch_ready_builds(i);
+                        return built[i] != nullptr;
+                    };
+                    // What the running builds use changes without any of them finishing
+                    if (memory_budget_bytes == 0)
+                        running.finished.wait(lock, launch_and_check_built);
+                    else
+                        while (!running.finished.wait_for(lock, std::chrono::seconds(1), launch_and_check_built))
+                        {
+                        }
+                }
+            }
+
+            const auto commit_timer = Chrono::ElapsedTimer::create_started();
+            if (!scheduled[i].is_build)
+            {
+                System::println("Starting package %zd/%zd: %s", i + 1, package_count, display_name);
+            }
+
+            if (const auto install_action = action.install_action.get())
+            {
+                ExtendedBuildResult result = BuildResult::NULLVALUE;
+                if (scheduled[i].is_build)
+                {
+                    builders[i].join();
+                    result = std::move(*built[i]);
+                    built[i].reset();
+                    if (result.code == BuildResult::SUCCEEDED)
+                    {
+                        result = install_built_package(
+                            paths, *install_action, std::move(result), status_db, ownership_indexes, file_counts);
+                    }
+                }
+                else
+                {
+                    result =
+                        perform_install_plan_action(paths, *install_action, status_db, ownership_indexes, file_counts);
+                }
+
+                if (result.code != BuildResult::SUCCEEDED && keep_going == KeepGoing::NO)
+                {
+                    System::println(Build::create_user_troubleshooting_message(install_action->spec));
+                    prefetcher.stop();
+                    wait_for_running_builds();
+                    ownership_indexes.write(paths.get_filesystem());
+                    Checks::exit_fail(VCPKG_LINE_INFO);
+                }
+
+                results.back().build_result = std::move(result);
+            }
+            else if (const auto remove_action = action.remove_action.get())
+            {
+                Remove::perform_remove_plan_action(
+                    paths, *remove_action, Remove::Purge::YES, &status_db, &ownership_indexes);
+            }
+            else
+            {
+                Checks::unreachable(VCPKG_LINE_INFO);
+            }
+
+            using Duration = std::chrono::high_resolution_clock::duration;
+            results.back().timing =
+                Chrono::ElapsedTime(build_times[i].as<Duration>() + commit_timer.elapsed().as<Duration>());
+            System::println("Elapsed time for package %s: %s", display_name, results.back().timing.to_string());
+        }
+    }
+
+    InstallSummary perform(const std::vector<AnyAction>& action_plan,
+                           const KeepGoing keep_going,
+                           const VcpkgPaths& paths,
+                           StatusParagraphs& status_db,
+                           const size_t jobs)
+    {
+        std::vector<SpecSummary> results;
+        InstalledFileCounts file_counts;
+
+        const auto timer = Chrono::ElapsedTimer::create_started();
+
+        // Loaded on the first install or remove of each triplet, and written once the plan is done
+        OwnershipIndexes ownership_indexes;
+
+        SourcePrefetcher prefetcher(paths, action_plan);
+        if (jobs > 1)
+            perform_concurrently(
+                action_plan, keep_going, paths, status_db, ownership_indexes, jobs, prefetcher, results, file_counts);
+        else
+            perform_serially(
+                action_plan, keep_going, paths, status_db, ownership_indexes, prefetcher, results, file_counts);
+        prefetcher.stop();
+        ownership_indexes.write(paths.get_filesystem());
+
+        return InstallSummary{std::move(results), timer.to_string(), file_counts};
     }
 
     static constexpr StringLiteral OPTION_DRY_RUN = "--dry-run";
@@ -405,22 +1151,97 @@ namespace vcpkg::Install
     static constexpr StringLiteral OPTION_NO_DOWNLOADS = "--no-downloads";
     static constexpr StringLiteral OPTION_RECURSE = "--recurse";
     static constexpr StringLiteral OPTION_KEEP_GOING = "--keep-going";
+    static constexpr StringLiteral OPTION_ONLY_DOWNLOADS = "--x-only-downloads";
     static constexpr StringLiteral OPTION_XUNIT = "--x-xunit";
+    static constexpr StringLiteral OPTION_JSON = "--x-json";
+    static constexpr StringLiteral OPTION_INSTALL_STRATEGY = "--x-install-strategy";
+    static constexpr StringLiteral OPTION_JOBS = "--x-jobs";
 
-    static constexpr std::array<CommandSwitch, 5> INSTALL_SWITCHES = {{
+    static constexpr std::array<CommandSwitch, 6> INSTALL_SWITCHES = {{
         {OPTION_DRY_RUN, "Do not actually build or install"},
         {OPTION_USE_HEAD_VERSION, "Install the libraries on the command line using the latest upstream sources"},
         {OPTION_NO_DOWNLOADS, "Do not download new sources"},
         {OPTION_RECURSE, "Allow removal of packages as part of installation"},
         {OPTION_KEEP_GOING, "Continue installing packages on failure"},
+        {OPTION_ONLY_DOWNLOADS, "Download the sources of every package to build, without building or installing"},
     }};
-    static constexpr std::array<CommandSetting, 1> INSTALL_SETTINGS = {{
+    static constexpr std::array<CommandSetting, 4> INSTALL_SETTINGS = {{
         {OPTION_XUNIT, "File to output results in XUnit format (Internal use)"},
+        {OPTION_JSON, "File to output results, with the resources each build used, in JSON format"},
+        {OPTION_INSTALL_STRATEGY, "How to place installed files: copy, clone (default), hardlink or move"},
+        {OPTION_JOBS, "Number of ports to build concurrently (0 for one per hardware thread)"},
     }};
 
+    size_t parse_jobs(const std::string& value)
+    {
+        char* end = nullptr;
+        const unsigned long jobs = std::strtoul(value.c_str(), &end, 10);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           !value.empty() && *end == '\0' && std::isdigit(static_cast<unsigned char>(value[0])),
+                           "Invalid number of jobs: '%s'",
+                           value);
+        if (jobs == 0) return std::max<size_t>(1, std::thread::hardware_concurrency());
+        return jobs;
+    }
+
+    uint64_t parse_memory_size(const std::string& value)
+    {
+        char* end = nullptr;
+        const unsigned long long size = std::strtoull(value.c_str(), &end, 10);
+        const bool valid = !value.empty() && std::isdigit(static_cast<unsigned char>(value[0])) &&
+                           (*end == '\0' || ((*end == 'G' || *end == 'g' || *end == 'M' || *end == 'm') && !end[1]));
+        Checks::check_exit(VCPKG_LINE_INFO, valid && size != 0, "Invalid memory size: '%s'", value);
+
+        const bool gigabytes = *end == 'G' || *end == 'g';
+        return static_cast<uint64_t>(size) << (gigabytes ? 30 : 20);
+    }
+
+    static void print_estimated_time(const VcpkgPaths& paths, const std::vector<AnyAction>& action_plan, size_t jobs)
+    {
+        std::vector<ScheduledAction> scheduled = schedule_actions(action_plan);
+        const size_t builds = std::count_if(
+            scheduled.begin(), scheduled.end(), [](const ScheduledAction& entry) { return entry.is_build; });
+        if (builds == 0) return;
+
+        const size_t unrecorded = estimate_builds(action_plan, BuildHistory::load(paths), scheduled);
+        if (unrecorded == builds)
+        {
+            System::println("No build times are recorded for these packages, so the build time cannot be estimated.");
+            return;
+        }
+
+        const auto format_us = [](uint64_t us) {
+            return Chrono::ElapsedTime(std::chrono::microseconds(us)).to_string();
+        };
+        const auto critical_path = std::max_element(
+            scheduled.begin(), scheduled.end(), [](const ScheduledAction& a, const ScheduledAction& b) {
+                return a.critical_path_us < b.critical_path_us;
+            });
+        System::println("Estimated build time with %zd job(s): %s (longest chain of builds: %s)",
+                        jobs,
+                        format_us(estimate_makespan(scheduled, jobs, GlobalState::max_memory_bytes)),
+                        format_us(critical_path->critical_path_us));
+        if (unrecorded != 0)
+        {
+            System::println("%zd of %zd builds have no recorded build time and count as the average build.",
+                            unrecorded,
+                            builds);
+        }
+    }
+
+    static Build::InstallStrategy to_install_strategy(const std::string& name)
+    {
+        if (name == "copy") return Build::InstallStrategy::COPY;
+        if (name == "clone") return Build::InstallStrategy::CLONE;
+        if (name == "hardlink") return Build::InstallStrategy::HARDLINK;
+        if (name == "move") return Build::InstallStrategy::MOVE;
+        Checks::exit_with_message(
+            VCPKG_LINE_INFO, "Unknown install strategy '%s'. Expected copy, clone, hardlink or move.", name);
+    }
+
     std::vector<std::string> get_all_port_names(const VcpkgPaths& paths)
     {
-        auto sources_and_errors = Paragraphs::try_load_all_ports(paths.get_filesystem(), paths.ports);
+        auto sources_and_errors = Paragraphs::try_load_all_ports(paths);
 
         return Util::fmap(sources_and_errors.paragraphs,
                           [](auto&& pgh) -> std::string { return pgh->core_paragraph->name; });
@@ -513,6 +1334,96 @@ namespace vcpkg::Install
         }
     }
 
+    // Computes the ABI tag of every package the plan builds, so that the plan can show which of them will be
+    // restored from the binary cache instead
+    static void find_cached_packages(const VcpkgPaths& paths,
+                                     std::vector<AnyAction>& action_plan,
+                                     const StatusParagraphs& status_db)
+    {
+        // Empty for planned packages without an ABI tag
+        std::unordered_map<PackageSpec, std::string> planned_abis;
+
+        for (auto&& action : action_plan)
+        {
+            const auto p_install = action.install_action.get();
+            if (!p_install || p_install->plan_type != InstallPlanType::BUILD_AND_INSTALL) continue;
+
+            const PackageSpec& spec = p_install->spec;
+            const SourceControlFile& scf = p_install->source_control_file.value_or_exit(VCPKG_LINE_INFO);
+            std::string& planned_abi = planned_abis[spec];
+
+            std::vector<Build::AbiEntry> dependency_abis;
+            for (auto&& dependency : Build::get_dependency_specs(scf, p_install->feature_list, spec.triplet()))
+            {
+                const auto it_planned = planned_abis.find(dependency);
+                if (it_planned != planned_abis.end())
+                {
+                    dependency_abis.push_back({dependency.name(), it_planned->second});
+                    continue;
+                }
+
+                const auto it_installed = status_db.find_installed(dependency);
+                const bool is_installed = it_installed != status_db.end();
+                dependency_abis.push_back({dependency.name(), is_installed ? (*it_installed)->package.abi : ""});
+            }
+
+            if (Util::find_if(dependency_abis, [](const Build::AbiEntry& entry) { return entry.value.empty(); }) !=
+                dependency_abis.end())
+            {
+                continue;
+            }
+
+            const Build::BuildPackageConfig config{
+                scf, spec.triplet(), paths.port_dir(spec), p_install->build_options, p_install->feature_list};
+            const Optional<Build::AbiTagAndInfo> maybe_abi = Build::compute_abi_tag(paths, config, dependency_abis);
+            if (const auto p_abi = maybe_abi.get())
+            {
+                planned_abi = p_abi->tag;
+                p_install->abi = p_abi->tag;
+                p_install->in_binary_cache = paths.get_filesystem().exists(paths.archive_path(p_abi->tag));
+            }
+        }
+    }
+
+    // Runs each build of the plan in download mode, so that a later install finds all of its sources in downloads/
+    static void download_sources_and_exit(const VcpkgPaths& paths, const std::vector<AnyAction>& action_plan)
+    {
+        std::vector<PackageSpec> failed;
+        for (auto&& action : action_plan)
+        {
+            const auto p_install = action.install_action.get();
+            if (!p_install || p_install->plan_type != InstallPlanType::BUILD_AND_INSTALL) continue;
+
+            const PackageSpec& spec = p_install->spec;
+            System::println("Downloading sources for %s... ", spec);
+            const Build::BuildPackageConfig config{p_install->source_control_file.value_or_exit(VCPKG_LINE_INFO),
+                                                   spec.triplet(),
+                                                   paths.port_dir(spec),
+                                                   p_install->build_options,
+                                                   p_install->feature_list};
+            const Build::DownloadSourcesResult result = Build::download_sources(paths, config);
+            if (result.succeeded)
+            {
+                System::println("Downloading sources for %s... done", spec);
+                continue;
+            }
+
+            System::print(result.output);
+            System::println(System::Color::error, "Downloading sources for %s... failed", spec);
+            failed.push_back(spec);
+        }
+
+        if (!failed.empty())
+        {
+            System::println(System::Color::error,
+                            "\nThe sources of the following packages could not be downloaded:\n    %s",
+                            Strings::join("\n    ", failed, [](const PackageSpec& spec) { return spec.to_string(); }));
+            Checks::exit_fail(VCPKG_LINE_INFO);
+        }
+
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths, const Triplet& default_triplet)
     {
         // input sanitization
@@ -536,7 +1447,19 @@ namespace vcpkg::Install
         const bool use_head_version = Util::Sets::contains(options.switches, (OPTION_USE_HEAD_VERSION));
         const bool no_downloads = Util::Sets::contains(options.switches, (OPTION_NO_DOWNLOADS));
         const bool is_recursive = Util::Sets::contains(options.switches, (OPTION_RECURSE));
+        const bool only_downloads = Util::Sets::contains(options.switches, OPTION_ONLY_DOWNLOADS);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           !(only_downloads && no_downloads),
+                           "%s and %s cannot be used together",
+                           OPTION_ONLY_DOWNLOADS,
+                           OPTION_NO_DOWNLOADS);
         const KeepGoing keep_going = to_keep_going(Util::Sets::contains(options.switches, OPTION_KEEP_GOING));
+        const auto it_install_strategy = options.settings.find(OPTION_INSTALL_STRATEGY);
+        const Build::InstallStrategy install_strategy = it_install_strategy == options.settings.end()
+                                                            ? Build::InstallStrategy::CLONE
+                                                            : to_install_strategy(it_install_strategy->second);
+        const auto it_jobs = options.settings.find(OPTION_JOBS);
+        const size_t jobs = it_jobs == options.settings.end() ? 1 : parse_jobs(it_jobs->second);
 
         // create the plan
         StatusParagraphs status_db = database_load_check(paths);
@@ -545,12 +1468,13 @@ namespace vcpkg::Install
             Util::Enum::to_enum<Build::UseHeadVersion>(use_head_version),
             Util::Enum::to_enum<Build::AllowDownloads>(!no_downloads),
             Build::CleanBuildtrees::NO,
+            install_strategy,
         };
 
         // Note: action_plan will hold raw pointers to SourceControlFiles from this map
         std::vector<AnyAction> action_plan;
 
-        auto all_ports = Paragraphs::load_all_ports(paths.get_filesystem(), paths.ports);
+        auto all_ports = Paragraphs::load_all_ports(paths);
         std::unordered_map<std::string, SourceControlFile> scf_map;
         for (auto&& port : all_ports)
             scf_map[port->core_paragraph->name] = std::move(*port);
@@ -582,6 +1506,11 @@ namespace vcpkg::Install
             }
         }
 
+        if (GlobalState::binary_caching)
+        {
+            find_cached_packages(paths, action_plan, status_db);
+        }
+
         // install plan will be empty if it is already installed - need to change this at status paragraph part
         Checks::check_exit(VCPKG_LINE_INFO, !action_plan.empty(), "Install plan cannot be empty");
 
@@ -600,12 +1529,20 @@ namespace vcpkg::Install
 
         if (dry_run)
         {
+            print_estimated_time(paths, action_plan, jobs);
             Checks::exit_success(VCPKG_LINE_INFO);
         }
 
-        const InstallSummary summary = perform(action_plan, keep_going, paths, status_db);
+        if (only_downloads)
+        {
+            download_sources_and_exit(paths, action_plan);
+        }
+
+        const InstallSummary summary = perform(action_plan, keep_going, paths, status_db, jobs);
+        OwnsIndex(paths.vcpkg_dir_owns_index).update(paths, status_db);
 
-        System::println("\nTotal elapsed time: %s\n", summary.total_elapsed_time);
+        System::println("\nTotal elapsed time: %s", summary.total_elapsed_time);
+        System::println("Installed files: %s\n", summary.file_counts.to_string());
 
         if (keep_going == KeepGoing::YES)
         {
@@ -623,6 +1560,13 @@ namespace vcpkg::Install
             paths.get_filesystem().write_contents(fs::u8path(it_xunit->second), xunit_doc);
         }
 
+        auto it_json = options.settings.find(OPTION_JSON);
+        if (it_json != options.settings.end())
+        {
+            const std::string json_doc = "{\"results\": [\n" + summary.json_results() + "\n]}\n";
+            paths.get_filesystem().write_contents(fs::u8path(it_json->second), json_doc);
+        }
+
         for (auto&& result : summary.results)
         {
             if (!result.action) continue;
@@ -683,6 +1627,17 @@ namespace vcpkg::Install
                 default: Checks::exit_fail(VCPKG_LINE_INFO);
             }
 
+            if (const auto usage = result.build_result.usage.get())
+            {
+                const auto trait = [](const char* name, uint64_t value) {
+                    return Strings::format(R"(<trait name="%s" value="%s"/>)", name, std::to_string(value));
+                };
+                inner_block += "<traits>" + trait("cpu_time_us", usage->cpu_time_us) +
+                               trait("peak_memory_bytes", usage->peak_memory_bytes) +
+                               trait("bytes_read", usage->bytes_read) + trait("bytes_written", usage->bytes_written) +
+                               trait("context_switches", usage->context_switches) + "</traits>";
+            }
+
             xunit_doc += Strings::format(R"(<test name="%s" method="%s" time="%lld" result="%s">%s</test>)"
                                          "\n",
                                          result.spec,
@@ -693,4 +1648,30 @@ namespace vcpkg::Install
         }
         return xunit_doc;
     }
+
+    std::string InstallSummary::json_results() const
+    {
+        std::string json;
+        for (auto&& result : results)
+        {
+            if (!json.empty()) json.append(",\n");
+            json += Strings::format(R"({"spec": %s, "result": %s, "elapsed_us": %s, "restored_from_cache": %s)",
+                                    Strings::to_json_string(result.spec.to_string()),
+                                    Strings::to_json_string(Build::to_string(result.build_result.code)),
+                                    std::to_string(result.timing.as<std::chrono::microseconds>().count()),
+                                    result.build_result.restored_from_cache ? "true" : "false");
+            if (const auto usage = result.build_result.usage.get())
+            {
+                json += Strings::format(R"(, "cpu_time_us": %s, "peak_memory_bytes": %s, "bytes_read": %s)"
+                                        R"(, "bytes_written": %s, "context_switches": %s)",
+                                        std::to_string(usage->cpu_time_us),
+                                        std::to_string(usage->peak_memory_bytes),
+                                        std::to_string(usage->bytes_read),
+                                        std::to_string(usage->bytes_written),
+                                        std::to_string(usage->context_switches));
+            }
+            json.push_back('}');
+        }
+        return json;
+    }
 }
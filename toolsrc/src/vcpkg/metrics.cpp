@@ -79,37 +79,6 @@ namespace vcpkg::Metrics
         return ID;
     }
 
-    static std::string to_json_string(const std::string& str)
-    {
-        std::string encoded = "\"";
-        for (auto&& ch : str)
-        {
-            if (ch == '\\')
-            {
-                encoded.append("\\\\");
-            }
-            else if (ch == '"')
-            {
-                encoded.append("\\\"");
-            }
-            else if (ch < 0x20 || ch >= 0x80)
-            {
-                // Note: this treats incoming Strings as Latin-1
-                static constexpr const char HEX[16] = {
-                    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
-                encoded.append("\\u00");
-                encoded.push_back(HEX[ch / 16]);
-                encoded.push_back(HEX[ch % 16]);
-            }
-            else
-            {
-                encoded.push_back(ch);
-            }
-        }
-        encoded.push_back('"');
-        return encoded;
-    }
-
     static std::string get_os_version_string()
     {
 #if defined(_WIN32)
@@ -153,15 +122,15 @@ namespace vcpkg::Metrics
         void track_property(const std::string& name, const std::string& value)
         {
             if (properties.size() != 0) properties.push_back(',');
-            properties.append(to_json_string(name));
+            properties.append(Strings::to_json_string(name));
             properties.push_back(':');
-            properties.append(to_json_string(value));
+            properties.append(Strings::to_json_string(value));
         }
 
         void track_metric(const std::string& name, double value)
         {
             if (measurements.size() != 0) measurements.push_back(',');
-            measurements.append(to_json_string(name));
+            measurements.append(Strings::to_json_string(name));
             measurements.push_back(':');
             measurements.append(std::to_string(value));
         }
@@ -0,0 +1,178 @@
+#include "pch.h"
+
+#include <vcpkg/ownershipindex.h>
+#include <vcpkg/vcpkglib.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/util.h>
+
+namespace vcpkg
+{
+    // The index file lists every package of the triplet on its own line, followed by the files it owns indented
+    // by four spaces. Paths in listfiles never start with whitespace.
+    static const std::string INDEX_HEADER = "# vcpkg file ownership index v1";
+    static const std::string FILE_INDENT = "    ";
+
+    static std::vector<std::string> get_files_in_triplet(std::vector<std::string>&& listfile_lines,
+                                                         const Triplet& triplet)
+    {
+        const std::string prefix = triplet.canonical_name() + "/";
+
+        std::vector<std::string> files;
+        for (auto&& line : listfile_lines)
+        {
+            // Directories end with a slash and are shared between packages
+            if (line.empty() || line.back() == '/') continue;
+            if (line.compare(0, prefix.size(), prefix) != 0) continue;
+            files.push_back(line.substr(prefix.size()));
+        }
+        return files;
+    }
+
+    OwnershipIndex::OwnershipIndex(const fs::path& index_file, const Triplet& triplet)
+        : m_index_file(index_file), m_triplet(triplet)
+    {
+    }
+
+    OwnershipIndex OwnershipIndex::load(const VcpkgPaths& paths,
+                                        const StatusParagraphs& status_db,
+                                        const Triplet& triplet)
+    {
+        auto& fs = paths.get_filesystem();
+        OwnershipIndex index(paths.vcpkg_dir_info / (triplet.canonical_name() + ".owners"), triplet);
+
+        std::set<std::string> installed_fullstems;
+        for (auto&& pgh : status_db)
+        {
+            if (!pgh->is_installed() || !pgh->package.feature.empty()) continue;
+            if (pgh->package.spec.triplet() != triplet) continue;
+            installed_fullstems.insert(pgh->package.fullstem());
+        }
+
+        const Expected<std::vector<std::string>> maybe_lines = fs.read_lines(index.m_index_file);
+        if (const auto lines = maybe_lines.get())
+        {
+            if (!lines->empty() && Strings::trim(std::string(lines->front())) == INDEX_HEADER)
+            {
+                std::string fullstem;
+                std::vector<std::string> files;
+                for (size_t i = 1; i < lines->size(); ++i)
+                {
+                    std::string line = Strings::trim(std::string((*lines)[i]));
+                    if (line.empty()) continue;
+
+                    if ((*lines)[i].compare(0, FILE_INDENT.size(), FILE_INDENT) == 0)
+                    {
+                        files.push_back(std::move(line));
+                        continue;
+                    }
+
+                    if (!fullstem.empty()) index.add_package_files(fullstem, std::move(files));
+                    fullstem = std::move(line);
+                    files.clear();
+                }
+                if (!fullstem.empty()) index.add_package_files(fullstem, std::move(files));
+
+                const bool matches_status_db =
+                    Util::all_equal(installed_fullstems, Util::extract_keys(index.m_package_files));
+                if (matches_status_db) return index;
+            }
+        }
+
+        // The index is missing or was not updated by the last change to the installed tree
+        Debug::println("Rebuilding %s", index.m_index_file.u8string());
+        index.m_package_files.clear();
+        index.m_owners.clear();
+        for (auto&& pgh_and_files : get_installed_files(paths, status_db))
+        {
+            const BinaryParagraph& package = pgh_and_files.pgh.package;
+            if (package.spec.triplet() != triplet) continue;
+
+            std::vector<std::string> lines(pgh_and_files.files.begin(), pgh_and_files.files.end());
+            index.add_package_files(package.fullstem(), get_files_in_triplet(std::move(lines), triplet));
+        }
+        index.write(fs);
+
+        return index;
+    }
+
+    const std::string* OwnershipIndex::find_owner(const std::string& file) const
+    {
+        const auto it = m_owners.find(file);
+        return it == m_owners.end() ? nullptr : &it->second;
+    }
+
+    void OwnershipIndex::add_package_files(const std::string& fullstem, std::vector<std::string>&& files)
+    {
+        for (auto&& file : files)
+        {
+            m_owners[file] = fullstem;
+        }
+        m_package_files[fullstem] = std::move(files);
+    }
+
+    void OwnershipIndex::add_package(const VcpkgPaths& paths, const BinaryParagraph& core_paragraph)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, core_paragraph.spec.triplet() == m_triplet);
+
+        const fs::path listfile_path = paths.listfile_path(core_paragraph);
+        auto lines = paths.get_filesystem().read_lines(listfile_path).value_or_exit(VCPKG_LINE_INFO);
+        Strings::trim_all_and_remove_whitespace_strings(&lines);
+        add_package_files(core_paragraph.fullstem(), get_files_in_triplet(std::move(lines), m_triplet));
+    }
+
+    void OwnershipIndex::remove_package(const BinaryParagraph& core_paragraph)
+    {
+        const auto it = m_package_files.find(core_paragraph.fullstem());
+        if (it == m_package_files.end()) return;
+
+        for (auto&& file : it->second)
+        {
+            const auto it_owner = m_owners.find(file);
+            if (it_owner != m_owners.end() && it_owner->second == it->first) m_owners.erase(it_owner);
+        }
+        m_package_files.erase(it);
+    }
+
+    void OwnershipIndex::write(Files::Filesystem& fs) const
+    {
+        std::string contents = INDEX_HEADER;
+        contents.push_back('\n');
+        for (auto&& package : m_package_files)
+        {
+            contents.append(package.first).push_back('\n');
+            for (auto&& file : package.second)
+            {
+                contents.append(FILE_INDENT).append(file).push_back('\n');
+            }
+        }
+
+        std::error_code ec;
+        Files::write_contents_atomically(fs, m_index_file, contents, ec);
+        Checks::check_exit(VCPKG_LINE_INFO, !ec, "Could not write %s: %s", m_index_file.u8string(), ec.message());
+    }
+
+    OwnershipIndex& OwnershipIndexes::get(const VcpkgPaths& paths,
+                                          const StatusParagraphs& status_db,
+                                          const Triplet& triplet)
+    {
+        const auto it = m_indexes.find(triplet);
+        if (it != m_indexes.end()) return it->second;
+
+        OwnershipIndex& index =
+            m_indexes.emplace(triplet, OwnershipIndex::load(paths, status_db, triplet)).first->second;
+        std::error_code ec;
+        paths.get_filesystem().remove(index.m_index_file, ec);
+        return index;
+    }
+
+    void OwnershipIndexes::write(Files::Filesystem& fs) const
+    {
+        for (auto&& index : m_indexes)
+        {
+            index.second.write(fs);
+        }
+    }
+}
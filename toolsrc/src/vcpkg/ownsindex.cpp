@@ -0,0 +1,371 @@
+#include "pch.h"
+
+#include <vcpkg/ownsindex.h>
+#include <vcpkg/vcpkglib.h>
+
+#include <vcpkg/base/system.h>
+
+namespace vcpkg
+{
+    // Bump FORMAT_VERSION whenever the layout of a segment changes
+    static constexpr char INDEX_MAGIC[8] = {'V', 'C', 'P', 'K', 'G', 'O', 'W', 'N'};
+    static constexpr std::uint32_t FORMAT_VERSION = 2;
+
+    // Every number in the index is a little-endian 32-bit unsigned integer, and the listfile stamp is two of them,
+    // low half first. A segment is laid out as
+    //     segment size (not counting this field)
+    //     fullstem size, fullstem
+    //     listfile size, listfile last write time
+    //     path count, path offsets into the blob [path count + 1]
+    //     trigram count, (trigram, first posting) [trigram count + 1]
+    //     postings (path numbers, ascending for each trigram)
+    //     blob (the paths, concatenated)
+    static constexpr size_t U32_SIZE = sizeof(std::uint32_t);
+    static constexpr size_t TRIGRAM_ENTRY_SIZE = 2 * U32_SIZE;
+
+    static std::uint32_t read_u32(const char* p)
+    {
+        std::uint32_t value = 0;
+        for (size_t i = 0; i < U32_SIZE; ++i)
+        {
+            value |= static_cast<std::uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    static void append_u32(std::string& out, std::uint32_t value)
+    {
+        for (size_t i = 0; i < U32_SIZE; ++i)
+        {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    static std::uint64_t read_u64(const char* p)
+    {
+        return std::uint64_t{read_u32(p)} | std::uint64_t{read_u32(p + U32_SIZE)} << 32;
+    }
+
+    static void append_u64(std::string& out, std::uint64_t value)
+    {
+        append_u32(out, static_cast<std::uint32_t>(value));
+        append_u32(out, static_cast<std::uint32_t>(value >> 32));
+    }
+
+    struct ListfileStamp
+    {
+        std::uint64_t size = 0;
+        std::uint64_t last_write_time = 0;
+    };
+
+    // A package that was removed and installed again, even at the same version, gets a new listfile
+    static Optional<ListfileStamp> get_listfile_stamp(const Files::Filesystem& fs, const fs::path& listfile)
+    {
+        std::error_code ec;
+        ListfileStamp stamp;
+        stamp.size = fs.file_size(listfile, ec);
+        if (ec) return nullopt;
+        stamp.last_write_time =
+            static_cast<std::uint64_t>(fs.last_write_time(listfile, ec).time_since_epoch().count());
+        if (ec) return nullopt;
+        return stamp;
+    }
+
+    static std::uint32_t get_trigram(const char* p)
+    {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(p[0])) << 16 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(p[1])) << 8 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(p[2]));
+    }
+
+    static std::string build_segment(const std::string& fullstem,
+                                     const ListfileStamp& stamp,
+                                     const SortedVector<std::string>& files)
+    {
+        std::map<std::uint32_t, std::vector<std::uint32_t>> postings;
+        std::string blob;
+        std::vector<std::uint32_t> path_offsets;
+
+        std::uint32_t path_number = 0;
+        for (auto&& file : files)
+        {
+            path_offsets.push_back(static_cast<std::uint32_t>(blob.size()));
+            blob.append(file);
+
+            for (size_t i = 0; i + 3 <= file.size(); ++i)
+            {
+                auto& trigram_postings = postings[get_trigram(file.data() + i)];
+                if (trigram_postings.empty() || trigram_postings.back() != path_number)
+                    trigram_postings.push_back(path_number);
+            }
+            ++path_number;
+        }
+        path_offsets.push_back(static_cast<std::uint32_t>(blob.size()));
+
+        std::string segment;
+        append_u32(segment, static_cast<std::uint32_t>(fullstem.size()));
+        segment.append(fullstem);
+        append_u64(segment, stamp.size);
+        append_u64(segment, stamp.last_write_time);
+
+        append_u32(segment, path_number);
+        for (auto&& offset : path_offsets)
+            append_u32(segment, offset);
+
+        append_u32(segment, static_cast<std::uint32_t>(postings.size()));
+        std::uint32_t first_posting = 0;
+        for (auto&& trigram_postings : postings)
+        {
+            append_u32(segment, trigram_postings.first);
+            append_u32(segment, first_posting);
+            first_posting += static_cast<std::uint32_t>(trigram_postings.second.size());
+        }
+        append_u32(segment, 0);
+        append_u32(segment, first_posting);
+
+        for (auto&& trigram_postings : postings)
+            for (auto&& posting : trigram_postings.second)
+                append_u32(segment, posting);
+
+        segment.append(blob);
+
+        std::string ret;
+        append_u32(ret, static_cast<std::uint32_t>(segment.size()));
+        ret.append(segment);
+        return ret;
+    }
+
+    OwnsIndex::OwnsIndex(const fs::path& index_file) : m_index_file(index_file)
+    {
+        auto maybe_mapped = Files::MappedFile::open(index_file);
+        if (!maybe_mapped.has_value()) return;
+
+        m_mapped_index = std::move(maybe_mapped).value_or_exit(VCPKG_LINE_INFO);
+        load_segments(m_mapped_index.data(), m_mapped_index.size());
+    }
+
+    void OwnsIndex::load_segments(const char* data, size_t size)
+    {
+        m_segments.clear();
+
+        const char* cur = data;
+        const char* const end = data + size;
+        // Every read is bounds checked; a truncated or corrupt index is dropped and rebuilt by update()
+        const auto take = [&](size_t n) -> const char* {
+            if (!cur || static_cast<size_t>(end - cur) < n)
+            {
+                cur = nullptr;
+                return nullptr;
+            }
+            const char* p = cur;
+            cur += n;
+            return p;
+        };
+        const auto take_u32 = [&]() -> std::uint32_t {
+            const char* p = take(U32_SIZE);
+            return p ? read_u32(p) : 0;
+        };
+
+        const char* magic = take(sizeof(INDEX_MAGIC));
+        if (!magic || memcmp(magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || take_u32() != FORMAT_VERSION)
+        {
+            if (size != 0) Debug::println("Ignoring owns index %s with unknown format", m_index_file.u8string());
+            return;
+        }
+
+        const std::uint32_t segment_count = take_u32();
+        for (std::uint32_t i = 0; i < segment_count && cur; ++i)
+        {
+            Segment segment;
+            segment.begin = cur;
+            const std::uint32_t segment_size = take_u32();
+            const char* const segment_contents = take(segment_size);
+            if (!segment_contents) break;
+            segment.end = cur;
+            cur = segment_contents;
+
+            const std::uint32_t name_size = take_u32();
+            const char* name = take(name_size);
+            const char* stamp = take(2 * sizeof(std::uint64_t));
+            if (!cur) break;
+            segment.listfile_size = read_u64(stamp);
+            segment.listfile_time = read_u64(stamp + sizeof(std::uint64_t));
+            segment.path_count = take_u32();
+            segment.path_offsets = take((std::uint64_t{segment.path_count} + 1) * U32_SIZE);
+            segment.trigram_count = take_u32();
+            segment.trigrams = take((std::uint64_t{segment.trigram_count} + 1) * TRIGRAM_ENTRY_SIZE);
+            if (!cur) break;
+
+            const std::uint32_t posting_count =
+                read_u32(segment.trigrams + segment.trigram_count * TRIGRAM_ENTRY_SIZE + U32_SIZE);
+            segment.postings = take(std::uint64_t{posting_count} * U32_SIZE);
+            const std::uint32_t blob_size = read_u32(segment.path_offsets + segment.path_count * U32_SIZE);
+            segment.blob = take(blob_size);
+            if (!cur || cur != segment.end)
+            {
+                cur = nullptr;
+                break;
+            }
+
+            bool valid = true;
+            for (std::uint32_t p = 0; p < segment.path_count && valid; ++p)
+                valid = read_u32(segment.path_offsets + p * U32_SIZE) <=
+                        read_u32(segment.path_offsets + (p + 1) * U32_SIZE);
+            for (std::uint32_t t = 0; t < segment.trigram_count && valid; ++t)
+                valid = read_u32(segment.trigrams + t * TRIGRAM_ENTRY_SIZE + U32_SIZE) <=
+                        read_u32(segment.trigrams + (t + 1) * TRIGRAM_ENTRY_SIZE + U32_SIZE);
+            for (std::uint32_t p = 0; p < posting_count && valid; ++p)
+                valid = read_u32(segment.postings + p * U32_SIZE) < segment.path_count;
+            if (!valid)
+            {
+                cur = nullptr;
+                break;
+            }
+
+            m_segments.emplace(std::string_view(name, name_size), segment);
+        }
+
+        if (!cur)
+        {
+            Debug::println("Owns index %s is corrupt", m_index_file.u8string());
+            m_segments.clear();
+        }
+    }
+
+    void OwnsIndex::update(const VcpkgPaths& paths, const StatusParagraphs& status_db)
+    {
+        auto& fs = paths.get_filesystem();
+
+        struct InstalledPackage
+        {
+            const BinaryParagraph* package;
+            // nullopt if the listfile could not be read; such packages are indexed again on every update
+            Optional<ListfileStamp> stamp;
+            // Points into the current index if its segment is still up to date
+            const Segment* segment;
+        };
+
+        std::map<std::string, InstalledPackage> installed_packages;
+        bool changed = false;
+        for (auto&& pgh : status_db)
+        {
+            if (!pgh->is_installed() || !pgh->package.feature.empty()) continue;
+
+            const auto stamp = get_listfile_stamp(fs, paths.listfile_path(pgh->package));
+            InstalledPackage installed{&pgh->package, stamp, nullptr};
+            const std::string fullstem = pgh->package.fullstem();
+            const auto it = m_segments.find(fullstem);
+            const auto p_stamp = stamp.get();
+            if (it != m_segments.end() && p_stamp && it->second.listfile_size == p_stamp->size &&
+                it->second.listfile_time == p_stamp->last_write_time)
+            {
+                installed.segment = &it->second;
+            }
+            else
+            {
+                changed = true;
+            }
+            installed_packages.emplace(fullstem, installed);
+        }
+
+        if (!changed && installed_packages.size() == m_segments.size()) return;
+
+        std::string contents(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        append_u32(contents, FORMAT_VERSION);
+        append_u32(contents, static_cast<std::uint32_t>(installed_packages.size()));
+        for (auto&& package : installed_packages)
+        {
+            const InstalledPackage& installed = package.second;
+            if (installed.segment)
+            {
+                contents.append(installed.segment->begin, installed.segment->end);
+                continue;
+            }
+
+            const ListfileStamp stamp = installed.stamp.value_or(ListfileStamp{});
+            contents.append(build_segment(package.first, stamp, get_installed_files(paths, *installed.package)));
+        }
+
+        // The old index must be unmapped before it can be replaced on Windows
+        m_segments.clear();
+        m_mapped_index.reset();
+        m_contents = std::move(contents);
+        load_segments(m_contents.data(), m_contents.size());
+
+        // The index is only a cache, so failing to update it is not an error
+        std::error_code ec;
+        Files::write_contents_atomically(fs, m_index_file, m_contents, ec);
+        if (ec) Debug::println("Could not update owns index %s: %s", m_index_file.u8string(), ec.message());
+    }
+
+    std::vector<std::string> OwnsIndex::find_files(const std::string& fullstem,
+                                                   const std::string& query,
+                                                   bool exact_filename) const
+    {
+        std::vector<std::string> ret;
+
+        const auto it = m_segments.find(fullstem);
+        if (it == m_segments.end()) return ret;
+        const Segment& segment = it->second;
+
+        // Every installed path starts with the triplet directory, so a file name always follows a slash
+        const std::string needle = exact_filename ? "/" + query : query;
+
+        const auto get_path = [&](std::uint32_t path_number) {
+            const std::uint32_t begin = read_u32(segment.path_offsets + path_number * U32_SIZE);
+            const std::uint32_t end = read_u32(segment.path_offsets + (path_number + 1) * U32_SIZE);
+            return std::string_view(segment.blob + begin, end - begin);
+        };
+        const auto add_if_matches = [&](std::uint32_t path_number) {
+            const std::string_view path = get_path(path_number);
+            bool matches;
+            if (exact_filename)
+                matches = path.size() >= needle.size() && path.substr(path.size() - needle.size()) == needle;
+            else
+                matches = path.find(needle) != std::string_view::npos;
+            if (matches) ret.emplace_back(path);
+        };
+
+        if (needle.size() < 3)
+        {
+            for (std::uint32_t p = 0; p < segment.path_count; ++p)
+                add_if_matches(p);
+            return ret;
+        }
+
+        // Only the paths containing the rarest trigram of the needle need to be checked
+        const char* best_postings = nullptr;
+        std::uint32_t best_count = 0;
+        for (size_t i = 0; i + 3 <= needle.size(); ++i)
+        {
+            const std::uint32_t trigram = get_trigram(needle.data() + i);
+
+            std::uint32_t lo = 0;
+            std::uint32_t hi = segment.trigram_count;
+            while (lo < hi)
+            {
+                const std::uint32_t mid = lo + (hi - lo) / 2;
+                if (read_u32(segment.trigrams + mid * TRIGRAM_ENTRY_SIZE) < trigram)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+
+            if (lo == segment.trigram_count || read_u32(segment.trigrams + lo * TRIGRAM_ENTRY_SIZE) != trigram)
+                return ret;
+
+            const char* entry = segment.trigrams + lo * TRIGRAM_ENTRY_SIZE;
+            const std::uint32_t first = read_u32(entry + U32_SIZE);
+            const std::uint32_t count = read_u32(entry + TRIGRAM_ENTRY_SIZE + U32_SIZE) - first;
+            if (!best_postings || count < best_count)
+            {
+                best_postings = segment.postings + std::uint64_t{first} * U32_SIZE;
+                best_count = count;
+            }
+        }
+
+        for (std::uint32_t i = 0; i < best_count; ++i)
+            add_if_matches(read_u32(best_postings + i * U32_SIZE));
+        return ret;
+    }
+}
@@ -60,18 +60,18 @@ namespace vcpkg::Paragraphs
 
         static bool is_lineend(char ch) { return ch == '\r' || ch == '\n' || ch == 0; }
 
-        void get_fieldvalue(char& ch, std::string& fieldvalue)
+        void get_fieldvalue(char& ch, std::string_view& fieldvalue)
         {
-            fieldvalue.clear();
-
-            auto beginning_of_line = cur;
+            const auto begin_fieldvalue = cur;
+            auto end_fieldvalue = cur;
             do
             {
                 // scan to end of current line (it is part of the field value)
                 while (!is_lineend(ch))
                     next(ch);
 
-                fieldvalue.append(beginning_of_line, cur);
+                end_fieldvalue = cur;
+                fieldvalue = std::string_view(begin_fieldvalue, end_fieldvalue - begin_fieldvalue);
 
                 if (ch == '\r') next(ch);
                 if (ch == '\n') next(ch);
@@ -82,8 +82,6 @@ namespace vcpkg::Paragraphs
                     return;
                 }
 
-                beginning_of_line = cur;
-
                 // Line may continue the current field with data or terminate the paragraph,
                 // depending on first nonspace character.
                 skip_spaces(ch);
@@ -96,30 +94,27 @@ namespace vcpkg::Paragraphs
                     return;
                 }
 
-                // First nonspace is not a newline. This continues the current field value.
-                // We forcibly convert all newlines into single '\n' for ease of text handling later on.
-                fieldvalue.push_back('\n');
+                // First nonspace is not a newline. This continues the current field value, including the line
+                // ending and leading whitespace; ParagraphField::value_string() normalizes the line endings.
             } while (true);
         }
 
-        void get_fieldname(char& ch, std::string& fieldname)
+        void get_fieldname(char& ch, std::string_view& fieldname)
         {
             auto begin_fieldname = cur;
             while (is_alphanum(ch) || ch == '-')
                 next(ch);
             Checks::check_exit(VCPKG_LINE_INFO, ch == ':', "Expected ':'");
-            fieldname = std::string(begin_fieldname, cur);
+            fieldname = std::string_view(begin_fieldname, cur - begin_fieldname);
 
             // skip ': '
             next(ch);
             skip_spaces(ch);
         }
 
-        void get_paragraph(char& ch, std::unordered_map<std::string, std::string>& fields)
+        void get_paragraph(char& ch, std::vector<ParagraphField>& fields)
         {
-            fields.clear();
-            std::string fieldname;
-            std::string fieldvalue;
+            const size_t first_field = fields.size();
             do
             {
                 if (is_comment(ch))
@@ -128,22 +123,24 @@ namespace vcpkg::Paragraphs
                     continue;
                 }
 
-                get_fieldname(ch, fieldname);
+                ParagraphField field;
+                get_fieldname(ch, field.name);
+                field.id = intern_field_name(field.name);
 
-                auto it = fields.find(fieldname);
-                Checks::check_exit(VCPKG_LINE_INFO, it == fields.end(), "Duplicate field");
+                for (size_t i = first_field; i < fields.size(); ++i)
+                {
+                    Checks::check_exit(VCPKG_LINE_INFO, fields[i].name != field.name, "Duplicate field");
+                }
 
-                get_fieldvalue(ch, fieldvalue);
+                get_fieldvalue(ch, field.value);
 
-                fields.emplace(fieldname, fieldvalue);
+                fields.push_back(field);
             } while (!is_lineend(ch));
         }
 
     public:
-        std::vector<std::unordered_map<std::string, std::string>> get_paragraphs()
+        void get_paragraphs(std::vector<ParagraphField>& fields, std::vector<size_t>& paragraph_ends)
         {
-            std::vector<std::unordered_map<std::string, std::string>> paragraphs;
-
             char ch;
             peek(ch);
 
@@ -155,14 +152,51 @@ namespace vcpkg::Paragraphs
                     continue;
                 }
 
-                paragraphs.emplace_back();
-                get_paragraph(ch, paragraphs.back());
+                get_paragraph(ch, fields);
+                paragraph_ends.push_back(fields.size());
             }
-
-            return paragraphs;
         }
     };
 
+    ParsedParagraphs::ParsedParagraphs(std::string&& text) : m_text(std::make_unique<std::string>(std::move(text)))
+    {
+        Parser(m_text->data(), m_text->data() + m_text->size()).get_paragraphs(m_fields, m_paragraph_ends);
+    }
+
+    ParagraphView ParsedParagraphs::operator[](size_t i) const
+    {
+        const size_t begin = i == 0 ? 0 : m_paragraph_ends[i - 1];
+        return {m_fields.data() + begin, m_fields.data() + m_paragraph_ends[i]};
+    }
+
+    std::vector<ParagraphView> ParsedParagraphs::paragraphs() const
+    {
+        std::vector<ParagraphView> ret;
+        ret.reserve(size());
+        for (size_t i = 0; i < size(); ++i)
+            ret.push_back((*this)[i]);
+        return ret;
+    }
+
+    static RawParagraph to_raw_paragraph(ParagraphView pgh)
+    {
+        RawParagraph fields;
+        for (auto&& field : pgh)
+            fields.emplace(field.name, field.value_string());
+        return fields;
+    }
+
+    Expected<ParsedParagraphs> get_parsed_paragraphs(const Files::Filesystem& fs, const fs::path& control_path)
+    {
+        Expected<std::string> contents = fs.read_contents(control_path);
+        if (auto spgh = contents.get())
+        {
+            return ParsedParagraphs(std::move(*spgh));
+        }
+
+        return contents.error();
+    }
+
     Expected<std::unordered_map<std::string, std::string>> get_single_paragraph(const Files::Filesystem& fs,
                                                                                 const fs::path& control_path)
     {
@@ -189,12 +223,11 @@ namespace vcpkg::Paragraphs
 
     Expected<std::unordered_map<std::string, std::string>> parse_single_paragraph(const std::string& str)
     {
-        const std::vector<std::unordered_map<std::string, std::string>> p =
-            Parser(str.c_str(), str.c_str() + str.size()).get_paragraphs();
+        const ParsedParagraphs p(std::string{str});
 
         if (p.size() == 1)
         {
-            return p.at(0);
+            return to_raw_paragraph(p[0]);
         }
 
         return std::error_code(ParagraphParseResult::EXPECTED_ONE_PARAGRAPH);
@@ -202,25 +235,30 @@ namespace vcpkg::Paragraphs
 
     Expected<std::vector<std::unordered_map<std::string, std::string>>> parse_paragraphs(const std::string& str)
     {
-        return Parser(str.c_str(), str.c_str() + str.size()).get_paragraphs();
+        const ParsedParagraphs p(std::string{str});
+        return Util::fmap(p.paragraphs(), to_raw_paragraph);
     }
 
-    ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs, const fs::path& path)
+    static ParseExpected<SourceControlFile> apply_feature_packages_setting(ParseExpected<SourceControlFile>&& csf)
     {
-        Expected<std::vector<std::unordered_map<std::string, std::string>>> pghs = get_paragraphs(fs, path / "CONTROL");
-        if (auto vector_pghs = pghs.get())
+        if (!GlobalState::feature_packages)
         {
-            auto csf = SourceControlFile::parse_control_file(std::move(*vector_pghs));
-            if (!GlobalState::feature_packages)
+            if (auto ptr = csf.get())
             {
-                if (auto ptr = csf.get())
-                {
-                    Checks::check_exit(VCPKG_LINE_INFO, ptr->get() != nullptr);
-                    ptr->get()->core_paragraph->default_features.clear();
-                    ptr->get()->feature_paragraphs.clear();
-                }
+                Checks::check_exit(VCPKG_LINE_INFO, ptr->get() != nullptr);
+                ptr->get()->core_paragraph->default_features.clear();
+                ptr->get()->feature_paragraphs.clear();
             }
-            return csf;
+        }
+        return std::move(csf);
+    }
+
+    ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs, const fs::path& path)
+    {
+        const Expected<ParsedParagraphs> pghs = get_parsed_paragraphs(fs, path / "CONTROL");
+        if (auto parsed_pghs = pghs.get())
+        {
+            return apply_feature_packages_setting(SourceControlFile::parse_control_file(parsed_pghs->paragraphs()));
         }
         auto error_info = std::make_unique<ParseControlErrorInfo>();
         error_info->name = path.filename().generic_u8string();
@@ -228,19 +266,25 @@ namespace vcpkg::Paragraphs
         return error_info;
     }
 
+    ParseExpected<SourceControlFile> try_load_port(const Files::Filesystem& fs,
+                                                   const fs::path& path,
+                                                   const PortIndex& index)
+    {
+        return apply_feature_packages_setting(index.try_load_port(fs, path));
+    }
+
     Expected<BinaryControlFile> try_load_cached_control_package(const VcpkgPaths& paths, const PackageSpec& spec)
     {
-        Expected<std::vector<std::unordered_map<std::string, std::string>>> pghs =
-            get_paragraphs(paths.get_filesystem(), paths.package_dir(spec) / "CONTROL");
+        const Expected<ParsedParagraphs> pghs =
+            get_parsed_paragraphs(paths.get_filesystem(), paths.package_dir(spec) / "CONTROL");
 
         if (auto p = pghs.get())
         {
             BinaryControlFile bcf;
-            bcf.core_paragraph = BinaryParagraph(p->front());
-            p->erase(p->begin());
+            bcf.core_paragraph = BinaryParagraph((*p)[0]);
 
-            bcf.features =
-                Util::fmap(*p, [&](auto&& raw_feature) -> BinaryParagraph { return BinaryParagraph(raw_feature); });
+            for (size_t i = 1; i < p->size(); ++i)
+                bcf.features.emplace_back((*p)[i]);
 
             return bcf;
         }
@@ -248,12 +292,11 @@ namespace vcpkg::Paragraphs
         return pghs.error();
     }
 
-    LoadResults try_load_all_ports(const Files::Filesystem& fs, const fs::path& ports_dir)
+    static LoadResults collect_load_results(std::vector<ParseExpected<SourceControlFile>>&& maybe_spghs)
     {
         LoadResults ret;
-        for (auto&& path : fs.get_files_non_recursive(ports_dir))
+        for (auto&& maybe_spgh : maybe_spghs)
         {
-            auto maybe_spgh = try_load_port(fs, path);
             if (const auto spgh = maybe_spgh.get())
             {
                 ret.paragraphs.emplace_back(std::move(*spgh));
@@ -266,10 +309,38 @@ namespace vcpkg::Paragraphs
         return ret;
     }
 
-    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const Files::Filesystem& fs,
-                                                                   const fs::path& ports_dir)
+    // Sort the port directories so that the results do not depend on the directory enumeration order
+    static std::vector<fs::path> get_sorted_port_dirs(const Files::Filesystem& fs, const fs::path& ports_dir)
+    {
+        auto port_dirs = fs.get_files_non_recursive(ports_dir);
+        Util::sort(port_dirs);
+        return port_dirs;
+    }
+
+    LoadResults try_load_all_ports(const Files::Filesystem& fs, const fs::path& ports_dir)
+    {
+        const auto port_dirs = get_sorted_port_dirs(fs, ports_dir);
+
+        // Reading and parsing the CONTROL files is independent for each port
+        return collect_load_results(
+            Util::parallel_fmap(port_dirs, [&](const fs::path& path) { return try_load_port(fs, path); }));
+    }
+
+    LoadResults try_load_all_ports(const VcpkgPaths& paths)
+    {
+        auto& fs = paths.get_filesystem();
+        const auto port_dirs = get_sorted_port_dirs(fs, paths.ports);
+
+        PortIndex index(paths.ports_index_file, UpdatePortIndex::YES);
+        auto results = collect_load_results(
+            Util::parallel_fmap(port_dirs, [&](const fs::path& path) { return try_load_port(fs, path, index); }));
+        index.write(fs);
+
+        return results;
+    }
+
+    static std::vector<std::unique_ptr<SourceControlFile>> report_load_errors(LoadResults&& results)
     {
-        auto results = try_load_all_ports(fs, ports_dir);
         if (!results.errors.empty())
         {
             if (GlobalState::debugging)
@@ -289,4 +360,15 @@ namespace vcpkg::Paragraphs
         }
         return std::move(results.paragraphs);
     }
+
+    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const Files::Filesystem& fs,
+                                                                   const fs::path& ports_dir)
+    {
+        return report_load_errors(try_load_all_ports(fs, ports_dir));
+    }
+
+    std::vector<std::unique_ptr<SourceControlFile>> load_all_ports(const VcpkgPaths& paths)
+    {
+        return report_load_errors(try_load_all_ports(paths));
+    }
 }
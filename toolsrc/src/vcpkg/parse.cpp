@@ -7,40 +7,105 @@
 
 namespace vcpkg::Parse
 {
-    static Optional<std::string> remove_field(std::unordered_map<std::string, std::string>* fields,
-                                              const std::string& fieldname)
+    FieldId intern_field_name(std::string_view fieldname)
     {
-        auto it = fields->find(fieldname);
-        if (it == fields->end())
+        static constexpr std::pair<std::string_view, FieldId> KNOWN_FIELDS[] = {
+            {"Abi", FieldId::ABI},
+            {"Architecture", FieldId::ARCHITECTURE},
+            {"Build-Depends", FieldId::BUILD_DEPENDS},
+            {"Default-Features", FieldId::DEFAULT_FEATURES},
+            {"Depends", FieldId::DEPENDS},
+            {"Description", FieldId::DESCRIPTION},
+            {"Feature", FieldId::FEATURE},
+            {"Maintainer", FieldId::MAINTAINER},
+            {"Multi-Arch", FieldId::MULTI_ARCH},
+            {"Package", FieldId::PACKAGE},
+            {"Source", FieldId::SOURCE},
+            {"Status", FieldId::STATUS},
+            {"Supports", FieldId::SUPPORTS},
+            {"Version", FieldId::VERSION},
+        };
+
+        for (auto&& known_field : KNOWN_FIELDS)
         {
-            return nullopt;
+            if (known_field.first == fieldname) return known_field.second;
         }
+        return FieldId::UNKNOWN;
+    }
+
+    std::string ParagraphField::value_string() const
+    {
+        if (value.find('\r') == std::string_view::npos) return std::string(value);
 
-        const std::string value = std::move(it->second);
-        fields->erase(it);
-        return value;
+        // Convert "\r\n" and lone "\r" line endings into '\n'
+        std::string out;
+        out.reserve(value.size());
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            if (value[i] != '\r')
+                out.push_back(value[i]);
+            else if (i + 1 == value.size() || value[i + 1] != '\n')
+                out.push_back('\n');
+        }
+        return out;
+    }
+
+    ParagraphParser::ParagraphParser(RawParagraph&& raw_fields)
+    {
+        owned_fields.reserve(raw_fields.size());
+        for (auto&& field : raw_fields)
+        {
+            owned_fields.push_back({intern_field_name(field.first), field.first, field.second});
+        }
+        fields = owned_fields;
+        consumed.resize(fields.size());
+    }
+
+    ParagraphParser::ParagraphParser(ParagraphView fields) : fields(fields), consumed(fields.size()) {}
+
+    const ParagraphField* ParagraphParser::remove_field(const std::string& fieldname) const
+    {
+        const FieldId id = intern_field_name(fieldname);
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            if (consumed[i]) continue;
+
+            const ParagraphField& field = fields[i];
+            if (id != FieldId::UNKNOWN ? field.id == id : field.name == fieldname)
+            {
+                consumed[i] = true;
+                return &field;
+            }
+        }
+        return nullptr;
     }
 
     void ParagraphParser::required_field(const std::string& fieldname, std::string& out)
     {
-        auto maybe_field = remove_field(&fields, fieldname);
-        if (const auto field = maybe_field.get())
-            out = std::move(*field);
+        if (const auto field = remove_field(fieldname))
+            out = field->value_string();
         else
             missing_fields.push_back(fieldname);
     }
     std::string ParagraphParser::optional_field(const std::string& fieldname) const
     {
-        return remove_field(&fields, fieldname).value_or("");
+        if (const auto field = remove_field(fieldname)) return field->value_string();
+        return std::string();
     }
     std::unique_ptr<ParseControlErrorInfo> ParagraphParser::error_info(const std::string& name) const
     {
-        if (!fields.empty() || !missing_fields.empty())
+        std::vector<std::string> extra_fields;
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            if (!consumed[i]) extra_fields.emplace_back(fields[i].name);
+        }
+
+        if (!extra_fields.empty() || !missing_fields.empty())
         {
             auto err = std::make_unique<ParseControlErrorInfo>();
             err->name = name;
-            err->extra_fields = Util::extract_keys(fields);
-            err->missing_fields = std::move(missing_fields);
+            err->extra_fields = std::move(extra_fields);
+            err->missing_fields = missing_fields;
             return err;
         }
         return nullptr;
@@ -0,0 +1,347 @@
+#include "pch.h"
+
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/portindex.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/system.h>
+
+namespace vcpkg
+{
+    // Bump FORMAT_VERSION whenever the layout of the serialized SourceControlFile changes
+    static constexpr char INDEX_MAGIC[8] = {'V', 'C', 'P', 'K', 'G', 'P', 'I', 'X'};
+    static constexpr std::uint64_t FORMAT_VERSION = 1;
+
+    namespace
+    {
+        struct BinaryWriter
+        {
+            std::string& out;
+
+            void write_u64(std::uint64_t value)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+                }
+            }
+
+            void write_string(const std::string& s)
+            {
+                write_u64(s.size());
+                out.append(s);
+            }
+
+            void write_strings(const std::vector<std::string>& strings)
+            {
+                write_u64(strings.size());
+                for (auto&& s : strings)
+                    write_string(s);
+            }
+
+            void write_dependencies(const std::vector<Dependency>& deps)
+            {
+                write_u64(deps.size());
+                for (auto&& dep : deps)
+                {
+                    write_string(dep.depend.name);
+                    write_strings(dep.depend.features);
+                    write_string(dep.qualifier);
+                }
+            }
+        };
+
+        // All reads are bounds checked; a truncated or corrupt index clears `ok` instead of failing.
+        struct BinaryReader
+        {
+            const char* cur;
+            const char* end;
+            bool ok = true;
+
+            std::uint64_t read_u64()
+            {
+                if (end - cur < 8)
+                {
+                    ok = false;
+                    cur = end;
+                    return 0;
+                }
+
+                std::uint64_t value = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(cur[i])) << (8 * i);
+                }
+                cur += 8;
+                return value;
+            }
+
+            const char* read_bytes(std::uint64_t size)
+            {
+                if (static_cast<std::uint64_t>(end - cur) < size)
+                {
+                    ok = false;
+                    cur = end;
+                    return nullptr;
+                }
+
+                const char* bytes = cur;
+                cur += size;
+                return bytes;
+            }
+
+            std::string read_string()
+            {
+                const auto size = read_u64();
+                const char* bytes = read_bytes(size);
+                if (!bytes) return std::string();
+                return std::string(bytes, static_cast<size_t>(size));
+            }
+
+            std::vector<std::string> read_strings()
+            {
+                std::vector<std::string> strings;
+                const auto count = read_u64();
+                for (std::uint64_t i = 0; i < count && ok; ++i)
+                    strings.push_back(read_string());
+                return strings;
+            }
+
+            std::vector<Dependency> read_dependencies()
+            {
+                std::vector<Dependency> deps;
+                const auto count = read_u64();
+                for (std::uint64_t i = 0; i < count && ok; ++i)
+                {
+                    Dependency dep;
+                    dep.depend.name = read_string();
+                    dep.depend.features = read_strings();
+                    dep.qualifier = read_string();
+                    deps.push_back(std::move(dep));
+                }
+                return deps;
+            }
+        };
+    }
+
+    static std::uint64_t hash_contents(const std::string& contents)
+    {
+        // 64-bit FNV-1a
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const char c : contents)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static std::string serialize_control_file(const SourceControlFile& scf)
+    {
+        std::string record;
+        BinaryWriter writer{record};
+
+        const SourceParagraph& core = *scf.core_paragraph;
+        writer.write_string(core.name);
+        writer.write_string(core.version);
+        writer.write_string(core.description);
+        writer.write_string(core.maintainer);
+        writer.write_strings(core.supports);
+        writer.write_dependencies(core.depends);
+        writer.write_strings(core.default_features);
+
+        writer.write_u64(scf.feature_paragraphs.size());
+        for (auto&& feature : scf.feature_paragraphs)
+        {
+            writer.write_string(feature->name);
+            writer.write_string(feature->description);
+            writer.write_dependencies(feature->depends);
+        }
+
+        return record;
+    }
+
+    static std::unique_ptr<SourceControlFile> deserialize_control_file(const char* record, size_t record_size)
+    {
+        BinaryReader reader{record, record + record_size};
+
+        auto scf = std::make_unique<SourceControlFile>();
+        scf->core_paragraph = std::make_unique<SourceParagraph>();
+
+        SourceParagraph& core = *scf->core_paragraph;
+        core.name = reader.read_string();
+        core.version = reader.read_string();
+        core.description = reader.read_string();
+        core.maintainer = reader.read_string();
+        core.supports = reader.read_strings();
+        core.depends = reader.read_dependencies();
+        core.default_features = reader.read_strings();
+
+        const auto feature_count = reader.read_u64();
+        for (std::uint64_t i = 0; i < feature_count && reader.ok; ++i)
+        {
+            auto feature = std::make_unique<FeatureParagraph>();
+            feature->name = reader.read_string();
+            feature->description = reader.read_string();
+            feature->depends = reader.read_dependencies();
+            scf->feature_paragraphs.push_back(std::move(feature));
+        }
+
+        if (!reader.ok || reader.cur != reader.end) return nullptr;
+        return scf;
+    }
+
+    PortIndex::PortIndex(const fs::path& index_file, const UpdatePortIndex update)
+        : m_index_file(index_file), m_update(update)
+    {
+        auto maybe_mapped = Files::MappedFile::open(index_file);
+        if (!maybe_mapped.has_value()) return;
+
+        m_mapped_index = std::move(maybe_mapped).value_or_exit(VCPKG_LINE_INFO);
+        BinaryReader reader{m_mapped_index.data(), m_mapped_index.data() + m_mapped_index.size()};
+
+        const char* magic = reader.read_bytes(sizeof(INDEX_MAGIC));
+        if (!magic || memcmp(magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || reader.read_u64() != FORMAT_VERSION)
+        {
+            Debug::println("Ignoring port index %s with unknown format", index_file.u8string());
+            return;
+        }
+
+        const auto port_count = reader.read_u64();
+        for (std::uint64_t i = 0; i < port_count && reader.ok; ++i)
+        {
+            std::string name = reader.read_string();
+            IndexedPort port;
+            port.stamp.last_write_time = static_cast<std::int64_t>(reader.read_u64());
+            port.stamp.size = reader.read_u64();
+            port.stamp.hash = reader.read_u64();
+            port.record_size = static_cast<size_t>(reader.read_u64());
+            port.record = reader.read_bytes(port.record_size);
+            if (reader.ok) m_indexed_ports.emplace(std::move(name), port);
+        }
+
+        if (!reader.ok)
+        {
+            Debug::println("Port index %s is truncated", index_file.u8string());
+            m_indexed_ports.clear();
+        }
+    }
+
+    Parse::ParseExpected<SourceControlFile> PortIndex::try_load_port(const Files::Filesystem& fs,
+                                                                     const fs::path& port_dir) const
+    {
+        const std::string name = port_dir.filename().u8string();
+        const fs::path control_path = port_dir / "CONTROL";
+
+        std::error_code ec;
+        Stamp stamp{};
+        stamp.last_write_time = fs.last_write_time(control_path, ec).time_since_epoch().count();
+        if (!ec) stamp.size = fs.file_size(control_path, ec);
+        if (ec)
+        {
+            // Not a port; report it exactly like an uncached load would
+            return Paragraphs::try_load_port(fs, port_dir);
+        }
+
+        const auto it_indexed = m_indexed_ports.find(name);
+        const IndexedPort* indexed = it_indexed == m_indexed_ports.end() ? nullptr : &it_indexed->second;
+
+        if (indexed && indexed->stamp.last_write_time == stamp.last_write_time && indexed->stamp.size == stamp.size)
+        {
+            if (auto scf = deserialize_control_file(indexed->record, indexed->record_size))
+            {
+                if (m_update == UpdatePortIndex::YES)
+                    m_loaded_ports.lock()->emplace(name, LoadedPort{indexed->stamp, std::string()});
+                return scf;
+            }
+        }
+
+        Expected<std::string> contents = fs.read_contents(control_path);
+        std::string* text = contents.get();
+        if (!text)
+        {
+            auto error_info = std::make_unique<Parse::ParseControlErrorInfo>();
+            error_info->name = name;
+            error_info->error = contents.error();
+            return error_info;
+        }
+
+        stamp.hash = hash_contents(*text);
+
+        if (indexed && indexed->stamp.hash == stamp.hash && indexed->stamp.size == stamp.size)
+        {
+            // Only the timestamp changed
+            if (auto scf = deserialize_control_file(indexed->record, indexed->record_size))
+            {
+                if (m_update == UpdatePortIndex::YES)
+                    m_loaded_ports.lock()->emplace(name, LoadedPort{stamp, std::string()});
+                return scf;
+            }
+        }
+
+        const Paragraphs::ParsedParagraphs pghs(std::move(*text));
+        auto csf = SourceControlFile::parse_control_file(pghs.paragraphs());
+        if (m_update == UpdatePortIndex::NO) return csf;
+
+        if (auto scf = csf.get())
+        {
+            m_loaded_ports.lock()->emplace(name, LoadedPort{stamp, serialize_control_file(**scf)});
+        }
+        return csf;
+    }
+
+    void PortIndex::write(Files::Filesystem& fs)
+    {
+        Checks::check_exit(VCPKG_LINE_INFO, m_update == UpdatePortIndex::YES);
+
+        auto loaded_ports = m_loaded_ports.lock();
+
+        bool changed = loaded_ports->size() != m_indexed_ports.size();
+        for (auto&& loaded_port : *loaded_ports)
+        {
+            const auto it_indexed = m_indexed_ports.find(loaded_port.first);
+            if (it_indexed == m_indexed_ports.end() || !loaded_port.second.new_record.empty() ||
+                it_indexed->second.stamp.last_write_time != loaded_port.second.stamp.last_write_time)
+            {
+                changed = true;
+                break;
+            }
+        }
+
+        if (!changed) return;
+
+        std::string contents(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        BinaryWriter writer{contents};
+        writer.write_u64(FORMAT_VERSION);
+        writer.write_u64(loaded_ports->size());
+        for (auto&& loaded_port : *loaded_ports)
+        {
+            const LoadedPort& port = loaded_port.second;
+            writer.write_string(loaded_port.first);
+            writer.write_u64(static_cast<std::uint64_t>(port.stamp.last_write_time));
+            writer.write_u64(port.stamp.size);
+            writer.write_u64(port.stamp.hash);
+            if (port.new_record.empty())
+            {
+                const IndexedPort& indexed = m_indexed_ports.at(loaded_port.first);
+                writer.write_u64(indexed.record_size);
+                contents.append(indexed.record, indexed.record_size);
+            }
+            else
+            {
+                writer.write_string(port.new_record);
+            }
+        }
+
+        // The old index must be unmapped before it can be replaced on Windows
+        m_indexed_ports.clear();
+        loaded_ports->clear();
+        m_mapped_index.reset();
+
+        // The index is only a cache, so failing to update it is not an error
+        // Other vcpkg processes may be updating the index at the same time; the last rename wins
+        std::error_code ec;
+        Files::write_contents_atomically(fs, m_index_file, contents, ec);
+        if (ec) Debug::println("Could not update port index %s: %s", m_index_file.u8string(), ec.message());
+    }
+}
@@ -1,7 +1,10 @@
 #include "pch.h"
 
+#include <vcpkg/base/chrono.h>
 #include <vcpkg/base/cofffilereader.h>
+#include <vcpkg/base/elffilereader.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
@@ -16,17 +19,166 @@ using vcpkg::Build::PreBuildInfo;
 
 namespace vcpkg::PostBuildLint
 {
-    static auto has_extension_pred(const Files::Filesystem& fs, const std::string& ext)
-    {
-        return [&fs, ext](const fs::path& path) { return !fs.is_directory(path) && path.extension() == ext; };
-    }
-
     enum class LintStatus
     {
         SUCCESS = 0,
         ERROR_DETECTED = 1
     };
 
+    /// <summary>
+    /// A file or directory below the package directory
+    /// </summary>
+    struct PackageEntry
+    {
+        fs::path path;
+        /// <summary>
+        /// Relative to the package directory, with '/' separators, e.g. "debug/lib/zlib.lib"
+        /// </summary>
+        std::string relative_path;
+        bool is_directory;
+        /// <summary>
+        /// True for regular files that are not symlinks
+        /// </summary>
+        bool is_regular_file;
+        /// <summary>
+        /// True for symlinks to directories with entries. The walk does not descend into them, so their entries are
+        /// never visited.
+        /// </summary>
+        bool is_non_empty_symlinked_directory;
+
+        bool is_below(const std::string& dir) const
+        {
+            return relative_path.size() > dir.size() && relative_path[dir.size()] == '/' &&
+                   relative_path.compare(0, dir.size(), dir) == 0;
+        }
+    };
+
+    /// <summary>
+    /// Everything the checks need to know about the package directory, gathered by visiting each entry once
+    /// </summary>
+    struct PackageContents
+    {
+        void visit(const PackageEntry& entry)
+        {
+            const std::string& relative = entry.relative_path;
+            non_empty_directories.insert(entry.path.parent_path());
+
+            if (entry.is_below("include")) has_include_files = true;
+            if (relative == "debug/share") has_debug_share = true;
+            if (relative == "lib/cmake") has_lib_cmake = true;
+            if (relative == "debug/lib/cmake") has_debug_lib_cmake = true;
+            if (relative == "bin") has_release_bin = true;
+            if (relative == "debug/bin") has_debug_bin = true;
+
+            if (entry.is_directory)
+            {
+                directories.push_back(entry.path);
+                if (entry.is_non_empty_symlinked_directory) non_empty_directories.insert(entry.path);
+                return;
+            }
+
+            const fs::path extension = entry.path.extension();
+            if (entry.is_below("debug/include") && extension != ".ifc") debug_include_files.push_back(entry.path);
+
+            if (extension == ".cmake" && (entry.is_below("cmake") || entry.is_below("debug/cmake") ||
+                                          entry.is_below("lib/cmake") || entry.is_below("debug/lib/cmake")))
+            {
+                misplaced_cmake_files.push_back(entry.path);
+            }
+
+            if (entry.is_below("lib"))
+            {
+                if (extension == ".dll") release_lib_dlls.push_back(entry.path);
+                if (extension == ".lib") release_libs.push_back(entry.path);
+                if (entry.is_regular_file) release_lib_files.push_back(entry.path);
+            }
+            else if (entry.is_below("debug/lib"))
+            {
+                if (extension == ".dll") debug_lib_dlls.push_back(entry.path);
+                if (extension == ".lib") debug_libs.push_back(entry.path);
+                if (entry.is_regular_file) debug_lib_files.push_back(entry.path);
+            }
+            else if (entry.is_below("bin"))
+            {
+                if (extension == ".exe") release_exes.push_back(entry.path);
+                if (extension == ".dll") release_dlls.push_back(entry.path);
+            }
+            else if (entry.is_below("debug/bin"))
+            {
+                if (extension == ".exe") debug_exes.push_back(entry.path);
+                if (extension == ".dll") debug_dlls.push_back(entry.path);
+            }
+
+            const auto first_slash = relative.find('/');
+            if (first_slash == std::string::npos)
+            {
+                files_in_root.push_back(entry.path);
+            }
+            else if (entry.is_below("debug") && relative.find('/', first_slash + 1) == std::string::npos)
+            {
+                files_in_debug_root.push_back(entry.path);
+            }
+        }
+
+        std::vector<fs::path> empty_directories() const
+        {
+            std::vector<fs::path> ret;
+            for (const fs::path& dir : directories)
+            {
+                if (non_empty_directories.find(dir) == non_empty_directories.cend()) ret.push_back(dir);
+            }
+
+            return ret;
+        }
+
+        bool has_include_files = false;
+        bool has_debug_share = false;
+        bool has_lib_cmake = false;
+        bool has_debug_lib_cmake = false;
+        bool has_release_bin = false;
+        bool has_debug_bin = false;
+
+        std::vector<fs::path> debug_include_files;
+        std::vector<fs::path> misplaced_cmake_files;
+        std::vector<fs::path> release_lib_dlls;
+        std::vector<fs::path> debug_lib_dlls;
+        std::vector<fs::path> release_libs;
+        std::vector<fs::path> debug_libs;
+        std::vector<fs::path> release_lib_files;
+        std::vector<fs::path> debug_lib_files;
+        std::vector<fs::path> release_exes;
+        std::vector<fs::path> debug_exes;
+        std::vector<fs::path> release_dlls;
+        std::vector<fs::path> debug_dlls;
+        std::vector<fs::path> files_in_root;
+        std::vector<fs::path> files_in_debug_root;
+        std::vector<fs::path> directories;
+        std::set<fs::path> non_empty_directories;
+    };
+
+    /// <summary>
+    /// Walks the package directory recursively, once, and hands every entry to the visitor
+    /// </summary>
+    template<class Visitor>
+    static void walk_package_directory(const Files::Filesystem& fs, const fs::path& package_dir, Visitor&& visitor)
+    {
+        const size_t prefix_size = package_dir.generic_string().size() + 1;
+        for (fs::path& path : fs.get_files_recursive(package_dir))
+        {
+            std::error_code ec;
+            const fs::file_status status = fs.symlink_status(path, ec);
+            const bool is_symlink = !ec && fs::is_symlink(status);
+
+            PackageEntry entry;
+            entry.relative_path = path.generic_string().substr(prefix_size);
+            entry.is_directory = is_symlink ? fs.is_directory(path) : fs::is_directory(status);
+            entry.is_regular_file = !ec && fs::is_regular_file(status);
+            entry.is_non_empty_symlinked_directory = is_symlink && entry.is_directory && !fs.is_empty(path);
+            entry.path = std::move(path);
+            visitor(entry);
+        }
+    }
+
     struct OutdatedDynamicCrt
     {
         std::string name;
@@ -76,17 +228,15 @@ namespace vcpkg::PostBuildLint
         return V_NO_MSVCRT;
     }
 
-    static LintStatus check_for_files_in_include_directory(const Files::Filesystem& fs,
-                                                           const Build::BuildPolicies& policies,
-                                                           const fs::path& package_dir)
+    static LintStatus check_for_files_in_include_directory(const Build::BuildPolicies& policies,
+                                                           const PackageContents& contents)
     {
         if (policies.is_enabled(BuildPolicy::EMPTY_INCLUDE_FOLDER))
         {
             return LintStatus::SUCCESS;
         }
 
-        const fs::path include_dir = package_dir / "include";
-        if (!fs.exists(include_dir) || fs.is_empty(include_dir))
+        if (!contents.has_include_files)
         {
             System::println(
                 System::Color::warning,
@@ -97,17 +247,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_for_files_in_debug_include_directory(const Files::Filesystem& fs,
-                                                                 const fs::path& package_dir)
+    static LintStatus check_for_files_in_debug_include_directory(const PackageContents& contents)
     {
-        const fs::path debug_include_dir = package_dir / "debug" / "include";
-
-        std::vector<fs::path> files_found = fs.get_files_recursive(debug_include_dir);
-
-        Util::unstable_keep_if(
-            files_found, [&fs](const fs::path& path) { return !fs.is_directory(path) && path.extension() != ".ifc"; });
-
-        if (!files_found.empty())
+        if (!contents.debug_include_files.empty())
         {
             System::println(System::Color::warning,
                             "Include files should not be duplicated into the /debug/include directory. If this cannot "
@@ -119,11 +261,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_for_files_in_debug_share_directory(const Files::Filesystem& fs, const fs::path& package_dir)
+    static LintStatus check_for_files_in_debug_share_directory(const PackageContents& contents)
     {
-        const fs::path debug_share = package_dir / "debug" / "share";
-
-        if (fs.exists(debug_share))
+        if (contents.has_debug_share)
         {
             System::println(System::Color::warning,
                             "/debug/share should not exist. Please reorganize any important files, then use\n"
@@ -134,12 +274,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_folder_lib_cmake(const Files::Filesystem& fs,
-                                             const fs::path& package_dir,
-                                             const PackageSpec& spec)
+    static LintStatus check_folder_lib_cmake(const PackageContents& contents, const PackageSpec& spec)
     {
-        const fs::path lib_cmake = package_dir / "lib" / "cmake";
-        if (fs.exists(lib_cmake))
+        if (contents.has_lib_cmake)
         {
             System::println(
                 System::Color::warning,
@@ -151,48 +288,25 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_for_misplaced_cmake_files(const Files::Filesystem& fs,
-                                                      const fs::path& package_dir,
-                                                      const PackageSpec& spec)
+    static LintStatus check_for_misplaced_cmake_files(const PackageContents& contents, const PackageSpec& spec)
     {
-        std::vector<fs::path> dirs = {
-            package_dir / "cmake",
-            package_dir / "debug" / "cmake",
-            package_dir / "lib" / "cmake",
-            package_dir / "debug" / "lib" / "cmake",
-        };
-
-        std::vector<fs::path> misplaced_cmake_files;
-        for (auto&& dir : dirs)
-        {
-            auto files = fs.get_files_recursive(dir);
-            for (auto&& file : files)
-            {
-                if (!fs.is_directory(file) && file.extension() == ".cmake")
-                    misplaced_cmake_files.push_back(std::move(file));
-            }
-        }
-
-        if (!misplaced_cmake_files.empty())
+        if (!contents.misplaced_cmake_files.empty())
         {
             System::println(
                 System::Color::warning,
                 "The following cmake files were found outside /share/%s. Please place cmake files in /share/%s.",
                 spec.name(),
                 spec.name());
-            Files::print_paths(misplaced_cmake_files);
+            Files::print_paths(contents.misplaced_cmake_files);
             return LintStatus::ERROR_DETECTED;
         }
 
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_folder_debug_lib_cmake(const Files::Filesystem& fs,
-                                                   const fs::path& package_dir,
-                                                   const PackageSpec& spec)
+    static LintStatus check_folder_debug_lib_cmake(const PackageContents& contents, const PackageSpec& spec)
     {
-        const fs::path lib_cmake_debug = package_dir / "debug" / "lib" / "cmake";
-        if (fs.exists(lib_cmake_debug))
+        if (contents.has_debug_lib_cmake)
         {
             System::println(System::Color::warning,
                             "The /debug/lib/cmake folder should be merged with /lib/cmake into /share/%s",
@@ -203,11 +317,8 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_for_dlls_in_lib_dir(const Files::Filesystem& fs, const fs::path& package_dir)
+    static LintStatus check_for_dlls_in_lib_dir(const std::vector<fs::path>& dlls)
     {
-        std::vector<fs::path> dlls = fs.get_files_recursive(package_dir / "lib");
-        Util::unstable_keep_if(dlls, has_extension_pred(fs, ".dll"));
-
         if (!dlls.empty())
         {
             System::println(System::Color::warning,
@@ -277,11 +388,8 @@ namespace vcpkg::PostBuildLint
         return LintStatus::ERROR_DETECTED;
     }
 
-    static LintStatus check_for_exes(const Files::Filesystem& fs, const fs::path& package_dir)
+    static LintStatus check_for_exes(const std::vector<fs::path>& exes)
     {
-        std::vector<fs::path> exes = fs.get_files_recursive(package_dir / "bin");
-        Util::unstable_keep_if(exes, has_extension_pred(fs, ".exe"));
-
         if (!exes.empty())
         {
             System::println(
@@ -294,19 +402,171 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_exports_of_dlls(const std::vector<fs::path>& dlls, const fs::path& dumpbin_exe)
+    /// <summary>
+    /// Splits the output of one dumpbin run over several files into the part for each file. Returns nullopt if the
+    /// output does not have exactly one "Dump of file" section per file.
+    /// </summary>
+    static Optional<std::vector<std::string>> split_dumpbin_output(const std::string& output, const size_t file_count)
     {
-        std::vector<fs::path> dlls_with_no_exports;
-        for (const fs::path& dll : dlls)
+        static const std::string SECTION_START = "Dump of file ";
+
+        std::vector<size_t> starts;
+        for (size_t pos = output.find(SECTION_START); pos != std::string::npos;
+             pos = output.find(SECTION_START, pos + SECTION_START.size()))
+        {
+            if (pos == 0 || output[pos - 1] == '\n') starts.push_back(pos);
+        }
+
+        if (starts.size() != file_count) return nullopt;
+
+        std::vector<std::string> sections;
+        for (size_t i = 0; i < starts.size(); ++i)
+        {
+            const size_t end = i + 1 < starts.size() ? starts[i + 1] : output.size();
+            sections.push_back(output.substr(starts[i], end - starts[i]));
+        }
+
+        return sections;
+    }
+
+    static std::string run_dumpbin_command(const std::string& cmd_line)
+    {
+        System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
+        Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
+        return std::move(ec_data.output);
+    }
+
+    /// <summary>
+    /// Returns the output of `dumpbin <option> <file>` for each file, in the order of files.
+    /// Outputs are cached in buildtrees/dumpbin_cache, keyed by the hash of the file, the option and the dumpbin used.
+    /// Files missing from the cache are passed to dumpbin in batches, and the batches run concurrently.
+    /// </summary>
+    static std::vector<std::string> run_dumpbin(const VcpkgPaths& paths,
+                                                const fs::path& dumpbin_exe,
+                                                const char* option,
+                                                const std::vector<fs::path>& files)
+    {
+        // cmd.exe rejects command lines longer than 8191 characters
+        static const size_t MAX_COMMAND_LINE_SIZE = 7000;
+
+        auto& fs = paths.get_filesystem();
+        const fs::path cache_dir = paths.buildtrees / "dumpbin_cache";
+        const std::string command_prefix = Strings::format(R"("%s" %s)", dumpbin_exe.u8string(), option);
+
+        const std::vector<Expected<std::string>> file_hashes = Hash::get_files_hash(files, Hash::Algorithm::SHA256);
+
+        std::vector<std::string> outputs(files.size());
+        std::vector<fs::path> cache_files(files.size());
+        std::vector<size_t> misses;
+        for (size_t i = 0; i < files.size(); ++i)
         {
-            const std::string cmd_line =
-                Strings::format(R"("%s" /exports "%s")", dumpbin_exe.u8string(), dll.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
+            const auto file_hash = file_hashes[i].get();
+            if (file_hash == nullptr)
+            {
+                misses.push_back(i);
+                continue;
+            }
+
+            cache_files[i] =
+                cache_dir / Hash::get_string_hash(command_prefix + "\n" + *file_hash, Hash::Algorithm::SHA256);
+            auto maybe_cached = fs.read_contents(cache_files[i]);
+            if (auto cached = maybe_cached.get())
+            {
+                outputs[i] = std::move(*cached);
+            }
+            else
+            {
+                misses.push_back(i);
+            }
+        }
+
+        Debug::println("dumpbin %s: %zd of %zd files cached", option, files.size() - misses.size(), files.size());
+
+        // Spread the files over one dumpbin per hardware thread, unless that would make the command line too long
+        const size_t hardware_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t max_batch_size = (misses.size() + hardware_threads - 1) / hardware_threads;
+
+        std::vector<std::vector<size_t>> batches;
+        size_t batch_command_size = 0;
+        for (const size_t i : misses)
+        {
+            const size_t argument_size = files[i].u8string().size() + 3;
+            if (batches.empty() || batches.back().size() >= max_batch_size ||
+                batch_command_size + argument_size > MAX_COMMAND_LINE_SIZE)
+            {
+                batches.emplace_back();
+                batch_command_size = command_prefix.size();
+            }
+
+            batches.back().push_back(i);
+            batch_command_size += argument_size;
+        }
+
+        Util::parallel_for(batches.size(), [&](const size_t batch_index) {
+            const std::vector<size_t>& batch = batches[batch_index];
+
+            std::string cmd_line = command_prefix;
+            for (const size_t i : batch)
+            {
+                cmd_line += Strings::format(R"( "%s")", files[i].u8string());
+            }
+
+            const Optional<std::vector<std::string>> maybe_sections =
+                split_dumpbin_output(run_dumpbin_command(cmd_line), batch.size());
+            if (const auto sections = maybe_sections.get())
+            {
+                for (size_t j = 0; j < batch.size(); ++j)
+                {
+                    outputs[batch[j]] = std::move((*sections)[j]);
+                }
+            }
+            else
+            {
+                // The output could not be attributed to the files, so run dumpbin on each file on its own
+                for (const size_t i : batch)
+                {
+                    outputs[i] = run_dumpbin_command(
+                        Strings::format(R"(%s "%s")", command_prefix, files[i].u8string()));
+                }
+            }
 
-            if (ec_data.output.find("ordinal hint RVA      name") == std::string::npos)
+            for (const size_t i : batch)
             {
-                dlls_with_no_exports.push_back(dll);
+                if (cache_files[i].empty()) continue;
+
+                std::error_code ec;
+                Files::write_contents_atomically(fs, cache_files[i], outputs[i], ec);
+            }
+        });
+
+        return outputs;
+    }
+
+    struct DllBinary
+    {
+        fs::path file;
+        CoffFileReader::DllInfo info;
+    };
+
+    static std::vector<DllBinary> inspect_dlls(const std::vector<fs::path>& dlls)
+    {
+        return Util::parallel_fmap(dlls, [](const fs::path& file) {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               file.extension() == ".dll",
+                               "The file extension was not .dll: %s",
+                               file.generic_string());
+            return DllBinary{file, CoffFileReader::read_dll(file)};
+        });
+    }
+
+    static LintStatus check_exports_of_dlls(const std::vector<DllBinary>& dlls)
+    {
+        std::vector<fs::path> dlls_with_no_exports;
+        for (const DllBinary& dll : dlls)
+        {
+            if (!dll.info.has_exports)
+            {
+                dlls_with_no_exports.push_back(dll.file);
             }
         }
 
@@ -322,8 +582,7 @@ namespace vcpkg::PostBuildLint
     }
 
     static LintStatus check_uwp_bit_of_dlls(const std::string& expected_system_name,
-                                            const std::vector<fs::path>& dlls,
-                                            const fs::path dumpbin_exe)
+                                            const std::vector<DllBinary>& dlls)
     {
         if (expected_system_name != "WindowsStore")
         {
@@ -331,16 +590,11 @@ namespace vcpkg::PostBuildLint
         }
 
         std::vector<fs::path> dlls_with_improper_uwp_bit;
-        for (const fs::path& dll : dlls)
+        for (const DllBinary& dll : dlls)
         {
-            const std::string cmd_line =
-                Strings::format(R"("%s" /headers "%s")", dumpbin_exe.u8string(), dll.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
-
-            if (ec_data.output.find("App Container") == std::string::npos)
+            if (!dll.info.is_app_container)
             {
-                dlls_with_improper_uwp_bit.push_back(dll);
+                dlls_with_improper_uwp_bit.push_back(dll.file);
             }
         }
 
@@ -389,22 +643,16 @@ namespace vcpkg::PostBuildLint
     }
 
     static LintStatus check_dll_architecture(const std::string& expected_architecture,
-                                             const std::vector<fs::path>& files)
+                                             const std::vector<DllBinary>& dlls)
     {
         std::vector<FileAndArch> binaries_with_invalid_architecture;
-
-        for (const fs::path& file : files)
+        for (const DllBinary& dll : dlls)
         {
-            Checks::check_exit(VCPKG_LINE_INFO,
-                               file.extension() == ".dll",
-                               "The file extension was not .dll: %s",
-                               file.generic_string());
-            const CoffFileReader::DllInfo info = CoffFileReader::read_dll(file);
-            const std::string actual_architecture = get_actual_architecture(info.machine_type);
+            const std::string actual_architecture = get_actual_architecture(dll.info.machine_type);
 
             if (expected_architecture != actual_architecture)
             {
-                binaries_with_invalid_architecture.push_back({file, actual_architecture});
+                binaries_with_invalid_architecture.push_back({dll.file, actual_architecture});
             }
         }
 
@@ -420,15 +668,20 @@ namespace vcpkg::PostBuildLint
     static LintStatus check_lib_architecture(const std::string& expected_architecture,
                                              const std::vector<fs::path>& files)
     {
-        std::vector<FileAndArch> binaries_with_invalid_architecture;
+        const std::vector<CoffFileReader::LibInfo> infos =
+            Util::parallel_fmap(files, [](const fs::path& file) {
+                Checks::check_exit(VCPKG_LINE_INFO,
+                                   file.extension() == ".lib",
+                                   "The file extension was not .lib: %s",
+                                   file.generic_string());
+                return CoffFileReader::read_lib(file);
+            });
 
-        for (const fs::path& file : files)
+        std::vector<FileAndArch> binaries_with_invalid_architecture;
+        for (size_t i = 0; i < files.size(); ++i)
         {
-            Checks::check_exit(VCPKG_LINE_INFO,
-                               file.extension() == ".lib",
-                               "The file extension was not .lib: %s",
-                               file.generic_string());
-            CoffFileReader::LibInfo info = CoffFileReader::read_lib(file);
+            const fs::path& file = files[i];
+            const CoffFileReader::LibInfo& info = infos[i];
 
             // This is zero for folly's debug library
             // TODO: Why?
@@ -522,25 +775,25 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_bin_folders_are_not_present_in_static_build(const Files::Filesystem& fs,
+    static LintStatus check_bin_folders_are_not_present_in_static_build(const PackageContents& contents,
                                                                         const fs::path& package_dir)
     {
         const fs::path bin = package_dir / "bin";
         const fs::path debug_bin = package_dir / "debug" / "bin";
 
-        if (!fs.exists(bin) && !fs.exists(debug_bin))
+        if (!contents.has_release_bin && !contents.has_debug_bin)
         {
             return LintStatus::SUCCESS;
         }
 
-        if (fs.exists(bin))
+        if (contents.has_release_bin)
         {
             System::println(System::Color::warning,
                             R"(There should be no bin\ directory in a static build, but %s is present.)",
                             bin.u8string());
         }
 
-        if (fs.exists(debug_bin))
+        if (contents.has_debug_bin)
         {
             System::println(System::Color::warning,
                             R"(There should be no debug\bin\ directory in a static build, but %s is present.)",
@@ -562,13 +815,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::ERROR_DETECTED;
     }
 
-    static LintStatus check_no_empty_folders(const Files::Filesystem& fs, const fs::path& dir)
+    static LintStatus check_no_empty_folders(const PackageContents& contents, const fs::path& dir)
     {
-        std::vector<fs::path> empty_directories = fs.get_files_recursive(dir);
-
-        Util::unstable_keep_if(empty_directories, [&fs](const fs::path& current) {
-            return fs.is_directory(current) && fs.is_empty(current);
-        });
+        const std::vector<fs::path> empty_directories = contents.empty_directories();
 
         if (!empty_directories.empty())
         {
@@ -596,7 +845,8 @@ namespace vcpkg::PostBuildLint
         BuildType build_type;
     };
 
-    static LintStatus check_crt_linkage_of_libs(const BuildType& expected_build_type,
+    static LintStatus check_crt_linkage_of_libs(const VcpkgPaths& paths,
+                                                const BuildType& expected_build_type,
                                                 const std::vector<fs::path>& libs,
                                                 const fs::path dumpbin_exe)
     {
@@ -604,20 +854,17 @@ namespace vcpkg::PostBuildLint
         bad_build_types.erase(std::remove(bad_build_types.begin(), bad_build_types.end(), expected_build_type),
                               bad_build_types.end());
 
-        std::vector<BuildTypeAndFile> libs_with_invalid_crt;
+        const std::vector<std::string> outputs = run_dumpbin(paths, dumpbin_exe, "/directives", libs);
 
-        for (const fs::path& lib : libs)
+        std::vector<BuildTypeAndFile> libs_with_invalid_crt;
+        for (size_t i = 0; i < libs.size(); ++i)
         {
-            const std::string cmd_line =
-                Strings::format(R"("%s" /directives "%s")", dumpbin_exe.u8string(), lib.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
-
+            const std::string& output = outputs[i];
             for (const BuildType& bad_build_type : bad_build_types)
             {
-                if (std::regex_search(ec_data.output.cbegin(), ec_data.output.cend(), bad_build_type.crt_regex()))
+                if (std::regex_search(output.cbegin(), output.cend(), bad_build_type.crt_regex()))
                 {
-                    libs_with_invalid_crt.push_back({lib, bad_build_type});
+                    libs_with_invalid_crt.push_back({libs[i], bad_build_type});
                     break;
                 }
             }
@@ -651,26 +898,22 @@ namespace vcpkg::PostBuildLint
         OutdatedDynamicCrtAndFile() = delete;
     };
 
-    static LintStatus check_outdated_crt_linkage_of_dlls(const std::vector<fs::path>& dlls,
-                                                         const fs::path dumpbin_exe,
+    static LintStatus check_outdated_crt_linkage_of_dlls(const std::vector<DllBinary>& dlls,
                                                          const BuildInfo& build_info,
                                                          const PreBuildInfo& pre_build_info)
     {
         if (build_info.policies.is_enabled(BuildPolicy::ALLOW_OBSOLETE_MSVCRT)) return LintStatus::SUCCESS;
 
         std::vector<OutdatedDynamicCrtAndFile> dlls_with_outdated_crt;
-
-        for (const fs::path& dll : dlls)
+        for (const DllBinary& dll : dlls)
         {
-            const auto cmd_line = Strings::format(R"("%s" /dependents "%s")", dumpbin_exe.u8string(), dll.u8string());
-            System::ExitCodeAndOutput ec_data = System::cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line);
-
+            // One name per line, as `dumpbin /dependents` prints them
+            const std::string dependencies = Strings::join("\n", dll.info.dependencies);
             for (const OutdatedDynamicCrt& outdated_crt : get_outdated_dynamic_crts(pre_build_info.platform_toolset))
             {
-                if (std::regex_search(ec_data.output.cbegin(), ec_data.output.cend(), outdated_crt.regex))
+                if (std::regex_search(dependencies.cbegin(), dependencies.cend(), outdated_crt.regex))
                 {
-                    dlls_with_outdated_crt.push_back({dll, outdated_crt});
+                    dlls_with_outdated_crt.push_back({dll.file, outdated_crt});
                     break;
                 }
             }
@@ -694,15 +937,12 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_no_files_in_dir(const Files::Filesystem& fs, const fs::path& dir)
+    static LintStatus check_no_files_in_dir(const fs::path& dir, std::vector<fs::path> misplaced_files)
     {
-        std::vector<fs::path> misplaced_files = fs.get_files_non_recursive(dir);
-        Util::unstable_keep_if(misplaced_files, [&fs](const fs::path& path) {
+        Util::unstable_keep_if(misplaced_files, [](const fs::path& path) {
             const std::string filename = path.filename().generic_string();
-            if (Strings::case_insensitive_ascii_equals(filename.c_str(), "CONTROL") ||
-                Strings::case_insensitive_ascii_equals(filename.c_str(), "BUILD_INFO"))
-                return false;
-            return !fs.is_directory(path);
+            return !Strings::case_insensitive_ascii_equals(filename.c_str(), "CONTROL") &&
+                   !Strings::case_insensitive_ascii_equals(filename.c_str(), "BUILD_INFO");
         });
 
         if (!misplaced_files.empty())
@@ -718,6 +958,224 @@ namespace vcpkg::PostBuildLint
 
     static void operator+=(size_t& left, const LintStatus& right) { left += static_cast<size_t>(right); }
 
+    /// <summary>
+    /// Runs checks, adding up their errors and recording how long each one took
+    /// </summary>
+    struct LintRunner
+    {
+        template<class Check>
+        void run(const char* name, Check&& check)
+        {
+            const auto timer = Chrono::ElapsedTimer::create_started();
+            error_count += check();
+            timings.emplace_back(name, timer.elapsed());
+        }
+
+        void print_timings() const
+        {
+            Debug::println("Post-build validation timings:");
+            for (auto&& timing : timings)
+            {
+                Debug::println("    %s: %s", timing.first, timing.second.to_string());
+            }
+        }
+
+        size_t error_count = 0;
+        std::vector<std::pair<const char*, Chrono::ElapsedTime>> timings;
+    };
+
+    struct ElfBinary
+    {
+        fs::path file;
+        /// <summary>
+        /// The shared object itself, or every object in a static archive. Empty if the file is not ELF.
+        /// </summary>
+        std::vector<ElfFileReader::ElfInfo> objects;
+    };
+
+    static bool is_shared_object_name(const fs::path& file)
+    {
+        // Matches both libfoo.so and versioned names such as libfoo.so.1.2
+        const std::string filename = file.filename().u8string();
+        const auto pos = filename.find(".so");
+        return pos != std::string::npos && (pos + 3 == filename.size() || filename[pos + 3] == '.');
+    }
+
+    /// <summary>
+    /// Reads the regular files found below lib/ concurrently. Versioned shared objects are usually reached through a
+    /// chain of symlinks, so only the real file is inspected.
+    /// </summary>
+    static std::vector<ElfBinary> inspect_elf_binaries(std::vector<fs::path> files)
+    {
+        Util::unstable_keep_if(
+            files, [](const fs::path& file) { return file.extension() == ".a" || is_shared_object_name(file); });
+        std::sort(files.begin(), files.end());
+
+        return Util::parallel_fmap(files, [](const fs::path& file) {
+            ElfBinary binary{file, {}};
+            if (file.extension() == ".a")
+            {
+                auto maybe_archive = ElfFileReader::read_archive(file);
+                if (const auto archive = maybe_archive.get()) binary.objects = std::move(archive->objects);
+            }
+            else
+            {
+                auto maybe_elf = ElfFileReader::read_elf(file);
+                if (const auto elf = maybe_elf.get()) binary.objects.push_back(std::move(*elf));
+            }
+
+            return binary;
+        });
+    }
+
+    static std::string get_actual_architecture(const ElfFileReader::ElfInfo& info)
+    {
+        using ElfFileReader::ElfClass;
+        using ElfFileReader::ElfMachine;
+
+        switch (info.machine)
+        {
+            case ElfMachine::X86_64: return info.elf_class == ElfClass::ELF64 ? "x64" : "x32";
+            case ElfMachine::I386: return "x86";
+            case ElfMachine::ARM: return "arm";
+            case ElfMachine::AARCH64: return info.elf_class == ElfClass::ELF64 ? "arm64" : "arm64_32";
+            default: return "ELF Machine = " + std::to_string(static_cast<uint16_t>(info.machine));
+        }
+    }
+
+    static LintStatus check_elf_architecture(const std::string& expected_architecture,
+                                             const std::vector<ElfBinary>& binaries)
+    {
+        std::vector<FileAndArch> binaries_with_invalid_architecture;
+
+        for (const ElfBinary& binary : binaries)
+        {
+            for (const ElfFileReader::ElfInfo& info : binary.objects)
+            {
+                const std::string actual_architecture = get_actual_architecture(info);
+                if (expected_architecture != actual_architecture)
+                {
+                    binaries_with_invalid_architecture.push_back({binary.file, actual_architecture});
+                    break;
+                }
+            }
+        }
+
+        if (!binaries_with_invalid_architecture.empty())
+        {
+            print_invalid_architecture_files(expected_architecture, binaries_with_invalid_architecture);
+            return LintStatus::ERROR_DETECTED;
+        }
+
+        return LintStatus::SUCCESS;
+    }
+
+    static LintStatus check_no_shared_objects_present(const std::vector<fs::path>& shared_objects)
+    {
+        if (shared_objects.empty())
+        {
+            return LintStatus::SUCCESS;
+        }
+
+        System::println(System::Color::warning,
+                        "Shared objects should not be present in a static build, but the following were found:");
+        Files::print_paths(shared_objects);
+        return LintStatus::ERROR_DETECTED;
+    }
+
+    static std::vector<fs::path> files_of_elf_type(const std::vector<ElfBinary>& binaries,
+                                                   const ElfFileReader::ElfType type)
+    {
+        std::vector<fs::path> ret;
+        for (const ElfBinary& binary : binaries)
+        {
+            if (Util::find_if(binary.objects, [type](const ElfFileReader::ElfInfo& info) {
+                    return info.type == type;
+                }) != binary.objects.cend())
+            {
+                ret.push_back(binary.file);
+            }
+        }
+
+        return ret;
+    }
+
+    static void perform_elf_checks(LintRunner& runner,
+                                   const PackageContents& contents,
+                                   const PreBuildInfo& pre_build_info,
+                                   const BuildInfo& build_info)
+    {
+        using ElfFileReader::ElfType;
+
+        const auto timer = Chrono::ElapsedTimer::create_started();
+        const std::vector<ElfBinary> debug_binaries = inspect_elf_binaries(contents.debug_lib_files);
+        const std::vector<ElfBinary> release_binaries = inspect_elf_binaries(contents.release_lib_files);
+        runner.timings.emplace_back("inspect ELF binaries", timer.elapsed());
+
+        for (const auto* binaries : {&debug_binaries, &release_binaries})
+        {
+            for (const ElfBinary& binary : *binaries)
+            {
+                if (binary.objects.empty()) continue;
+
+                const ElfFileReader::ElfInfo& first = binary.objects.front();
+                const bool has_debug_info = Util::find_if(binary.objects, [](const ElfFileReader::ElfInfo& info) {
+                                                return info.has_debug_info;
+                                            }) != binary.objects.cend();
+                Debug::println("%s: %zd ELF object(s), %s, SONAME '%s', %s",
+                               binary.file.generic_string(),
+                               binary.objects.size(),
+                               get_actual_architecture(first),
+                               first.soname,
+                               has_debug_info ? "with debug info" : "stripped");
+            }
+        }
+
+        runner.run("check_elf_architecture", [&] {
+            std::vector<ElfBinary> binaries = debug_binaries;
+            binaries.insert(binaries.end(), release_binaries.cbegin(), release_binaries.cend());
+            return check_elf_architecture(pre_build_info.target_architecture, binaries);
+        });
+
+        const std::vector<fs::path> debug_archives = files_of_elf_type(debug_binaries, ElfType::RELOCATABLE);
+        const std::vector<fs::path> release_archives = files_of_elf_type(release_binaries, ElfType::RELOCATABLE);
+        const std::vector<fs::path> debug_shared_objects = files_of_elf_type(debug_binaries, ElfType::SHARED_OBJECT);
+        const std::vector<fs::path> release_shared_objects =
+            files_of_elf_type(release_binaries, ElfType::SHARED_OBJECT);
+
+        if (!pre_build_info.build_type)
+        {
+            runner.run("check_matching_debug_and_release_binaries", [&] {
+                return check_matching_debug_and_release_binaries(debug_archives, release_archives);
+            });
+        }
+
+        switch (build_info.library_linkage)
+        {
+            case Build::LinkageType::DYNAMIC:
+            {
+                if (!pre_build_info.build_type)
+                {
+                    runner.run("check_matching_debug_and_release_binaries", [&] {
+                        return check_matching_debug_and_release_binaries(debug_shared_objects, release_shared_objects);
+                    });
+                }
+                break;
+            }
+            case Build::LinkageType::STATIC:
+            {
+                runner.run("check_no_shared_objects_present", [&] {
+                    auto shared_objects = release_shared_objects;
+                    shared_objects.insert(
+                        shared_objects.end(), debug_shared_objects.begin(), debug_shared_objects.end());
+                    return check_no_shared_objects_present(shared_objects);
+                });
+                break;
+            }
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
     static size_t perform_all_checks_and_return_error_count(const PackageSpec& spec,
                                                             const VcpkgPaths& paths,
                                                             const PreBuildInfo& pre_build_info,
@@ -729,103 +1187,140 @@ namespace vcpkg::PostBuildLint
         const Toolset& toolset = paths.get_toolset(pre_build_info);
         const fs::path package_dir = paths.package_dir(spec);
 
-        size_t error_count = 0;
-
         if (build_info.policies.is_enabled(BuildPolicy::EMPTY_PACKAGE))
         {
-            return error_count;
+            return 0;
         }
 
-        error_count += check_for_files_in_include_directory(fs, build_info.policies, package_dir);
-        error_count += check_for_files_in_debug_include_directory(fs, package_dir);
-        error_count += check_for_files_in_debug_share_directory(fs, package_dir);
-        error_count += check_folder_lib_cmake(fs, package_dir, spec);
-        error_count += check_for_misplaced_cmake_files(fs, package_dir, spec);
-        error_count += check_folder_debug_lib_cmake(fs, package_dir, spec);
-        error_count += check_for_dlls_in_lib_dir(fs, package_dir);
-        error_count += check_for_dlls_in_lib_dir(fs, package_dir / "debug");
-        error_count += check_for_copyright_file(fs, spec, paths);
-        error_count += check_for_exes(fs, package_dir);
-        error_count += check_for_exes(fs, package_dir / "debug");
+        LintRunner runner;
+
+        PackageContents contents;
+        {
+            const auto timer = Chrono::ElapsedTimer::create_started();
+            walk_package_directory(fs, package_dir, [&contents](const PackageEntry& entry) { contents.visit(entry); });
+            runner.timings.emplace_back("walk package directory", timer.elapsed());
+        }
+
+        runner.run("check_for_files_in_include_directory",
+                   [&] { return check_for_files_in_include_directory(build_info.policies, contents); });
+        runner.run("check_for_files_in_debug_include_directory",
+                   [&] { return check_for_files_in_debug_include_directory(contents); });
+        runner.run("check_for_files_in_debug_share_directory",
+                   [&] { return check_for_files_in_debug_share_directory(contents); });
+        runner.run("check_folder_lib_cmake", [&] { return check_folder_lib_cmake(contents, spec); });
+        runner.run("check_for_misplaced_cmake_files", [&] { return check_for_misplaced_cmake_files(contents, spec); });
+        runner.run("check_folder_debug_lib_cmake", [&] { return check_folder_debug_lib_cmake(contents, spec); });
+        runner.run("check_for_dlls_in_lib_dir", [&] { return check_for_dlls_in_lib_dir(contents.release_lib_dlls); });
+        runner.run("check_for_dlls_in_lib_dir", [&] { return check_for_dlls_in_lib_dir(contents.debug_lib_dlls); });
+        runner.run("check_for_copyright_file", [&] { return check_for_copyright_file(fs, spec, paths); });
+        runner.run("check_for_exes", [&] { return check_for_exes(contents.release_exes); });
+        runner.run("check_for_exes", [&] { return check_for_exes(contents.debug_exes); });
 
         const fs::path debug_lib_dir = package_dir / "debug" / "lib";
         const fs::path release_lib_dir = package_dir / "lib";
-        const fs::path debug_bin_dir = package_dir / "debug" / "bin";
-        const fs::path release_bin_dir = package_dir / "bin";
 
-        std::vector<fs::path> debug_libs = fs.get_files_recursive(debug_lib_dir);
-        Util::unstable_keep_if(debug_libs, has_extension_pred(fs, ".lib"));
-        std::vector<fs::path> release_libs = fs.get_files_recursive(release_lib_dir);
-        Util::unstable_keep_if(release_libs, has_extension_pred(fs, ".lib"));
+        const std::vector<fs::path>& debug_libs = contents.debug_libs;
+        const std::vector<fs::path>& release_libs = contents.release_libs;
 
         if (!pre_build_info.build_type)
-            error_count += check_matching_debug_and_release_binaries(debug_libs, release_libs);
-
         {
+            runner.run("check_matching_debug_and_release_binaries",
+                       [&] { return check_matching_debug_and_release_binaries(debug_libs, release_libs); });
+        }
+
+        runner.run("check_lib_architecture", [&] {
             std::vector<fs::path> libs;
             libs.insert(libs.cend(), debug_libs.cbegin(), debug_libs.cend());
             libs.insert(libs.cend(), release_libs.cbegin(), release_libs.cend());
 
-            error_count += check_lib_architecture(pre_build_info.target_architecture, libs);
-        }
+            return check_lib_architecture(pre_build_info.target_architecture, libs);
+        });
 
-        std::vector<fs::path> debug_dlls = fs.get_files_recursive(debug_bin_dir);
-        Util::unstable_keep_if(debug_dlls, has_extension_pred(fs, ".dll"));
-        std::vector<fs::path> release_dlls = fs.get_files_recursive(release_bin_dir);
-        Util::unstable_keep_if(release_dlls, has_extension_pred(fs, ".dll"));
+        const std::vector<fs::path>& debug_dlls = contents.debug_dlls;
+        const std::vector<fs::path>& release_dlls = contents.release_dlls;
 
         switch (build_info.library_linkage)
         {
             case Build::LinkageType::DYNAMIC:
             {
                 if (!pre_build_info.build_type)
-                    error_count += check_matching_debug_and_release_binaries(debug_dlls, release_dlls);
-
-                error_count += check_lib_files_are_available_if_dlls_are_available(
-                    build_info.policies, debug_libs.size(), debug_dlls.size(), debug_lib_dir);
-                error_count += check_lib_files_are_available_if_dlls_are_available(
-                    build_info.policies, release_libs.size(), release_dlls.size(), release_lib_dir);
-
-                std::vector<fs::path> dlls;
-                dlls.insert(dlls.cend(), debug_dlls.cbegin(), debug_dlls.cend());
-                dlls.insert(dlls.cend(), release_dlls.cbegin(), release_dlls.cend());
-
-                error_count += check_exports_of_dlls(dlls, toolset.dumpbin);
-                error_count += check_uwp_bit_of_dlls(pre_build_info.cmake_system_name, dlls, toolset.dumpbin);
-                error_count += check_dll_architecture(pre_build_info.target_architecture, dlls);
+                {
+                    runner.run("check_matching_debug_and_release_binaries",
+                               [&] { return check_matching_debug_and_release_binaries(debug_dlls, release_dlls); });
+                }
 
-                error_count += check_outdated_crt_linkage_of_dlls(dlls, toolset.dumpbin, build_info, pre_build_info);
+                runner.run("check_lib_files_are_available_if_dlls_are_available", [&] {
+                    return check_lib_files_are_available_if_dlls_are_available(
+                        build_info.policies, debug_libs.size(), debug_dlls.size(), debug_lib_dir);
+                });
+                runner.run("check_lib_files_are_available_if_dlls_are_available", [&] {
+                    return check_lib_files_are_available_if_dlls_are_available(
+                        build_info.policies, release_libs.size(), release_dlls.size(), release_lib_dir);
+                });
+
+                std::vector<fs::path> dll_files;
+                dll_files.insert(dll_files.cend(), debug_dlls.cbegin(), debug_dlls.cend());
+                dll_files.insert(dll_files.cend(), release_dlls.cbegin(), release_dlls.cend());
+
+                const auto timer = Chrono::ElapsedTimer::create_started();
+                const std::vector<DllBinary> dlls = inspect_dlls(dll_files);
+                runner.timings.emplace_back("inspect DLLs", timer.elapsed());
+
+                runner.run("check_exports_of_dlls", [&] { return check_exports_of_dlls(dlls); });
+                runner.run("check_uwp_bit_of_dlls",
+                           [&] { return check_uwp_bit_of_dlls(pre_build_info.cmake_system_name, dlls); });
+                runner.run("check_dll_architecture",
+                           [&] { return check_dll_architecture(pre_build_info.target_architecture, dlls); });
+                runner.run("check_outdated_crt_linkage_of_dlls",
+                           [&] { return check_outdated_crt_linkage_of_dlls(dlls, build_info, pre_build_info); });
                 break;
             }
             case Build::LinkageType::STATIC:
             {
-                auto dlls = release_dlls;
-                dlls.insert(dlls.end(), debug_dlls.begin(), debug_dlls.end());
-                error_count += check_no_dlls_present(dlls);
+                runner.run("check_no_dlls_present", [&] {
+                    auto dlls = release_dlls;
+                    dlls.insert(dlls.end(), debug_dlls.begin(), debug_dlls.end());
+                    return check_no_dlls_present(dlls);
+                });
 
-                error_count += check_bin_folders_are_not_present_in_static_build(fs, package_dir);
+                runner.run("check_bin_folders_are_not_present_in_static_build",
+                           [&] { return check_bin_folders_are_not_present_in_static_build(contents, package_dir); });
 
                 if (!build_info.policies.is_enabled(BuildPolicy::ONLY_RELEASE_CRT))
                 {
-                    error_count += check_crt_linkage_of_libs(
-                        BuildType::value_of(Build::ConfigurationType::DEBUG, build_info.crt_linkage),
-                        debug_libs,
-                        toolset.dumpbin);
+                    runner.run("check_crt_linkage_of_libs", [&] {
+                        return check_crt_linkage_of_libs(
+                            paths,
+                            BuildType::value_of(Build::ConfigurationType::DEBUG, build_info.crt_linkage),
+                            debug_libs,
+                            toolset.dumpbin);
+                    });
                 }
-                error_count += check_crt_linkage_of_libs(
-                    BuildType::value_of(Build::ConfigurationType::RELEASE, build_info.crt_linkage),
-                    release_libs,
-                    toolset.dumpbin);
+                runner.run("check_crt_linkage_of_libs", [&] {
+                    return check_crt_linkage_of_libs(
+                        paths,
+                        BuildType::value_of(Build::ConfigurationType::RELEASE, build_info.crt_linkage),
+                        release_libs,
+                        toolset.dumpbin);
+                });
                 break;
             }
             default: Checks::unreachable(VCPKG_LINE_INFO);
         }
 
-        error_count += check_no_empty_folders(fs, package_dir);
-        error_count += check_no_files_in_dir(fs, package_dir);
-        error_count += check_no_files_in_dir(fs, package_dir / "debug");
+        if (pre_build_info.cmake_system_name == "Linux")
+        {
+            perform_elf_checks(runner, contents, pre_build_info, build_info);
+        }
 
-        return error_count;
+        runner.run("check_no_empty_folders", [&] { return check_no_empty_folders(contents, package_dir); });
+        runner.run("check_no_files_in_dir",
+                   [&] { return check_no_files_in_dir(package_dir, contents.files_in_root); });
+        runner.run("check_no_files_in_dir",
+                   [&] { return check_no_files_in_dir(package_dir / "debug", contents.files_in_debug_root); });
+
+        runner.print_timings();
+        return runner.error_count;
     }
 
     size_t perform_all_checks(const PackageSpec& spec,
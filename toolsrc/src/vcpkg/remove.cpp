@@ -6,6 +6,8 @@
 #include <vcpkg/dependencies.h>
 #include <vcpkg/help.h>
 #include <vcpkg/input.h>
+#include <vcpkg/ownershipindex.h>
+#include <vcpkg/ownsindex.h>
 #include <vcpkg/paragraphs.h>
 #include <vcpkg/remove.h>
 #include <vcpkg/update.h>
@@ -18,7 +20,10 @@ namespace vcpkg::Remove
     using Dependencies::RequestType;
     using Update::OutdatedPackage;
 
-    void remove_package(const VcpkgPaths& paths, const PackageSpec& spec, StatusParagraphs* status_db)
+    void remove_package(const VcpkgPaths& paths,
+                        const PackageSpec& spec,
+                        StatusParagraphs* status_db,
+                        OwnershipIndexes* ownership_indexes)
     {
         auto& fs = paths.get_filesystem();
         auto maybe_ipv = status_db->find_all_installed(spec);
@@ -28,6 +33,9 @@ namespace vcpkg::Remove
 
         auto&& ipv = maybe_ipv.value_or_exit(VCPKG_LINE_INFO);
 
+        // Load the index while it still matches the status database
+        OwnershipIndex& ownership_index = ownership_indexes->get(paths, *status_db, spec.triplet());
+
         std::vector<StatusParagraph> spghs;
         spghs.emplace_back(*ipv.core);
         for (auto&& feature : ipv.features)
@@ -39,8 +47,8 @@ namespace vcpkg::Remove
         {
             spgh.want = Want::PURGE;
             spgh.state = InstallState::HALF_INSTALLED;
-            write_update(paths, spgh);
         }
+        write_updates(paths, spghs);
 
         auto maybe_lines = fs.read_lines(paths.listfile_path(ipv.core->package));
 
@@ -102,11 +110,16 @@ namespace vcpkg::Remove
             fs.remove(paths.listfile_path(ipv.core->package));
         }
 
+        ownership_index.remove_package(ipv.core->package);
+
         for (auto&& spgh : spghs)
         {
             spgh.state = InstallState::NOT_INSTALLED;
-            write_update(paths, spgh);
+        }
+        write_updates(paths, spghs);
 
+        for (auto&& spgh : spghs)
+        {
             status_db->insert(std::make_unique<StatusParagraph>(std::move(spgh)));
         }
     }
@@ -145,7 +158,8 @@ namespace vcpkg::Remove
     void perform_remove_plan_action(const VcpkgPaths& paths,
                                     const RemovePlanAction& action,
                                     const Purge purge,
-                                    StatusParagraphs* status_db)
+                                    StatusParagraphs* status_db,
+                                    OwnershipIndexes* ownership_indexes)
     {
         const std::string display_name = action.spec.to_string();
 
@@ -156,7 +170,7 @@ namespace vcpkg::Remove
                 break;
             case RemovePlanType::REMOVE:
                 System::println("Removing package %s... ", display_name);
-                remove_package(paths, action.spec, status_db);
+                remove_package(paths, action.spec, status_db, ownership_indexes);
                 System::println(System::Color::success, "Removing package %s... done", display_name);
                 break;
             case RemovePlanType::UNKNOWN:
@@ -285,10 +299,14 @@ namespace vcpkg::Remove
             Checks::exit_success(VCPKG_LINE_INFO);
         }
 
+        OwnershipIndexes ownership_indexes;
         for (const RemovePlanAction& action : remove_plan)
         {
-            perform_remove_plan_action(paths, action, purge, &status_db);
+            perform_remove_plan_action(paths, action, purge, &status_db, &ownership_indexes);
         }
+        ownership_indexes.write(paths.get_filesystem());
+
+        OwnsIndex(paths.vcpkg_dir_owns_index).update(paths, status_db);
 
         Checks::exit_success(VCPKG_LINE_INFO);
     }
@@ -86,10 +86,8 @@ namespace vcpkg
         }
     }
 
-    static ParseExpected<SourceParagraph> parse_source_paragraph(RawParagraph&& fields)
+    static ParseExpected<SourceParagraph> parse_source_paragraph(ParagraphParser&& parser)
     {
-        ParagraphParser parser(std::move(fields));
-
         auto spgh = std::make_unique<SourceParagraph>();
 
         parser.required_field(SourceParagraphFields::SOURCE, spgh->name);
@@ -109,10 +107,8 @@ namespace vcpkg
             return std::move(spgh);
     }
 
-    static ParseExpected<FeatureParagraph> parse_feature_paragraph(RawParagraph&& fields)
+    static ParseExpected<FeatureParagraph> parse_feature_paragraph(ParagraphParser&& parser)
     {
-        ParagraphParser parser(std::move(fields));
-
         auto fpgh = std::make_unique<FeatureParagraph>();
 
         parser.required_field(SourceParagraphFields::FEATURE, fpgh->name);
@@ -128,8 +124,9 @@ namespace vcpkg
             return std::move(fpgh);
     }
 
-    ParseExpected<SourceControlFile> SourceControlFile::parse_control_file(
-        std::vector<std::unordered_map<std::string, std::string>>&& control_paragraphs)
+    // Paragraphs is a range of either RawParagraph or ParagraphView
+    template<class Paragraphs>
+    static ParseExpected<SourceControlFile> parse_control_paragraphs(Paragraphs&& control_paragraphs)
     {
         if (control_paragraphs.size() == 0)
         {
@@ -138,17 +135,16 @@ namespace vcpkg
 
         auto control_file = std::make_unique<SourceControlFile>();
 
-        auto maybe_source = parse_source_paragraph(std::move(control_paragraphs.front()));
+        auto it = control_paragraphs.begin();
+        auto maybe_source = parse_source_paragraph(ParagraphParser(std::move(*it)));
         if (const auto source = maybe_source.get())
             control_file->core_paragraph = std::move(*source);
         else
             return std::move(maybe_source).error();
 
-        control_paragraphs.erase(control_paragraphs.begin());
-
-        for (auto&& feature_pgh : control_paragraphs)
+        for (++it; it != control_paragraphs.end(); ++it)
         {
-            auto maybe_feature = parse_feature_paragraph(std::move(feature_pgh));
+            auto maybe_feature = parse_feature_paragraph(ParagraphParser(std::move(*it)));
             if (const auto feature = maybe_feature.get())
                 control_file->feature_paragraphs.emplace_back(std::move(*feature));
             else
@@ -158,6 +154,17 @@ namespace vcpkg
         return std::move(control_file);
     }
 
+    ParseExpected<SourceControlFile> SourceControlFile::parse_control_file(
+        std::vector<std::unordered_map<std::string, std::string>>&& control_paragraphs)
+    {
+        return parse_control_paragraphs(control_paragraphs);
+    }
+
+    ParseExpected<SourceControlFile> SourceControlFile::parse_control_file(Span<const ParagraphView> control_paragraphs)
+    {
+        return parse_control_paragraphs(control_paragraphs);
+    }
+
     Dependency Dependency::parse_dependency(std::string name, std::string qualifier)
     {
         Dependency dep;
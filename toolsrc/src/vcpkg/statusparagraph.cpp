@@ -25,13 +25,19 @@ namespace vcpkg
     }
 
     StatusParagraph::StatusParagraph(std::unordered_map<std::string, std::string>&& fields)
+        : StatusParagraph(ParagraphParser(std::move(fields)))
     {
-        auto status_it = fields.find(BinaryParagraphRequiredField::STATUS);
-        Checks::check_exit(VCPKG_LINE_INFO, status_it != fields.end(), "Expected 'Status' field in status paragraph");
-        std::string status_field = std::move(status_it->second);
-        fields.erase(status_it);
+    }
+
+    StatusParagraph::StatusParagraph(ParagraphView fields) : StatusParagraph(ParagraphParser(fields)) {}
+
+    StatusParagraph::StatusParagraph(ParagraphParser&& parser)
+    {
+        // A missing Status field is reported together with the other package fields
+        std::string status_field;
+        parser.required_field(BinaryParagraphRequiredField::STATUS, status_field);
 
-        this->package = BinaryParagraph(std::move(fields));
+        this->package = BinaryParagraph(std::move(parser));
 
         auto b = status_field.begin();
         const auto mark = b;
@@ -7,33 +7,79 @@ namespace vcpkg
 {
     StatusParagraphs::StatusParagraphs() = default;
 
-    StatusParagraphs::StatusParagraphs(std::vector<std::unique_ptr<StatusParagraph>>&& ps)
-        : paragraphs(std::move(ps)){};
+    StatusParagraphs::StatusParagraphs(std::vector<std::unique_ptr<StatusParagraph>>&& ps) : paragraphs(std::move(ps))
+    {
+        for (size_t i = 0; i < paragraphs.size(); ++i)
+            index_paragraph(i);
+    }
+
+    size_t StatusParagraphs::SpecKeyHash::operator()(const SpecKey& key) const
+    {
+        size_t hash = 17;
+        hash = hash * 31 + std::hash<std::string>()(key.name);
+        hash = hash * 31 + std::hash<Triplet>()(key.triplet);
+        return hash;
+    }
+
+    size_t StatusParagraphs::SpecKeyHash::operator()(const FeatureKey& key) const
+    {
+        return (*this)(key.spec) * 31 + std::hash<std::string>()(key.feature);
+    }
+
+    void StatusParagraphs::index_paragraph(size_t index)
+    {
+        const BinaryParagraph& package = paragraphs[index]->package;
+        SpecKey spec_key{package.spec.name(), package.spec.triplet()};
+
+        // Later paragraphs shadow earlier ones with the same key, matching a search from the back
+        feature_index[FeatureKey{spec_key, package.feature}] = index;
+        spec_index[std::move(spec_key)].push_back(index);
+    }
+
+    const std::vector<size_t>* StatusParagraphs::find_spec_indices(const std::string& name,
+                                                                   const Triplet& triplet) const
+    {
+        const auto it = spec_index.find(SpecKey{name, triplet});
+        return it == spec_index.end() ? nullptr : &it->second;
+    }
+
+    Optional<size_t> StatusParagraphs::find_index(const std::string& name,
+                                                  const Triplet& triplet,
+                                                  const std::string& feature) const
+    {
+        const auto it = feature_index.find(FeatureKey{SpecKey{name, triplet}, feature});
+        if (it == feature_index.end()) return nullopt;
+        return it->second;
+    }
 
     std::vector<std::unique_ptr<StatusParagraph>*> StatusParagraphs::find_all(const std::string& name,
                                                                               const Triplet& triplet)
     {
         std::vector<std::unique_ptr<StatusParagraph>*> spghs;
-        for (auto&& p : *this)
+        const auto indices = find_spec_indices(name, triplet);
+        if (!indices) return spghs;
+
+        for (auto it = indices->rbegin(); it != indices->rend(); ++it)
         {
-            if (p->package.spec.name() == name && p->package.spec.triplet() == triplet)
-            {
-                if (p->package.feature.empty())
-                    spghs.emplace(spghs.begin(), &p);
-                else
-                    spghs.emplace_back(&p);
-            }
+            auto& p = paragraphs[*it];
+            if (p->package.feature.empty())
+                spghs.emplace(spghs.begin(), &p);
+            else
+                spghs.emplace_back(&p);
         }
         return spghs;
     }
 
     Optional<InstalledPackageView> StatusParagraphs::find_all_installed(const PackageSpec& spec) const
     {
+        const auto indices = find_spec_indices(spec.name(), spec.triplet());
+        if (!indices) return nullopt;
+
         InstalledPackageView ipv;
-        for (auto&& p : *this)
+        for (auto it = indices->rbegin(); it != indices->rend(); ++it)
         {
-            if (p->package.spec.name() == spec.name() && p->package.spec.triplet() == spec.triplet() &&
-                p->is_installed())
+            auto& p = paragraphs[*it];
+            if (p->is_installed())
             {
                 if (p->package.feature.empty())
                 {
@@ -45,7 +91,7 @@ namespace vcpkg
             }
         }
         if (ipv.core != nullptr)
-            return std::move(ipv);
+            return ipv;
         else
             return nullopt;
     }
@@ -54,20 +100,18 @@ namespace vcpkg
                                                       const Triplet& triplet,
                                                       const std::string& feature)
     {
-        return std::find_if(begin(), end(), [&](const std::unique_ptr<StatusParagraph>& pgh) {
-            const PackageSpec& spec = pgh->package.spec;
-            return spec.name() == name && spec.triplet() == triplet && pgh->package.feature == feature;
-        });
+        const Optional<size_t> index = find_index(name, triplet, feature);
+        if (const auto i = index.get()) return make_iterator(*i);
+        return end();
     }
 
     StatusParagraphs::const_iterator StatusParagraphs::find(const std::string& name,
                                                             const Triplet& triplet,
                                                             const std::string& feature) const
     {
-        return std::find_if(begin(), end(), [&](const std::unique_ptr<StatusParagraph>& pgh) {
-            const PackageSpec& spec = pgh->package.spec;
-            return spec.name() == name && spec.triplet() == triplet && pgh->package.feature == feature;
-        });
+        const Optional<size_t> index = find_index(name, triplet, feature);
+        if (const auto i = index.get()) return make_iterator(*i);
+        return end();
     }
 
     StatusParagraphs::const_iterator StatusParagraphs::find_installed(const PackageSpec& spec) const
@@ -97,6 +141,7 @@ namespace vcpkg
         if (ptr == end())
         {
             paragraphs.push_back(std::move(pgh));
+            index_paragraph(paragraphs.size() - 1);
             return paragraphs.rbegin();
         }
 
@@ -124,6 +124,18 @@ namespace vcpkg
                     parse_switch(false, "printmetrics", args.printmetrics);
                     continue;
                 }
+                if (arg == "--x-max-cpus")
+                {
+                    ++arg_begin;
+                    parse_value(arg_begin, arg_end, "--x-max-cpus", args.max_cpus);
+                    continue;
+                }
+                if (arg == "--x-max-memory")
+                {
+                    ++arg_begin;
+                    parse_value(arg_begin, arg_end, "--x-max-memory", args.max_memory);
+                    continue;
+                }
                 if (arg == "--featurepackages")
                 {
                     GlobalState::feature_packages = true;
@@ -134,6 +146,16 @@ namespace vcpkg
                     GlobalState::feature_packages = false;
                     continue;
                 }
+                if (arg == "--binarycaching")
+                {
+                    GlobalState::binary_caching = true;
+                    continue;
+                }
+                if (arg == "--no-binarycaching")
+                {
+                    GlobalState::binary_caching = false;
+                    continue;
+                }
 
                 const auto eq_pos = arg.find('=');
                 if (eq_pos != std::string::npos)
@@ -282,5 +304,11 @@ namespace vcpkg
         System::println("    %-40s %s",
                         "--vcpkg-root <path>",
                         "Specify the vcpkg directory to use instead of current directory or tool directory");
+        System::println("    %-40s %s",
+                        "--x-max-cpus <n>",
+                        "Share n CPUs between all builds through a make jobserver (0 for all hardware threads)");
+        System::println("    %-40s %s",
+                        "--x-max-memory <size>",
+                        "Start concurrent builds only while their memory fits in size (in MB, or with a G suffix)");
     }
 }
@@ -24,28 +24,88 @@ namespace vcpkg
             fs.rename(vcpkg_dir_status_file_old, vcpkg_dir_status_file);
         }
 
-        auto pghs = Paragraphs::get_paragraphs(fs, vcpkg_dir_status_file).value_or_exit(VCPKG_LINE_INFO);
+        const auto pghs = Paragraphs::get_parsed_paragraphs(fs, vcpkg_dir_status_file).value_or_exit(VCPKG_LINE_INFO);
 
         std::vector<std::unique_ptr<StatusParagraph>> status_pghs;
-        for (auto&& p : pghs)
+        status_pghs.reserve(pghs.size());
+        for (size_t i = 0; i < pghs.size(); ++i)
         {
-            status_pghs.push_back(std::make_unique<StatusParagraph>(std::move(p)));
+            status_pghs.push_back(std::make_unique<StatusParagraph>(pghs[i]));
         }
 
         return StatusParagraphs(std::move(status_pghs));
     }
 
+    // Status updates are appended to the journal as records of the form
+    //     #vcpkg-status-update <payload size> <payload checksum>\n<payload>
+    // where the payload is one or more serialized status paragraphs.
+    static const std::string JOURNAL_RECORD_PREFIX = "#vcpkg-status-update ";
+
+    // The journal is folded into the status file once it grows past this size
+    static constexpr std::uintmax_t JOURNAL_COMPACTION_SIZE = 1024 * 1024;
+
+    // Guards the status file and the journal against concurrent plans in this process, such as the triplets of a
+    // ci run. Each has its own StatusParagraphs, but they all write to the same files.
+    static std::mutex s_status_files_mutex;
+
+    static std::uint64_t journal_checksum(const char* data, size_t size)
+    {
+        // 64-bit FNV-1a
+        std::uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /// <summary>
+    /// Applies the complete records of the journal to status_db. Returns false if the journal ends in a torn or
+    /// corrupt record, which is then ignored along with everything after it.
+    /// </summary>
+    static bool replay_journal(const std::string& journal, StatusParagraphs& status_db)
+    {
+        size_t pos = 0;
+        while (pos != journal.size())
+        {
+            if (journal.compare(pos, JOURNAL_RECORD_PREFIX.size(), JOURNAL_RECORD_PREFIX) != 0) return false;
+            const size_t header_end = journal.find('\n', pos);
+            if (header_end == std::string::npos) return false;
+
+            const char* const header = journal.c_str() + pos + JOURNAL_RECORD_PREFIX.size();
+            char* size_end;
+            const auto payload_size = std::strtoull(header, &size_end, 10);
+            char* checksum_end;
+            const auto checksum = std::strtoull(size_end, &checksum_end, 16);
+            if (size_end == header || checksum_end == size_end || checksum_end != journal.c_str() + header_end)
+                return false;
+
+            const size_t payload_begin = header_end + 1;
+            if (payload_size > journal.size() - payload_begin) return false;
+            const char* const payload = journal.c_str() + payload_begin;
+            if (journal_checksum(payload, payload_size) != checksum) return false;
+
+            const Paragraphs::ParsedParagraphs pghs(std::string(payload, payload_size));
+            for (size_t i = 0; i < pghs.size(); ++i)
+            {
+                status_db.insert(std::make_unique<StatusParagraph>(pghs[i]));
+            }
+
+            pos = payload_begin + payload_size;
+        }
+        return true;
+    }
+
     StatusParagraphs database_load_check(const VcpkgPaths& paths)
     {
         auto& fs = paths.get_filesystem();
-
-        const auto updates_dir = paths.vcpkg_dir_updates;
+        std::lock_guard<std::mutex> lock(s_status_files_mutex);
 
         std::error_code ec;
         fs.create_directory(paths.installed, ec);
         fs.create_directory(paths.vcpkg_dir, ec);
         fs.create_directory(paths.vcpkg_dir_info, ec);
-        fs.create_directory(updates_dir, ec);
 
         const fs::path& status_file = paths.vcpkg_dir_status_file;
         const fs::path status_file_old = status_file.parent_path() / "status-old";
@@ -53,28 +113,55 @@ namespace vcpkg
 
         StatusParagraphs current_status_db = load_current_database(fs, status_file, status_file_old);
 
-        auto update_files = fs.get_files_non_recursive(updates_dir);
-        if (update_files.empty())
+        bool needs_compaction = false;
+
+        const fs::path& journal_file = paths.vcpkg_dir_status_journal;
+        const bool has_journal = fs.exists(journal_file);
+        if (has_journal)
         {
-            // updates directory is empty, control file is up-to-date.
-            return current_status_db;
+            const std::string journal = fs.read_contents(journal_file).value_or_exit(VCPKG_LINE_INFO);
+            if (!replay_journal(journal, current_status_db))
+            {
+                // Most likely a crash while appending. Rewrite the status file so that later updates are not
+                // appended after the damaged record.
+                Debug::println("Ignoring incomplete record at the end of %s", journal_file.u8string());
+                needs_compaction = true;
+            }
+            if (journal.size() >= JOURNAL_COMPACTION_SIZE) needs_compaction = true;
+        }
+
+        // Update files written by previous versions of vcpkg
+        std::vector<fs::path> update_files;
+        if (fs.exists(paths.vcpkg_dir_updates))
+        {
+            update_files = fs.get_files_non_recursive(paths.vcpkg_dir_updates);
+            Util::sort(update_files);
         }
         for (auto&& file : update_files)
         {
             if (!fs.is_regular_file(file)) continue;
             if (file.filename() == "incomplete") continue;
 
-            auto pghs = Paragraphs::get_paragraphs(fs, file).value_or_exit(VCPKG_LINE_INFO);
-            for (auto&& p : pghs)
+            const auto pghs = Paragraphs::get_parsed_paragraphs(fs, file).value_or_exit(VCPKG_LINE_INFO);
+            for (size_t i = 0; i < pghs.size(); ++i)
             {
-                current_status_db.insert(std::make_unique<StatusParagraph>(std::move(p)));
+                current_status_db.insert(std::make_unique<StatusParagraph>(pghs[i]));
             }
+            needs_compaction = true;
+        }
+
+        if (!needs_compaction && update_files.empty())
+        {
+            return current_status_db;
         }
 
         fs.write_contents(status_file_new, Strings::serialize(current_status_db));
 
         fs.rename(status_file_new, status_file);
 
+        // Replaying the journal again after a crash at this point is harmless
+        if (has_journal) fs.remove(journal_file);
+
         for (auto&& file : update_files)
         {
             if (!fs.is_regular_file(file)) continue;
@@ -85,17 +172,30 @@ namespace vcpkg
         return current_status_db;
     }
 
-    void write_update(const VcpkgPaths& paths, const StatusParagraph& p)
+    void write_updates(const VcpkgPaths& paths, Span<const StatusParagraph> pghs)
     {
-        static int update_id = 0;
-        auto& fs = paths.get_filesystem();
+        std::string payload;
+        for (auto&& pgh : pghs)
+        {
+            serialize(pgh, payload);
+            payload.push_back('\n');
+        }
 
-        const auto my_update_id = update_id++;
-        const auto tmp_update_filename = paths.vcpkg_dir_updates / "incomplete";
-        const auto update_filename = paths.vcpkg_dir_updates / Strings::format("%010d", my_update_id);
+        const auto checksum = journal_checksum(payload.data(), payload.size());
+        std::string record = Strings::format("%s%llu %016llx\n",
+                                             JOURNAL_RECORD_PREFIX,
+                                             static_cast<unsigned long long>(payload.size()),
+                                             static_cast<unsigned long long>(checksum));
+        record.append(payload);
 
-        fs.write_contents(tmp_update_filename, Strings::serialize(p));
-        fs.rename(tmp_update_filename, update_filename);
+        std::error_code ec;
+        std::lock_guard<std::mutex> lock(s_status_files_mutex);
+        paths.get_filesystem().append_contents(paths.vcpkg_dir_status_journal, record, ec);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           !ec,
+                           "Error: Could not update %s: %s",
+                           paths.vcpkg_dir_status_journal.u8string(),
+                           ec.message());
     }
 
     static void upgrade_to_slash_terminated_sorted_format(Files::Filesystem& fs,
@@ -180,11 +280,26 @@ namespace vcpkg
         return installed_packages;
     }
 
-    std::vector<StatusParagraphAndAssociatedFiles> get_installed_files(const VcpkgPaths& paths,
-                                                                       const StatusParagraphs& status_db)
+    SortedVector<std::string> get_installed_files(const VcpkgPaths& paths, const BinaryParagraph& core_paragraph)
     {
         auto& fs = paths.get_filesystem();
 
+        const fs::path listfile_path = paths.listfile_path(core_paragraph);
+        std::vector<std::string> installed_files_of_current_pgh =
+            fs.read_lines(listfile_path).value_or_exit(VCPKG_LINE_INFO);
+        Strings::trim_all_and_remove_whitespace_strings(&installed_files_of_current_pgh);
+        upgrade_to_slash_terminated_sorted_format(fs, &installed_files_of_current_pgh, listfile_path);
+
+        // Remove the directories
+        Util::erase_remove_if(installed_files_of_current_pgh,
+                              [](const std::string& file) { return file.back() == '/'; });
+
+        return SortedVector<std::string>(std::move(installed_files_of_current_pgh));
+    }
+
+    std::vector<StatusParagraphAndAssociatedFiles> get_installed_files(const VcpkgPaths& paths,
+                                                                       const StatusParagraphs& status_db)
+    {
         std::vector<StatusParagraphAndAssociatedFiles> installed_files;
 
         for (const std::unique_ptr<StatusParagraph>& pgh : status_db)
@@ -194,18 +309,7 @@ namespace vcpkg
                 continue;
             }
 
-            const fs::path listfile_path = paths.listfile_path(pgh->package);
-            std::vector<std::string> installed_files_of_current_pgh =
-                fs.read_lines(listfile_path).value_or_exit(VCPKG_LINE_INFO);
-            Strings::trim_all_and_remove_whitespace_strings(&installed_files_of_current_pgh);
-            upgrade_to_slash_terminated_sorted_format(fs, &installed_files_of_current_pgh, listfile_path);
-
-            // Remove the directories
-            Util::erase_remove_if(installed_files_of_current_pgh,
-                                  [](const std::string& file) { return file.back() == '/'; });
-
-            StatusParagraphAndAssociatedFiles pgh_and_files = {
-                *pgh, SortedVector<std::string>(std::move(installed_files_of_current_pgh))};
+            StatusParagraphAndAssociatedFiles pgh_and_files = {*pgh, get_installed_files(paths, pgh->package)};
             installed_files.push_back(std::move(pgh_and_files));
         }
 
@@ -2,11 +2,13 @@
 
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/util.h>
 #include <vcpkg/build.h>
 #include <vcpkg/metrics.h>
 #include <vcpkg/packagespec.h>
+#include <vcpkg/paragraphs.h>
 #include <vcpkg/vcpkgpaths.h>
 
 namespace vcpkg
@@ -15,52 +17,194 @@ namespace vcpkg
     static constexpr CStringView V_140 = "v140";
     static constexpr CStringView V_141 = "v141";
 
-    static bool exists_and_has_equal_or_greater_version(const std::string& version_cmd,
-                                                        const std::array<int, 3>& expected_version)
+    struct ToolPath
+    {
+        fs::path path;
+        std::array<int, 3> version;
+    };
+
+    static Optional<std::array<int, 3>> parse_version(const std::string& text)
     {
         static const std::regex RE(R"###((\d+)\.(\d+)\.(\d+))###");
 
-        const auto rc = System::cmd_execute_and_capture_output(Strings::format(R"(%s)", version_cmd));
-        if (rc.exit_code != 0)
+        std::match_results<std::string::const_iterator> match;
+        const auto found = std::regex_search(text, match, RE);
+        if (!found)
         {
-            return false;
+            return nullopt;
         }
 
-        std::match_results<std::string::const_iterator> match;
-        const auto found = std::regex_search(rc.output, match, RE);
-        if (!found)
+        return std::array<int, 3>{
+            atoi(match[1].str().c_str()), atoi(match[2].str().c_str()), atoi(match[3].str().c_str())};
+    }
+
+    static bool is_equal_or_greater_version(const std::array<int, 3>& version,
+                                            const std::array<int, 3>& expected_version)
+    {
+        const int d1 = version[0];
+        const int d2 = version[1];
+        const int d3 = version[2];
+        return d1 > expected_version[0] || (d1 == expected_version[0] && d2 > expected_version[1]) ||
+               (d1 == expected_version[0] && d2 == expected_version[1] && d3 >= expected_version[2]);
+    }
+
+    static Optional<std::array<int, 3>> get_equal_or_greater_version(const std::string& version_cmd,
+                                                                     const std::array<int, 3>& expected_version)
+    {
+        const auto rc = System::cmd_execute_and_capture_output(Strings::format(R"(%s)", version_cmd));
+        if (rc.exit_code != 0)
         {
-            return false;
+            return nullopt;
         }
 
-        const int d1 = atoi(match[1].str().c_str());
-        const int d2 = atoi(match[2].str().c_str());
-        const int d3 = atoi(match[3].str().c_str());
-        if (d1 > expected_version[0] || (d1 == expected_version[0] && d2 > expected_version[1]) ||
-            (d1 == expected_version[0] && d2 == expected_version[1] && d3 >= expected_version[2]))
+        const Optional<std::array<int, 3>> version = parse_version(rc.output);
+        if (const auto v = version.get())
         {
             // satisfactory version found
-            return true;
+            if (is_equal_or_greater_version(*v, expected_version)) return *v;
         }
 
-        return false;
+        return nullopt;
     }
 
-    static Optional<fs::path> find_if_has_equal_or_greater_version(const std::vector<fs::path>& candidate_paths,
+    static Optional<ToolPath> find_if_has_equal_or_greater_version(const std::vector<fs::path>& candidate_paths,
                                                                    const std::string& version_check_arguments,
                                                                    const std::array<int, 3>& expected_version)
     {
-        auto it = Util::find_if(candidate_paths, [&](const fs::path& p) {
+        for (auto&& p : candidate_paths)
+        {
             const std::string cmd = Strings::format(R"("%s" %s)", p.u8string(), version_check_arguments);
-            return exists_and_has_equal_or_greater_version(cmd, expected_version);
+            const Optional<std::array<int, 3>> version = get_equal_or_greater_version(cmd, expected_version);
+            if (const auto v = version.get())
+            {
+                return ToolPath{p, *v};
+            }
+        }
+
+        return nullopt;
+    }
+
+    namespace ToolCacheFields
+    {
+        static const std::string TOOL = "Tool";
+        static const std::string PATH = "Path";
+        static const std::string VERSION = "Version";
+        static const std::string SIZE = "Size";
+        static const std::string LAST_WRITE_TIME = "Last-Write-Time";
+        static const std::string SEARCH_PATH = "Search-Path";
+    }
+
+    // Guards paths.tools_cache_file against concurrent updates from this process
+    static std::mutex s_tool_cache_mutex;
+
+    // The fields which must still match for a cached tool path to be trusted
+    static Optional<Paragraphs::RawParagraph> describe_tool_file(const Files::Filesystem& fs, const fs::path& tool_path)
+    {
+        std::error_code ec;
+        const auto size = fs.file_size(tool_path, ec);
+        if (ec) return nullopt;
+        const auto last_write_time = fs.last_write_time(tool_path, ec);
+        if (ec) return nullopt;
+
+        // Tools found through PATH may be shadowed by a different PATH
+        const std::string search_path = System::get_environment_variable("PATH").value_or("");
+
+        return Paragraphs::RawParagraph{
+            {ToolCacheFields::SIZE, std::to_string(size)},
+            {ToolCacheFields::LAST_WRITE_TIME, std::to_string(last_write_time.time_since_epoch().count())},
+            {ToolCacheFields::SEARCH_PATH, Hash::get_string_hash(search_path, Hash::Algorithm::SHA256)},
+        };
+    }
+
+    /// <summary>
+    /// Returns the path remembered for tool_name, without running it, if the executable is unchanged since then
+    /// </summary>
+    static Optional<fs::path> find_cached_tool(const VcpkgPaths& paths,
+                                               const std::string& tool_name,
+                                               const std::array<int, 3>& expected_version)
+    {
+        auto& fs = paths.get_filesystem();
+        std::unique_lock<std::mutex> lock(s_tool_cache_mutex);
+        auto maybe_paragraphs = Paragraphs::get_paragraphs(fs, paths.tools_cache_file);
+        lock.unlock();
+
+        const auto paragraphs = maybe_paragraphs.get();
+        if (!paragraphs) return nullopt;
+
+        const auto it = Util::find_if(*paragraphs, [&](const Paragraphs::RawParagraph& pgh) {
+            const auto tool = pgh.find(ToolCacheFields::TOOL);
+            return tool != pgh.end() && tool->second == tool_name;
         });
+        if (it == paragraphs->end()) return nullopt;
+
+        const auto field = [&](const std::string& name) -> std::string {
+            const auto f = it->find(name);
+            return f == it->end() ? "" : f->second;
+        };
+
+        const Optional<std::array<int, 3>> version = parse_version(field(ToolCacheFields::VERSION));
+        const auto v = version.get();
+        if (!v || !is_equal_or_greater_version(*v, expected_version)) return nullopt;
+
+        const fs::path tool_path = fs::u8path(field(ToolCacheFields::PATH));
+        const Optional<Paragraphs::RawParagraph> current = describe_tool_file(fs, tool_path);
+        const auto current_fields = current.get();
+        if (!current_fields) return nullopt;
+        for (auto&& current_field : *current_fields)
+        {
+            if (field(current_field.first) != current_field.second) return nullopt;
+        }
+
+        Debug::println("Using cached %s: %s", tool_name, tool_path.u8string());
+        return tool_path;
+    }
 
-        if (it != candidate_paths.cend())
+    static fs::path remember_tool(const VcpkgPaths& paths, const std::string& tool_name, ToolPath&& tool)
+    {
+        auto& fs = paths.get_filesystem();
+        Optional<Paragraphs::RawParagraph> maybe_entry = describe_tool_file(fs, tool.path);
+        if (const auto entry = maybe_entry.get())
         {
-            return std::move(*it);
+            entry->emplace(ToolCacheFields::TOOL, tool_name);
+            entry->emplace(ToolCacheFields::PATH, tool.path.u8string());
+            entry->emplace(ToolCacheFields::VERSION,
+                           Strings::format("%d.%d.%d", tool.version[0], tool.version[1], tool.version[2]));
+
+            std::lock_guard<std::mutex> lock(s_tool_cache_mutex);
+            auto maybe_paragraphs = Paragraphs::get_paragraphs(fs, paths.tools_cache_file);
+            std::vector<Paragraphs::RawParagraph> paragraphs;
+            if (const auto p = maybe_paragraphs.get()) paragraphs = std::move(*p);
+            Util::erase_remove_if(paragraphs, [&](const Paragraphs::RawParagraph& pgh) {
+                const auto it = pgh.find(ToolCacheFields::TOOL);
+                return it == pgh.end() || it->second == tool_name;
+            });
+            paragraphs.push_back(std::move(*entry));
+
+            static const std::string* const FIELD_ORDER[] = {
+                &ToolCacheFields::TOOL,
+                &ToolCacheFields::PATH,
+                &ToolCacheFields::VERSION,
+                &ToolCacheFields::SIZE,
+                &ToolCacheFields::LAST_WRITE_TIME,
+                &ToolCacheFields::SEARCH_PATH,
+            };
+            std::string contents;
+            for (auto&& pgh : paragraphs)
+            {
+                if (!contents.empty()) contents.push_back('\n');
+                for (const std::string* name : FIELD_ORDER)
+                {
+                    const auto it = pgh.find(*name);
+                    if (it != pgh.end()) contents.append(*name).append(": ").append(it->second).push_back('\n');
+                }
+            }
+
+            std::error_code ec;
+            Files::write_contents_atomically(fs, paths.tools_cache_file, contents, ec);
+            if (ec) Debug::println("Could not write %s: %s", paths.tools_cache_file.u8string(), ec.message());
         }
 
-        return nullopt;
+        return std::move(tool.path);
     }
 
     static std::vector<std::string> keep_data_lines(const std::string& data_blob)
@@ -80,7 +224,7 @@ namespace vcpkg
         return data_lines;
     }
 
-    static fs::path fetch_dependency(const fs::path& scripts_folder,
+    static ToolPath fetch_dependency(const fs::path& scripts_folder,
                                      const std::string& tool_name,
                                      const fs::path& expected_downloaded_path,
                                      const std::array<int, 3>& version)
@@ -109,10 +253,10 @@ namespace vcpkg
                            "Expected dependency downloaded path to be %s, but was %s",
                            expected_downloaded_path.u8string(),
                            actual_downloaded_path.u8string());
-        return actual_downloaded_path;
+        return ToolPath{actual_downloaded_path, version};
     }
 
-    static fs::path get_cmake_path(const fs::path& downloads_folder, const fs::path& scripts_folder)
+    static fs::path get_cmake_path(const VcpkgPaths& paths)
     {
 #if defined(_WIN32)
         static constexpr std::array<int, 3> EXPECTED_VERSION = {3, 10, 2};
@@ -121,10 +265,16 @@ namespace vcpkg
 #endif
         static const std::string VERSION_CHECK_ARGUMENTS = "--version";
 
+        const Optional<fs::path> cached = find_cached_tool(paths, "cmake", EXPECTED_VERSION);
+        if (const auto p = cached.get())
+        {
+            return *p;
+        }
+
         const std::vector<fs::path> from_path = Files::find_from_PATH("cmake");
 
         std::vector<fs::path> candidate_paths;
-        const fs::path downloaded_copy = downloads_folder / "cmake-3.10.2-win32-x86" / "bin" / "cmake.exe";
+        const fs::path downloaded_copy = paths.downloads / "cmake-3.10.2-win32-x86" / "bin" / "cmake.exe";
 #if defined(_WIN32)
         candidate_paths.push_back(downloaded_copy);
 #endif
@@ -134,37 +284,45 @@ namespace vcpkg
         candidate_paths.push_back(System::get_program_files_32_bit() / "CMake" / "bin");
 #endif
 
-        const Optional<fs::path> path =
+        Optional<ToolPath> tool =
             find_if_has_equal_or_greater_version(candidate_paths, VERSION_CHECK_ARGUMENTS, EXPECTED_VERSION);
-        if (const auto p = path.get())
+        if (const auto p = tool.get())
         {
-            return *p;
+            return remember_tool(paths, "cmake", std::move(*p));
         }
 
-        return fetch_dependency(scripts_folder, "cmake", downloaded_copy, EXPECTED_VERSION);
+        return remember_tool(
+            paths, "cmake", fetch_dependency(paths.scripts, "cmake", downloaded_copy, EXPECTED_VERSION));
     }
 
-    fs::path get_nuget_path(const fs::path& downloads_folder, const fs::path& scripts_folder)
+    fs::path get_nuget_path(const VcpkgPaths& paths)
     {
         static constexpr std::array<int, 3> EXPECTED_VERSION = {4, 4, 0};
 
-        const fs::path downloaded_copy = downloads_folder / "nuget-4.4.0" / "nuget.exe";
+        const Optional<fs::path> cached = find_cached_tool(paths, "nuget", EXPECTED_VERSION);
+        if (const auto p = cached.get())
+        {
+            return *p;
+        }
+
+        const fs::path downloaded_copy = paths.downloads / "nuget-4.4.0" / "nuget.exe";
         const std::vector<fs::path> from_path = Files::find_from_PATH("nuget");
 
         std::vector<fs::path> candidate_paths;
         candidate_paths.push_back(downloaded_copy);
         candidate_paths.insert(candidate_paths.end(), from_path.cbegin(), from_path.cend());
 
-        auto path = find_if_has_equal_or_greater_version(candidate_paths, "", EXPECTED_VERSION);
-        if (const auto p = path.get())
+        auto tool = find_if_has_equal_or_greater_version(candidate_paths, "", EXPECTED_VERSION);
+        if (const auto p = tool.get())
         {
-            return *p;
+            return remember_tool(paths, "nuget", std::move(*p));
         }
 
-        return fetch_dependency(scripts_folder, "nuget", downloaded_copy, EXPECTED_VERSION);
+        return remember_tool(
+            paths, "nuget", fetch_dependency(paths.scripts, "nuget", downloaded_copy, EXPECTED_VERSION));
     }
 
-    fs::path get_git_path(const fs::path& downloads_folder, const fs::path& scripts_folder)
+    fs::path get_git_path(const VcpkgPaths& paths)
     {
 #if defined(_WIN32)
         static constexpr std::array<int, 3> EXPECTED_VERSION = {2, 15, 0};
@@ -173,9 +331,15 @@ namespace vcpkg
 #endif
         static const std::string VERSION_CHECK_ARGUMENTS = "--version";
 
+        const Optional<fs::path> cached = find_cached_tool(paths, "git", EXPECTED_VERSION);
+        if (const auto p = cached.get())
+        {
+            return *p;
+        }
+
         const std::vector<fs::path> from_path = Files::find_from_PATH("git");
 
-        const fs::path downloaded_copy = downloads_folder / "MinGit-2.15.0-32-bit" / "cmd" / "git.exe";
+        const fs::path downloaded_copy = paths.downloads / "MinGit-2.15.0-32-bit" / "cmd" / "git.exe";
         std::vector<fs::path> candidate_paths;
 #if defined(_WIN32)
         candidate_paths.push_back(downloaded_copy);
@@ -186,23 +350,29 @@ namespace vcpkg
         candidate_paths.push_back(System::get_program_files_32_bit() / "git" / "cmd" / "git.exe");
 #endif
 
-        const Optional<fs::path> path =
+        Optional<ToolPath> tool =
             find_if_has_equal_or_greater_version(candidate_paths, VERSION_CHECK_ARGUMENTS, EXPECTED_VERSION);
-        if (const auto p = path.get())
+        if (const auto p = tool.get())
         {
-            return *p;
+            return remember_tool(paths, "git", std::move(*p));
         }
 
-        return fetch_dependency(scripts_folder, "git", downloaded_copy, EXPECTED_VERSION);
+        return remember_tool(paths, "git", fetch_dependency(paths.scripts, "git", downloaded_copy, EXPECTED_VERSION));
     }
 
-    static fs::path get_ifw_installerbase_path(const fs::path& downloads_folder, const fs::path& scripts_folder)
+    static fs::path get_ifw_installerbase_path(const VcpkgPaths& paths)
     {
         static constexpr std::array<int, 3> EXPECTED_VERSION = {3, 1, 81};
         static const std::string VERSION_CHECK_ARGUMENTS = "--framework-version";
 
+        const Optional<fs::path> cached = find_cached_tool(paths, "installerbase", EXPECTED_VERSION);
+        if (const auto p = cached.get())
+        {
+            return *p;
+        }
+
         const fs::path downloaded_copy =
-            downloads_folder / "QtInstallerFramework-win-x86" / "bin" / "installerbase.exe";
+            paths.downloads / "QtInstallerFramework-win-x86" / "bin" / "installerbase.exe";
 
         std::vector<fs::path> candidate_paths;
         candidate_paths.push_back(downloaded_copy);
@@ -214,14 +384,16 @@ namespace vcpkg
         // candidate_paths.push_back(fs::path(System::get_environment_variable("HOMEDRIVE").value_or("C:")) / "Qt" /
         // "QtIFW-3.1.0" / "bin" / "installerbase.exe");
 
-        const Optional<fs::path> path =
+        Optional<ToolPath> tool =
             find_if_has_equal_or_greater_version(candidate_paths, VERSION_CHECK_ARGUMENTS, EXPECTED_VERSION);
-        if (const auto p = path.get())
+        if (const auto p = tool.get())
         {
-            return *p;
+            return remember_tool(paths, "installerbase", std::move(*p));
         }
 
-        return fetch_dependency(scripts_folder, "installerbase", downloaded_copy, EXPECTED_VERSION);
+        return remember_tool(paths,
+                             "installerbase",
+                             fetch_dependency(paths.scripts, "installerbase", downloaded_copy, EXPECTED_VERSION));
     }
 
     Expected<VcpkgPaths> VcpkgPaths::create(const fs::path& vcpkg_root_dir)
@@ -245,6 +417,7 @@ namespace vcpkg
         paths.packages = paths.root / "packages";
         paths.buildtrees = paths.root / "buildtrees";
         paths.downloads = paths.root / "downloads";
+        paths.archives = paths.root / "archives";
         paths.ports = paths.root / "ports";
         paths.installed = paths.root / "installed";
         paths.triplets = paths.root / "triplets";
@@ -256,9 +429,14 @@ namespace vcpkg
         paths.vcpkg_dir = paths.installed / "vcpkg";
         paths.vcpkg_dir_status_file = paths.vcpkg_dir / "status";
         paths.vcpkg_dir_info = paths.vcpkg_dir / "info";
+        paths.vcpkg_dir_status_journal = paths.vcpkg_dir / "status-journal";
         paths.vcpkg_dir_updates = paths.vcpkg_dir / "updates";
+        paths.vcpkg_dir_owns_index = paths.vcpkg_dir / "owns.index";
 
         paths.ports_cmake = paths.scripts / "ports.cmake";
+        paths.ports_index_file = paths.buildtrees / "ports.index";
+        paths.tools_cache_file = paths.downloads / "tools.cache";
+        paths.build_history_file = paths.downloads / "build.history";
 
         return paths;
     }
@@ -278,6 +456,11 @@ namespace vcpkg
         return this->vcpkg_dir_info / (pgh.fullstem() + ".list");
     }
 
+    fs::path VcpkgPaths::archive_path(const std::string& abi_tag) const
+    {
+        return this->archives / abi_tag.substr(0, 2) / (abi_tag + ".zip");
+    }
+
     const std::vector<std::string>& VcpkgPaths::get_available_triplets() const
     {
         return this->available_triplets.get_lazy([this]() -> std::vector<std::string> {
@@ -300,23 +483,22 @@ namespace vcpkg
 
     const fs::path& VcpkgPaths::get_cmake_exe() const
     {
-        return this->cmake_exe.get_lazy([this]() { return get_cmake_path(this->downloads, this->scripts); });
+        return this->cmake_exe.get_lazy([this]() { return get_cmake_path(*this); });
     }
 
     const fs::path& VcpkgPaths::get_git_exe() const
     {
-        return this->git_exe.get_lazy([this]() { return get_git_path(this->downloads, this->scripts); });
+        return this->git_exe.get_lazy([this]() { return get_git_path(*this); });
     }
 
     const fs::path& VcpkgPaths::get_nuget_exe() const
     {
-        return this->nuget_exe.get_lazy([this]() { return get_nuget_path(this->downloads, this->scripts); });
+        return this->nuget_exe.get_lazy([this]() { return get_nuget_path(*this); });
     }
 
     const fs::path& VcpkgPaths::get_ifw_installerbase_exe() const
     {
-        return this->ifw_installerbase_exe.get_lazy(
-            [this]() { return get_ifw_installerbase_path(this->downloads, this->scripts); });
+        return this->ifw_installerbase_exe.get_lazy([this]() { return get_ifw_installerbase_path(*this); });
     }
 
     const fs::path& VcpkgPaths::get_ifw_binarycreator_exe() const